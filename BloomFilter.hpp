@@ -0,0 +1,246 @@
+/* Blocked Bloom filter - by W Denny
+    - approximate set membership: mayContain is false only for keys that were never added, and true for a small fraction of the others
+    - cache-line blocked: the filter is an array of 64-byte blocks and every key lives in one block, so add/mayContain touch a single cache line
+    - a block is 8 64-bit words and a key sets one bit in each word (8 bits per key); the bit of word i is taken from the hash times a per-word odd salt
+    - the 8 words are handled by the same branchless steps, so the loops vectorize (one lane per word) and lookups have no data-dependent branches
+    - sized from the expected number of keys and a configurable number of bits per key; about 1% false positives at 10 bits per key, under 0.1% at 16
+    - keys cannot be removed - reset clears the filter and resizes it for a new number of keys
+    - the Hash policy is a full hash policy (see hashIsAvalanching in HashFunctions.hpp)
+    - doubles as the front filter policy of HashTable_OpenAddressing and HashTable_SeperateChaining (see NullFilter in HashTable.hpp)
+*/
+#pragma once
+
+#include "HashFunctions.hpp"
+#include <assert.h>
+#include <cstdint>
+#include <cstring>
+
+namespace datastructlib
+{
+
+namespace detail
+{
+
+const unsigned int bloomBlockWords = 8; // 8 x 64 bits = one 64-byte cache line
+const unsigned int bloomBlockBits = bloomBlockWords * 64;
+
+/* one multiplier per word of a block - odd, so every word gets a different, evenly spread bit from the same hash */
+constexpr uint32_t bloomSalts[bloomBlockWords] = { 0x47B6137Bu, 0x44974D91u, 0x8824AD5Bu, 0xA2B7289Du, 0x705495C7u, 0x2DF1424Bu, 0x9EFC4947u, 0x5C6BFB31u };
+
+/* block of the filter - aligned so that it is exactly one cache line */
+struct alignas(64) BloomBlock
+{
+    uint64_t m_words[bloomBlockWords];
+};
+
+/* sets masks[i] to the bit of word i for hash */
+inline void bloomMasks(const uint32_t& hash, uint64_t* masks)
+{
+    for (unsigned int i = 0; i < bloomBlockWords; ++i)
+    {
+        masks[i] = 1ull << ((hash * bloomSalts[i]) >> 26);
+    }
+}
+
+} // namespace detail
+
+template <class T, class Hash = Hasher<T>>
+class BlockedBloomFilter
+{
+private:
+    detail::BloomBlock* m_blocks;
+    unsigned int m_numBlocks;
+    unsigned int m_bitsPerKey;
+    unsigned int m_capacity; // keys that fit before the false positive rate rises above the one for m_bitsPerKey
+    unsigned int m_numKeys; // keys added since the last reset, repeats included
+    Hash m_hash;
+
+public:
+    static constexpr bool enabled = true; // as a front filter policy, tables consult it before probing
+
+    BlockedBloomFilter(const unsigned int& expectedKeys = 0, const unsigned int& bitsPerKey = 10, const Hash& hash = Hash());
+    BlockedBloomFilter(const BlockedBloomFilter& other);
+    BlockedBloomFilter& operator=(const BlockedBloomFilter& other);
+    ~BlockedBloomFilter();
+    void add(const T& key);
+    template <class K>
+    bool mayContain(const K& key) const; // false means key was never added - K is T, or any type a transparent Hash also takes (e.g. std::string_view)
+    void reset(const unsigned int& expectedKeys); // clears the filter and sizes it for expectedKeys at the same bits per key
+    void clear(); // clears the filter, keeping its size
+    bool full() const; // true once more keys were added than it was sized for
+    unsigned int size() const;
+    unsigned int capacity() const;
+    unsigned int bitsPerKey() const;
+    unsigned long long memoryBytes() const;
+
+private:
+    template <class K>
+    size_t hashKey(const K& key) const;
+    unsigned int blockIndex(const size_t& hash) const;
+};
+
+/* ctor - bitsPerKey of at least 1, expectedKeys of 0 gives a single block */
+template <class T, class Hash>
+BlockedBloomFilter<T, Hash>::BlockedBloomFilter(const unsigned int& expectedKeys, const unsigned int& bitsPerKey, const Hash& hash)
+    : m_hash(hash)
+{
+    assert(bitsPerKey > 0);
+    this->m_blocks = nullptr;
+    this->m_numBlocks = 0;
+    this->m_bitsPerKey = bitsPerKey;
+    this->reset(expectedKeys);
+}
+
+/* copy ctor */
+template <class T, class Hash>
+BlockedBloomFilter<T, Hash>::BlockedBloomFilter(const BlockedBloomFilter& other)
+    : m_hash(other.m_hash)
+{
+    this->m_numBlocks = other.m_numBlocks;
+    this->m_bitsPerKey = other.m_bitsPerKey;
+    this->m_capacity = other.m_capacity;
+    this->m_numKeys = other.m_numKeys;
+    this->m_blocks = new detail::BloomBlock[this->m_numBlocks];
+    std::memcpy(this->m_blocks, other.m_blocks, sizeof(detail::BloomBlock) * this->m_numBlocks);
+}
+
+/* copy assignment */
+template <class T, class Hash>
+BlockedBloomFilter<T, Hash>& BlockedBloomFilter<T, Hash>::operator=(const BlockedBloomFilter& other)
+{
+    if (this != &other)
+    {
+        if (this->m_numBlocks != other.m_numBlocks)
+        {
+            delete[] this->m_blocks;
+            this->m_blocks = new detail::BloomBlock[other.m_numBlocks];
+            this->m_numBlocks = other.m_numBlocks;
+        }
+        std::memcpy(this->m_blocks, other.m_blocks, sizeof(detail::BloomBlock) * this->m_numBlocks);
+        this->m_bitsPerKey = other.m_bitsPerKey;
+        this->m_capacity = other.m_capacity;
+        this->m_numKeys = other.m_numKeys;
+        this->m_hash = other.m_hash;
+    }
+    return *this;
+}
+
+/* dtor */
+template <class T, class Hash>
+BlockedBloomFilter<T, Hash>::~BlockedBloomFilter()
+{
+    delete[] this->m_blocks;
+}
+
+/* sets the key's bit in every word of its block */
+template <class T, class Hash>
+void BlockedBloomFilter<T, Hash>::add(const T& key)
+{
+    size_t hash = this->hashKey(key);
+    uint64_t masks[detail::bloomBlockWords];
+    detail::bloomMasks(static_cast<uint32_t>(hash), masks);
+    detail::BloomBlock& block = this->m_blocks[this->blockIndex(hash)];
+    for (unsigned int i = 0; i < detail::bloomBlockWords; ++i)
+    {
+        block.m_words[i] |= masks[i];
+    }
+    this->m_numKeys++;
+}
+
+/* checks the key's bit in every word of its block - any missing bit proves the key was never added */
+template <class T, class Hash>
+template <class K>
+bool BlockedBloomFilter<T, Hash>::mayContain(const K& key) const
+{
+    size_t hash = this->hashKey(key);
+    uint64_t masks[detail::bloomBlockWords];
+    detail::bloomMasks(static_cast<uint32_t>(hash), masks);
+    const detail::BloomBlock& block = this->m_blocks[this->blockIndex(hash)];
+    uint64_t missing = 0;
+    for (unsigned int i = 0; i < detail::bloomBlockWords; ++i)
+    {
+        missing |= masks[i] & ~block.m_words[i];
+    }
+    return missing == 0;
+}
+
+/* clears the filter and sizes it for expectedKeys - the block array is only reallocated if its length changes */
+template <class T, class Hash>
+void BlockedBloomFilter<T, Hash>::reset(const unsigned int& expectedKeys)
+{
+    unsigned long long numBits = (unsigned long long) expectedKeys * this->m_bitsPerKey;
+    unsigned int numBlocks = static_cast<unsigned int>((numBits + detail::bloomBlockBits - 1) / detail::bloomBlockBits);
+    numBlocks = (numBlocks == 0) ? 1 : numBlocks;
+    if (numBlocks != this->m_numBlocks)
+    {
+        delete[] this->m_blocks;
+        this->m_blocks = new detail::BloomBlock[numBlocks];
+        this->m_numBlocks = numBlocks;
+    }
+    this->m_capacity = static_cast<unsigned int>((unsigned long long) numBlocks * detail::bloomBlockBits / this->m_bitsPerKey);
+    this->clear();
+}
+
+/* clears the filter, keeping its size */
+template <class T, class Hash>
+void BlockedBloomFilter<T, Hash>::clear()
+{
+    std::memset(this->m_blocks, 0, sizeof(detail::BloomBlock) * this->m_numBlocks);
+    this->m_numKeys = 0;
+}
+
+/* returns true once more keys were added than the filter was sized for */
+template <class T, class Hash>
+bool BlockedBloomFilter<T, Hash>::full() const
+{
+    return this->m_numKeys > this->m_capacity;
+}
+
+/* returns number of keys added since the last reset, repeats included */
+template <class T, class Hash>
+unsigned int BlockedBloomFilter<T, Hash>::size() const
+{
+    return this->m_numKeys;
+}
+
+/* returns number of keys the filter was sized for */
+template <class T, class Hash>
+unsigned int BlockedBloomFilter<T, Hash>::capacity() const
+{
+    return this->m_capacity;
+}
+
+/* returns bits per key the filter is sized with */
+template <class T, class Hash>
+unsigned int BlockedBloomFilter<T, Hash>::bitsPerKey() const
+{
+    return this->m_bitsPerKey;
+}
+
+/* returns bytes held by the block array */
+template <class T, class Hash>
+unsigned long long BlockedBloomFilter<T, Hash>::memoryBytes() const
+{
+    return (unsigned long long) this->m_numBlocks * sizeof(detail::BloomBlock);
+}
+
+/* hashes key - mixed first if the policy doesn't avalanche */
+template <class T, class Hash>
+template <class K>
+size_t BlockedBloomFilter<T, Hash>::hashKey(const K& key) const
+{
+    size_t hash = this->m_hash(key);
+    if constexpr (!hashIsAvalanching<Hash>)
+        hash = static_cast<size_t>(hashInteger(hash));
+    return hash;
+}
+
+/* returns the block index of a hash - the high 32 bits are mapped onto [0, m_numBlocks) by multiply and shift, the low 32 bits pick the bits */
+template <class T, class Hash>
+unsigned int BlockedBloomFilter<T, Hash>::blockIndex(const size_t& hash) const
+{
+    uint64_t high = static_cast<uint64_t>(hash) >> 32;
+    return static_cast<unsigned int>((high * this->m_numBlocks) >> 32);
+}
+
+}; // namespace datastructlib
@@ -0,0 +1,403 @@
+/* Concurrent hash table - by W Denny
+    - thread-safe separate-chaining hash table for read-heavy workloads: find takes no lock, insert/remove lock one stripe
+    - writers lock one of numStripes mutexes picked by the key's hash; the low hash bits pick the stripe, so a key keeps its stripe at every table size
+    - nodes are immutable once published: updating a value swaps in a new node, so a reader never sees a half-written pair
+    - unlinked nodes and replaced tables are retired, then freed once every reader that could still reach them has finished (epoch-based reclamation)
+    - readers announce the epoch they start in by claiming one of maxReaders slots, so at most maxReaders finds run at once - the rest spin until a slot frees up
+    - resize locks every stripe (pausing writers only), copies the chains into a new table and publishes it with one atomic store; readers keep using
+      whichever table they loaded
+    - find copies the value out, since a ptr into the table could be freed as soon as the read ends
+*/
+#pragma once
+
+#include "HashTable.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace datastructlib
+{
+
+template <class T, class U, class Hash = Hasher<T>, class KeyEqual = std::equal_to<T>>
+class HashTable_Concurrent
+{
+public:
+    static constexpr unsigned int numStripes = 64;
+    static constexpr unsigned int maxReaders = 128;
+
+private:
+    /* chain node - only m_next changes after the node is published */
+    struct Node
+    {
+        KeyValPair<T, U> m_kvp;
+        size_t m_hash;
+        std::atomic<Node*> m_next;
+
+        Node(const T& key, const U& val, const size_t& hash, Node* next) : m_kvp(key, val), m_hash(hash), m_next(next) {}
+    };
+
+    /* bucket array - replaced as a whole on resize */
+    struct Table
+    {
+        unsigned int m_arrLength; // power of two
+        std::atomic<Node*>* m_buckets;
+    };
+
+    /* an object waiting for every reader that might hold it to finish */
+    struct Retired
+    {
+        void* m_ptr;
+        void (*m_free)(void*);
+        uint64_t m_epoch; // global epoch when it was unlinked
+    };
+
+    struct alignas(64) Stripe
+    {
+        std::mutex m_lock;
+    };
+
+    struct alignas(64) ReaderSlot
+    {
+        std::atomic<uint64_t> m_epoch; // 0 when free, otherwise epoch the reader started in
+    };
+
+    std::atomic<Table*> m_table;
+    std::atomic<unsigned int> m_numEntries;
+    std::atomic<uint64_t> m_epoch;
+    double m_maxLoadFactor;
+    Hash m_hash;
+    KeyEqual m_keyEqual;
+    Stripe m_stripes[numStripes];
+    mutable ReaderSlot m_readers[maxReaders];
+    std::mutex m_retireLock;
+    std::vector<Retired> m_retired;
+    unsigned int m_reclaimThreshold = 256; // retired objects gathered before trying to free them
+
+public:
+    HashTable_Concurrent(const unsigned int& length = numStripes, const double& maxLoadFactor = 1.0, const Hash& hash = Hash(), const KeyEqual& keyEqual = KeyEqual());
+    HashTable_Concurrent(const HashTable_Concurrent&) = delete;
+    HashTable_Concurrent& operator=(const HashTable_Concurrent&) = delete;
+    ~HashTable_Concurrent(); // must not run concurrently with any other call
+
+    bool find(const T& key, U& val) const; // copies the value into val if key is present
+    bool contains(const T& key) const;
+    void insert(const T& key, const U& val); // overwrites the value if key is already present
+    bool remove(const T& key);
+    void resizeArray(const unsigned int& newLength); // rounded up to a power of two - may shrink the table
+    unsigned int size() const;
+    unsigned int length() const; // current number of buckets
+    double loadFactor() const;
+
+private:
+    size_t hashKey(const T& key) const;
+    void rebuild(const unsigned int& newLength, const bool& growOnly); // copies the chains into a table of newLength buckets
+    unsigned int enterRead() const; // claims a reader slot, returns its index
+    void exitRead(const unsigned int& slot) const;
+    void retire(void* ptr, void (*freeFn)(void*));
+    void reclaim(); // frees retired objects no reader can reach - caller holds m_retireLock
+    static Table* allocateTable(const unsigned int& length);
+    static void freeNode(void* ptr);
+    static void freeTableAndNodes(void* ptr);
+    static unsigned int roundLength(const unsigned int& length);
+};
+
+/* ctor */
+template <class T, class U, class Hash, class KeyEqual>
+HashTable_Concurrent<T, U, Hash, KeyEqual>::HashTable_Concurrent(const unsigned int& length, const double& maxLoadFactor, const Hash& hash, const KeyEqual& keyEqual)
+    : m_hash(hash), m_keyEqual(keyEqual)
+{
+    assert(maxLoadFactor > 0);
+    this->m_maxLoadFactor = maxLoadFactor;
+    this->m_table.store(allocateTable(roundLength(length)), std::memory_order_relaxed);
+    this->m_numEntries.store(0, std::memory_order_relaxed);
+    this->m_epoch.store(1, std::memory_order_relaxed);
+    for (unsigned int i = 0; i < maxReaders; ++i)
+    {
+        this->m_readers[i].m_epoch.store(0, std::memory_order_relaxed);
+    }
+}
+
+/* dtor - frees the live table and everything still waiting to be reclaimed */
+template <class T, class U, class Hash, class KeyEqual>
+HashTable_Concurrent<T, U, Hash, KeyEqual>::~HashTable_Concurrent()
+{
+    for (unsigned int i = 0; i < this->m_retired.size(); ++i)
+    {
+        this->m_retired[i].m_free(this->m_retired[i].m_ptr);
+    }
+    freeTableAndNodes(this->m_table.load(std::memory_order_acquire));
+}
+
+/* lock-free lookup - walks the chain of whichever table is current when the read starts */
+template <class T, class U, class Hash, class KeyEqual>
+bool HashTable_Concurrent<T, U, Hash, KeyEqual>::find(const T& key, U& val) const
+{
+    size_t hash = this->hashKey(key);
+    unsigned int slot = this->enterRead();
+    const Table* table = this->m_table.load(std::memory_order_acquire);
+    const Node* node = table->m_buckets[hash & (table->m_arrLength - 1)].load(std::memory_order_acquire);
+    bool found = false;
+    while (node != nullptr)
+    {
+        if ((node->m_hash == hash) && this->m_keyEqual(node->m_kvp.m_key, key))
+        {
+            val = node->m_kvp.m_val;
+            found = true;
+            break;
+        }
+        node = node->m_next.load(std::memory_order_acquire);
+    }
+    this->exitRead(slot);
+    return found;
+}
+
+/* returns true if key is present */
+template <class T, class U, class Hash, class KeyEqual>
+bool HashTable_Concurrent<T, U, Hash, KeyEqual>::contains(const T& key) const
+{
+    U val;
+    return this->find(key, val);
+}
+
+/* inserts new entry at the head of its chain, or replaces the node holding key with one carrying the new value */
+template <class T, class U, class Hash, class KeyEqual>
+void HashTable_Concurrent<T, U, Hash, KeyEqual>::insert(const T& key, const U& val)
+{
+    size_t hash = this->hashKey(key);
+    unsigned int numEntries;
+    {
+        std::lock_guard<std::mutex> guard(this->m_stripes[hash & (numStripes - 1)].m_lock);
+        Table* table = this->m_table.load(std::memory_order_acquire); // stable while any stripe is held - resize needs every stripe
+        std::atomic<Node*>* bucket = &table->m_buckets[hash & (table->m_arrLength - 1)];
+        for (std::atomic<Node*>* link = bucket; link->load(std::memory_order_relaxed) != nullptr; link = &link->load(std::memory_order_relaxed)->m_next)
+        {
+            Node* node = link->load(std::memory_order_relaxed);
+            if ((node->m_hash == hash) && this->m_keyEqual(node->m_kvp.m_key, key))
+            {
+                link->store(new Node(key, val, hash, node->m_next.load(std::memory_order_relaxed)), std::memory_order_release);
+                this->retire(node, freeNode);
+                return;
+            }
+        }
+        bucket->store(new Node(key, val, hash, bucket->load(std::memory_order_relaxed)), std::memory_order_release);
+        numEntries = this->m_numEntries.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+    unsigned int arrLength = this->length();
+    if (numEntries > this->m_maxLoadFactor * arrLength)
+        this->rebuild(arrLength * 2, true); // arrLength may be stale by now, so this only ever grows the table
+}
+
+/* unlinks the node holding key - readers already on it can still follow its next ptr until it is reclaimed */
+template <class T, class U, class Hash, class KeyEqual>
+bool HashTable_Concurrent<T, U, Hash, KeyEqual>::remove(const T& key)
+{
+    size_t hash = this->hashKey(key);
+    std::lock_guard<std::mutex> guard(this->m_stripes[hash & (numStripes - 1)].m_lock);
+    Table* table = this->m_table.load(std::memory_order_acquire);
+    for (std::atomic<Node*>* link = &table->m_buckets[hash & (table->m_arrLength - 1)]; link->load(std::memory_order_relaxed) != nullptr; link = &link->load(std::memory_order_relaxed)->m_next)
+    {
+        Node* node = link->load(std::memory_order_relaxed);
+        if ((node->m_hash == hash) && this->m_keyEqual(node->m_kvp.m_key, key))
+        {
+            link->store(node->m_next.load(std::memory_order_relaxed), std::memory_order_release);
+            this->m_numEntries.fetch_sub(1, std::memory_order_relaxed);
+            this->retire(node, freeNode);
+            return true;
+        }
+    }
+    return false;
+}
+
+/* rebuilds the table with newLength buckets, growing or shrinking it */
+template <class T, class U, class Hash, class KeyEqual>
+void HashTable_Concurrent<T, U, Hash, KeyEqual>::resizeArray(const unsigned int& newLength)
+{
+    this->rebuild(newLength, false);
+}
+
+/* rebuilds the table with newLength buckets
+    - holds every stripe, so no writer runs; readers carry on through the old table, which is retired rather than freed
+    - nodes are copied rather than relinked, as readers may still be walking the old chains
+    - with growOnly the table is left alone unless it is still shorter than newLength - growth from insert reads the length before taking
+      the stripes, and other threads may have grown the table past it since
+*/
+template <class T, class U, class Hash, class KeyEqual>
+void HashTable_Concurrent<T, U, Hash, KeyEqual>::rebuild(const unsigned int& newLength, const bool& growOnly)
+{
+    unsigned int length = roundLength(newLength);
+    for (unsigned int s = 0; s < numStripes; ++s)
+    {
+        this->m_stripes[s].m_lock.lock();
+    }
+    Table* oldTable = this->m_table.load(std::memory_order_acquire);
+    if (growOnly ? (length > oldTable->m_arrLength) : (length != oldTable->m_arrLength))
+    {
+        Table* newTable = allocateTable(length);
+        for (unsigned int b = 0; b < oldTable->m_arrLength; ++b)
+        {
+            for (Node* node = oldTable->m_buckets[b].load(std::memory_order_relaxed); node != nullptr; node = node->m_next.load(std::memory_order_relaxed))
+            {
+                std::atomic<Node*>& bucket = newTable->m_buckets[node->m_hash & (length - 1)];
+                bucket.store(new Node(node->m_kvp.m_key, node->m_kvp.m_val, node->m_hash, bucket.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+            }
+        }
+        this->m_table.store(newTable, std::memory_order_release); // publishes the new table and every node in it
+        this->retire(oldTable, freeTableAndNodes);
+    }
+    for (unsigned int s = numStripes; s > 0; --s)
+    {
+        this->m_stripes[s - 1].m_lock.unlock();
+    }
+}
+
+/* returns number of entries */
+template <class T, class U, class Hash, class KeyEqual>
+unsigned int HashTable_Concurrent<T, U, Hash, KeyEqual>::size() const
+{
+    return this->m_numEntries.load(std::memory_order_relaxed);
+}
+
+/* returns current number of buckets */
+template <class T, class U, class Hash, class KeyEqual>
+unsigned int HashTable_Concurrent<T, U, Hash, KeyEqual>::length() const
+{
+    unsigned int slot = this->enterRead();
+    unsigned int arrLength = this->m_table.load(std::memory_order_acquire)->m_arrLength;
+    this->exitRead(slot);
+    return arrLength;
+}
+
+/* returns number of entries divided by number of buckets */
+template <class T, class U, class Hash, class KeyEqual>
+double HashTable_Concurrent<T, U, Hash, KeyEqual>::loadFactor() const
+{
+    return ((double) this->size()) / ((double) this->length());
+}
+
+/* hashes key, mixing the bits unless the policy already does (std::hash is the identity for integers, and the bucket comes from the low bits) */
+template <class T, class U, class Hash, class KeyEqual>
+size_t HashTable_Concurrent<T, U, Hash, KeyEqual>::hashKey(const T& key) const
+{
+    if constexpr (hashIsAvalanching<Hash>)
+        return this->m_hash(key);
+    else
+        return static_cast<size_t>(hashInteger(static_cast<uint64_t>(this->m_hash(key))));
+}
+
+/* claims a free reader slot and announces the current epoch in it
+    - the search starts at a slot picked by thread id, so threads rarely contend for the same slot
+    - the announcement is sequentially consistent: a reclaim that misses it ran before it, so cannot free anything the read will reach
+*/
+template <class T, class U, class Hash, class KeyEqual>
+unsigned int HashTable_Concurrent<T, U, Hash, KeyEqual>::enterRead() const
+{
+    static thread_local unsigned int firstSlot = static_cast<unsigned int>(std::hash<std::thread::id>()(std::this_thread::get_id()) % maxReaders);
+    for (unsigned int slot = firstSlot;; slot = (slot + 1 == maxReaders) ? 0 : slot + 1)
+    {
+        uint64_t idle = 0;
+        if ((this->m_readers[slot].m_epoch.load(std::memory_order_relaxed) == 0)
+            && this->m_readers[slot].m_epoch.compare_exchange_strong(idle, this->m_epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst))
+            return slot;
+    }
+}
+
+/* releases reader slot */
+template <class T, class U, class Hash, class KeyEqual>
+void HashTable_Concurrent<T, U, Hash, KeyEqual>::exitRead(const unsigned int& slot) const
+{
+    this->m_readers[slot].m_epoch.store(0, std::memory_order_release);
+}
+
+/* queues an unlinked object, tagged with the epoch it was unlinked in */
+template <class T, class U, class Hash, class KeyEqual>
+void HashTable_Concurrent<T, U, Hash, KeyEqual>::retire(void* ptr, void (*freeFn)(void*))
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst); // the unlink must be visible before the epoch is read, or a reader could start after the tag yet still reach ptr
+    std::lock_guard<std::mutex> guard(this->m_retireLock);
+    this->m_retired.push_back(Retired{ptr, freeFn, this->m_epoch.load(std::memory_order_seq_cst)});
+    if (this->m_retired.size() >= this->m_reclaimThreshold)
+        this->reclaim();
+}
+
+/* advances the epoch, then frees every retired object unlinked before the oldest active reader started
+    - a reader that announced epoch e may hold anything unlinked in epoch e or later, so only objects tagged below e are freed
+*/
+template <class T, class U, class Hash, class KeyEqual>
+void HashTable_Concurrent<T, U, Hash, KeyEqual>::reclaim()
+{
+    uint64_t oldestActive = this->m_epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+    for (unsigned int i = 0; i < maxReaders; ++i)
+    {
+        uint64_t epoch = this->m_readers[i].m_epoch.load(std::memory_order_seq_cst);
+        if ((epoch != 0) && (epoch < oldestActive))
+            oldestActive = epoch;
+    }
+    unsigned int kept = 0;
+    for (unsigned int i = 0; i < this->m_retired.size(); ++i)
+    {
+        if (this->m_retired[i].m_epoch < oldestActive)
+            this->m_retired[i].m_free(this->m_retired[i].m_ptr);
+        else
+            this->m_retired[kept++] = this->m_retired[i];
+    }
+    this->m_retired.resize(kept);
+    // if readers keep objects alive, wait for more to gather rather than rescanning on every retire
+    this->m_reclaimThreshold = (2 * kept > 256) ? 2 * kept : 256;
+}
+
+/* allocates table with empty buckets */
+template <class T, class U, class Hash, class KeyEqual>
+typename HashTable_Concurrent<T, U, Hash, KeyEqual>::Table* HashTable_Concurrent<T, U, Hash, KeyEqual>::allocateTable(const unsigned int& length)
+{
+    Table* table = new Table;
+    table->m_arrLength = length;
+    table->m_buckets = new std::atomic<Node*>[length];
+    for (unsigned int i = 0; i < length; ++i)
+    {
+        table->m_buckets[i].store(nullptr, std::memory_order_relaxed);
+    }
+    return table;
+}
+
+/* frees one retired node */
+template <class T, class U, class Hash, class KeyEqual>
+void HashTable_Concurrent<T, U, Hash, KeyEqual>::freeNode(void* ptr)
+{
+    delete static_cast<Node*>(ptr);
+}
+
+/* frees a table and every node still linked into it */
+template <class T, class U, class Hash, class KeyEqual>
+void HashTable_Concurrent<T, U, Hash, KeyEqual>::freeTableAndNodes(void* ptr)
+{
+    Table* table = static_cast<Table*>(ptr);
+    for (unsigned int b = 0; b < table->m_arrLength; ++b)
+    {
+        Node* node = table->m_buckets[b].load(std::memory_order_relaxed);
+        while (node != nullptr)
+        {
+            Node* next = node->m_next.load(std::memory_order_relaxed);
+            delete node;
+            node = next;
+        }
+    }
+    delete[] table->m_buckets;
+    delete table;
+}
+
+/* rounds length up to a power of two, at least one bucket per stripe */
+template <class T, class U, class Hash, class KeyEqual>
+unsigned int HashTable_Concurrent<T, U, Hash, KeyEqual>::roundLength(const unsigned int& length)
+{
+    unsigned int rounded = numStripes;
+    while (rounded < length)
+    {
+        rounded *= 2;
+    }
+    return rounded;
+}
+
+} // namespace datastructlib
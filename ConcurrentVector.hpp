@@ -0,0 +1,206 @@
+/* Concurrent append-only vector - by W Denny
+    - any number of threads may pushBack at the same time without locks
+    - pushBack claims an index with a single atomic fetch-add and constructs the element in place, so it is wait-free
+    - storage is a fixed table of buckets with power-of-two lengths (F, 2F, 4F, ...), so existing elements never move and no bucket is copied
+    - a bucket is allocated by whichever thread first needs it; racing allocations are resolved with one compare-exchange
+    - every slot has a ready flag set with release ordering once its element is constructed, so readers can safely read any published index
+    - elements cannot be removed while the vector is shared; the dtor must only run once all threads are done with it
+*/
+#pragma once
+
+#include <atomic>
+#include <assert.h>
+#include <new>
+#include <utility>
+
+namespace datastructlib
+{
+
+template <class T, unsigned int FirstBucketLengthLog2 = 5>
+class ConcurrentVector
+{
+    static_assert(FirstBucketLengthLog2 < 31, "first bucket length must fit in an unsigned int");
+
+private:
+    static constexpr unsigned int maxBuckets = 33 - FirstBucketLengthLog2; // enough buckets to address every unsigned int index
+    static constexpr unsigned long long firstBucketLength = 1ull << FirstBucketLengthLog2;
+
+    std::atomic<unsigned char*> m_buckets[maxBuckets]; // each bucket is raw element storage followed by one ready flag per element
+    std::atomic<unsigned int> m_length; // number of indexes handed out - slots below this may still be under construction
+
+public:
+    ConcurrentVector();
+    ConcurrentVector(const ConcurrentVector&) = delete;
+    ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+    ~ConcurrentVector();
+
+    unsigned int pushBack(const T& val); // returns index of the new element
+    unsigned int pushBack(T&& val);
+    template <class... Args>
+    unsigned int emplaceBack(Args&&... args);
+
+    bool isPublished(const unsigned int& ind) const; // true once the element at ind is fully constructed
+    T get(const unsigned int& ind) const;
+    const T* getPtr(const unsigned int& ind) const; // stays valid for the lifetime of the vector
+    unsigned int length() const;
+
+private:
+    static void locate(const unsigned int& ind, unsigned int& bucket, unsigned int& offset);
+    static unsigned long long bucketLength(const unsigned int& bucket);
+    static T* bucketData(unsigned char* bucketPtr);
+    static std::atomic<unsigned char>* bucketFlags(unsigned char* bucketPtr, const unsigned int& bucket);
+    unsigned char* bucketFor(const unsigned int& bucket); // returns bucket, allocating it if no thread has yet
+};
+
+/* default ctor - no bucket allocated until first push */
+template <class T, unsigned int FirstBucketLengthLog2>
+ConcurrentVector<T, FirstBucketLengthLog2>::ConcurrentVector()
+{
+    for (unsigned int b = 0; b < maxBuckets; ++b)
+    {
+        this->m_buckets[b].store(nullptr, std::memory_order_relaxed);
+    }
+    this->m_length.store(0, std::memory_order_relaxed);
+}
+
+/* dtor - must not run concurrently with any other call */
+template <class T, unsigned int FirstBucketLengthLog2>
+ConcurrentVector<T, FirstBucketLengthLog2>::~ConcurrentVector()
+{
+    for (unsigned int b = 0; b < maxBuckets; ++b)
+    {
+        unsigned char* bucketPtr = this->m_buckets[b].load(std::memory_order_acquire);
+        if (bucketPtr == nullptr)
+            continue;
+        T* data = bucketData(bucketPtr);
+        std::atomic<unsigned char>* flags = bucketFlags(bucketPtr, b);
+        for (unsigned long long i = 0; i < bucketLength(b); ++i)
+        {
+            if (flags[i].load(std::memory_order_acquire) != 0)
+                data[i].~T();
+        }
+        ::operator delete(bucketPtr);
+    }
+}
+
+/* appends copy of val, returns its index */
+template <class T, unsigned int FirstBucketLengthLog2>
+unsigned int ConcurrentVector<T, FirstBucketLengthLog2>::pushBack(const T& val)
+{
+    return this->emplaceBack(val);
+}
+
+/* appends val by moving it, returns its index */
+template <class T, unsigned int FirstBucketLengthLog2>
+unsigned int ConcurrentVector<T, FirstBucketLengthLog2>::pushBack(T&& val)
+{
+    return this->emplaceBack(std::move(val));
+}
+
+/* claims next index, constructs the element in its slot and publishes it */
+template <class T, unsigned int FirstBucketLengthLog2>
+template <class... Args>
+unsigned int ConcurrentVector<T, FirstBucketLengthLog2>::emplaceBack(Args&&... args)
+{
+    unsigned int ind = this->m_length.fetch_add(1, std::memory_order_relaxed);
+    assert(ind != 0xFFFFFFFFu); // index space exhausted
+    unsigned int bucket, offset;
+    locate(ind, bucket, offset);
+    unsigned char* bucketPtr = this->bucketFor(bucket);
+    ::new (static_cast<void*>(bucketData(bucketPtr) + offset)) T(std::forward<Args>(args)...);
+    bucketFlags(bucketPtr, bucket)[offset].store(1, std::memory_order_release); // publish - readers that see the flag see the element
+    return ind;
+}
+
+/* returns true if element at ind has been constructed and published */
+template <class T, unsigned int FirstBucketLengthLog2>
+bool ConcurrentVector<T, FirstBucketLengthLog2>::isPublished(const unsigned int& ind) const
+{
+    if (ind >= this->m_length.load(std::memory_order_acquire))
+        return false;
+    unsigned int bucket, offset;
+    locate(ind, bucket, offset);
+    unsigned char* bucketPtr = this->m_buckets[bucket].load(std::memory_order_acquire);
+    return (bucketPtr != nullptr) && (bucketFlags(bucketPtr, bucket)[offset].load(std::memory_order_acquire) != 0);
+}
+
+/* returns copy of published element */
+template <class T, unsigned int FirstBucketLengthLog2>
+T ConcurrentVector<T, FirstBucketLengthLog2>::get(const unsigned int& ind) const
+{
+    return *this->getPtr(ind);
+}
+
+/* returns ptr to published element */
+template <class T, unsigned int FirstBucketLengthLog2>
+const T* ConcurrentVector<T, FirstBucketLengthLog2>::getPtr(const unsigned int& ind) const
+{
+    assert(this->isPublished(ind)); // reading an unpublished slot would race with its construction
+    unsigned int bucket, offset;
+    locate(ind, bucket, offset);
+    return bucketData(this->m_buckets[bucket].load(std::memory_order_acquire)) + offset;
+}
+
+/* returns number of indexes handed out - some of the newest may not be published yet */
+template <class T, unsigned int FirstBucketLengthLog2>
+unsigned int ConcurrentVector<T, FirstBucketLengthLog2>::length() const
+{
+    return this->m_length.load(std::memory_order_acquire);
+}
+
+/* maps index to bucket and offset
+    - bucket b holds F * 2^b elements starting at index F * (2^b - 1), so ind + F has its top bit in position b + log2(F)
+*/
+template <class T, unsigned int FirstBucketLengthLog2>
+void ConcurrentVector<T, FirstBucketLengthLog2>::locate(const unsigned int& ind, unsigned int& bucket, unsigned int& offset)
+{
+    unsigned long long pos = static_cast<unsigned long long>(ind) + firstBucketLength;
+    unsigned int topBit = 63 - __builtin_clzll(pos);
+    bucket = topBit - FirstBucketLengthLog2;
+    offset = static_cast<unsigned int>(pos - (1ull << topBit));
+}
+
+/* returns number of elements in bucket */
+template <class T, unsigned int FirstBucketLengthLog2>
+unsigned long long ConcurrentVector<T, FirstBucketLengthLog2>::bucketLength(const unsigned int& bucket)
+{
+    return firstBucketLength << bucket;
+}
+
+/* returns element storage at the start of a bucket */
+template <class T, unsigned int FirstBucketLengthLog2>
+T* ConcurrentVector<T, FirstBucketLengthLog2>::bucketData(unsigned char* bucketPtr)
+{
+    return reinterpret_cast<T*>(bucketPtr);
+}
+
+/* returns ready flags stored after the elements of a bucket */
+template <class T, unsigned int FirstBucketLengthLog2>
+std::atomic<unsigned char>* ConcurrentVector<T, FirstBucketLengthLog2>::bucketFlags(unsigned char* bucketPtr, const unsigned int& bucket)
+{
+    return reinterpret_cast<std::atomic<unsigned char>*>(bucketPtr + sizeof(T) * bucketLength(bucket));
+}
+
+/* returns bucket, allocating it if needed - if two threads race to allocate, the loser frees its copy and uses the winner's */
+template <class T, unsigned int FirstBucketLengthLog2>
+unsigned char* ConcurrentVector<T, FirstBucketLengthLog2>::bucketFor(const unsigned int& bucket)
+{
+    unsigned char* bucketPtr = this->m_buckets[bucket].load(std::memory_order_acquire);
+    if (bucketPtr != nullptr)
+        return bucketPtr;
+
+    static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "over-aligned element types are not supported");
+    unsigned long long length = bucketLength(bucket);
+    unsigned char* newBucketPtr = static_cast<unsigned char*>(::operator new(sizeof(T) * length + length));
+    std::atomic<unsigned char>* flags = bucketFlags(newBucketPtr, bucket);
+    for (unsigned long long i = 0; i < length; ++i)
+    {
+        ::new (static_cast<void*>(flags + i)) std::atomic<unsigned char>(0);
+    }
+    if (this->m_buckets[bucket].compare_exchange_strong(bucketPtr, newBucketPtr, std::memory_order_acq_rel, std::memory_order_acquire))
+        return newBucketPtr;
+    ::operator delete(newBucketPtr); // another thread installed the bucket first - bucketPtr now holds it
+    return bucketPtr;
+}
+
+} // namespace datastructlib
@@ -0,0 +1,473 @@
+/* Cuckoo hash table - by W Denny
+    - bucketized cuckoo hashing: slots are grouped in buckets of 4, and every key may only live in one of its two buckets (or the stash)
+    - a lookup reads at most two buckets whatever the load factor, so unlike linear/quadratic probing its cost does not grow with cluster length
+    - each slot has a one-byte tag taken from the top bits of the hash (0 marks an empty slot); the 4 tags of a bucket are matched at once as one 32-bit word
+    - the second bucket is the first xored with a hash of the tag (partial-key cuckoo hashing), so a key can be moved to its other bucket without rehashing it
+    - an insert into two full buckets moves keys to their other bucket along a random walk of at most cuckooMaxDisplacements steps
+    - the key left over when the walk runs out goes into a small stash; the stash is searched only while it is not empty
+    - when the stash is full the table is rebuilt: with a new hash seed if the load is low (the keys formed a cycle), otherwise at double the length
+    - the Hash policy is a full hash policy (see hashIsAvalanching in HashFunctions.hpp)
+    - key-value pairs are stored inline, same find/insert/remove interface as the other hash tables; probe lengths in Stats count buckets read
+*/
+#pragma once
+
+#include "HashTable.hpp"
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+namespace datastructlib
+{
+
+namespace detail
+{
+
+const unsigned int cuckooBucketLength = 4;
+
+/* returns a mask with bit 8i + 7 set for every byte i of tags equal to tag - exact, no borrow between bytes */
+inline uint32_t cuckooMatchTag(const uint32_t& tags, const uint8_t& tag)
+{
+    uint32_t diff = tags ^ (0x01010101u * tag);
+    uint32_t nonZero = (((diff & 0x7F7F7F7Fu) + 0x7F7F7F7Fu) | diff) & 0x80808080u;
+    return ~nonZero & 0x80808080u;
+}
+
+} // namespace detail
+
+constexpr unsigned int cuckooMaxDisplacements = 512; // steps of the random walk before the homeless key goes to the stash
+constexpr unsigned int cuckooStashLength = 4;
+
+template <class T, class U, class Hash = Hasher<T>, class KeyEqual = std::equal_to<T>, class Stats = NullStats>
+class HashTable_Cuckoo : protected Stats // stats policy is a base so that NullStats takes no space
+{
+private:
+    uint8_t* m_tags; // one tag per slot, 0 for empty
+    KeyValPair<T, U>* m_data; // raw storage - slot i is only constructed while its tag is non-zero
+    KeyValPair<T, U>* m_stash; // raw storage for cuckooStashLength pairs, the first m_stashLength constructed
+    unsigned int m_stashLength;
+    unsigned int m_arrLength; // slots - power of two, at least two buckets
+    unsigned int m_numEntries; // including the stash
+    uint64_t m_seed; // 0 until the first rebuild for a cycle
+    uint32_t m_rngState; // picks the slot evicted at each step of a walk
+    Hash m_hash;
+    KeyEqual m_keyEqual;
+    double m_maxLoadFactor;
+
+public:
+    HashTable_Cuckoo(const unsigned int& length = 16, const double& maxLoadFactor = 0.9, const Hash& hash = Hash(), const KeyEqual& keyEqual = KeyEqual());
+    HashTable_Cuckoo(const HashTable_Cuckoo&) = delete;
+    HashTable_Cuckoo& operator=(const HashTable_Cuckoo&) = delete;
+    ~HashTable_Cuckoo();
+    HashTable_SearchResult<T, U> find(const T& key) const;
+    void insert(const T& key, const U& val); // overwrites the value if key is already present
+    bool remove(const T& key);
+    void display();
+    template <class F>
+    void forEach(F f) const; // calls f(key, val) for every entry, in slot order then the stash
+    void resizeArray(const unsigned int& newLength); // rounded up to a power of two of at least two buckets
+    double loadFactor() const;
+    unsigned int size() const;
+    unsigned int stashSize() const;
+    const Stats& stats() const; // refreshes the bucket occupancy histogram when Stats is enabled
+
+private:
+    size_t hashKey(const T& key) const;
+    unsigned int findSlot(const T& key, const size_t& hash, unsigned int& probeLength) const; // slot index, m_arrLength + i for stash entry i, or m_arrLength + cuckooStashLength if not present
+    bool place(KeyValPair<T, U>& kvp, unsigned int& numSteps); // moves kvp into the table - on false kvp holds a pair that found no place and the table must be rebuilt
+    void rebuild(unsigned int newLength, const bool& reseed); // reinserts every pair, growing or reseeding again until all fit
+    uint32_t bucketTags(const unsigned int& bucket) const;
+    unsigned int firstBucket(const size_t& hash) const;
+    unsigned int altBucket(const unsigned int& bucket, const uint8_t& tag) const;
+    static uint8_t tagOf(const size_t& hash);
+    static unsigned int roundLength(const unsigned int& length);
+};
+
+/* ctor */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+HashTable_Cuckoo<T, U, Hash, KeyEqual, Stats>::HashTable_Cuckoo(const unsigned int& length, const double& maxLoadFactor, const Hash& hash, const KeyEqual& keyEqual)
+    : m_hash(hash), m_keyEqual(keyEqual)
+{
+    assert((maxLoadFactor > 0) && (maxLoadFactor < 1));
+    this->m_maxLoadFactor = maxLoadFactor;
+    this->m_arrLength = roundLength(length);
+    this->m_tags = new uint8_t[this->m_arrLength]();
+    this->m_data = detail::allocateStorage<KeyValPair<T, U>>(this->m_arrLength);
+    this->m_stash = detail::allocateStorage<KeyValPair<T, U>>(cuckooStashLength);
+    this->m_stashLength = 0;
+    this->m_numEntries = 0;
+    this->m_seed = 0;
+    this->m_rngState = 0x9E3779B9u;
+}
+
+/* dtor - destroys pairs in full slots and the stash */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+HashTable_Cuckoo<T, U, Hash, KeyEqual, Stats>::~HashTable_Cuckoo()
+{
+    for (unsigned int i = 0; i < this->m_arrLength; ++i)
+    {
+        if (this->m_tags[i] != 0)
+            this->m_data[i].~KeyValPair<T, U>();
+    }
+    detail::destroyRange(this->m_stash, this->m_stashLength);
+    detail::deallocateStorage(this->m_data);
+    detail::deallocateStorage(this->m_stash);
+    delete[] this->m_tags;
+}
+
+/* returns the pointer to a key value pair given key */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+HashTable_SearchResult<T, U> HashTable_Cuckoo<T, U, Hash, KeyEqual, Stats>::find(const T& key) const
+{
+    HashTable_SearchResult<T, U> result;
+    unsigned int probeLength;
+    unsigned int ind = this->findSlot(key, this->hashKey(key), probeLength);
+    const bool found = ind != this->m_arrLength + cuckooStashLength;
+    this->recordLookup(probeLength, found);
+    if (!found)
+    {
+        result.m_kvpPtr = nullptr; // not found
+        return result;
+    }
+    result.m_hashedKey = ind;
+    result.m_kvpPtr = (ind < this->m_arrLength) ? this->m_data + ind : this->m_stash + (ind - this->m_arrLength);
+    return result;
+}
+
+/* inserts new entry, or overwrites the value if key already present */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+void HashTable_Cuckoo<T, U, Hash, KeyEqual, Stats>::insert(const T& key, const U& val)
+{
+    unsigned int probeLength;
+    unsigned int existing = this->findSlot(key, this->hashKey(key), probeLength);
+    if (existing != this->m_arrLength + cuckooStashLength)
+    {
+        this->recordInsert(probeLength);
+        ((existing < this->m_arrLength) ? this->m_data[existing] : this->m_stash[existing - this->m_arrLength]).m_val = val;
+        return;
+    }
+    if ((double) (this->m_numEntries + 1) > this->m_maxLoadFactor * this->m_arrLength)
+    {
+        this->rebuild(this->m_arrLength * 2, false);
+    }
+    KeyValPair<T, U> kvp(key, val);
+    unsigned int numSteps;
+    while (!this->place(kvp, numSteps)) // kvp now holds whichever pair was left without a slot
+    {
+        // a full stash at low load means the keys formed cycles under this hash - a new seed separates them, more room does not
+        bool reseed = (double) this->m_numEntries < 0.5 * this->m_maxLoadFactor * this->m_arrLength;
+        this->rebuild(reseed ? this->m_arrLength : this->m_arrLength * 2, reseed);
+    }
+    this->recordInsert(numSteps);
+    this->m_numEntries++;
+}
+
+/* remove entry by key */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+bool HashTable_Cuckoo<T, U, Hash, KeyEqual, Stats>::remove(const T& key)
+{
+    unsigned int probeLength;
+    unsigned int ind = this->findSlot(key, this->hashKey(key), probeLength);
+    if (ind == this->m_arrLength + cuckooStashLength)
+    {
+        return false; // object not found inside hash table
+    }
+    if (ind < this->m_arrLength)
+    {
+        this->m_data[ind].~KeyValPair<T, U>();
+        this->m_tags[ind] = 0;
+    }
+    else
+    {
+        // last stash entry fills the gap
+        KeyValPair<T, U>* last = this->m_stash + (this->m_stashLength - 1);
+        KeyValPair<T, U>* removed = this->m_stash + (ind - this->m_arrLength);
+        if (removed != last)
+            *removed = std::move(*last);
+        last->~KeyValPair<T, U>();
+        this->m_stashLength--;
+    }
+    this->m_numEntries--;
+    this->recordRemove();
+    return true;
+}
+
+/* display
+    - note the value datatype must be defined for ostream operator
+*/
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+void HashTable_Cuckoo<T, U, Hash, KeyEqual, Stats>::display()
+{
+    std::cout << "======================" << std::endl;
+    for (unsigned int i = 0; i < this->m_arrLength; ++i)
+    {
+        std::cout << "Index (" << i << ") \t |";
+        if (this->m_tags[i] != 0)
+        {
+            std::cout << "\t Key: " << this->m_data[i].m_key << " -> Value: " << this->m_data[i].m_val << std::endl;
+        }
+        else
+        {
+            std::cout << std::endl;
+        }
+        if ((i + 1) % detail::cuckooBucketLength == 0)
+            std::cout << "----------------------" << std::endl; // end of bucket
+    }
+    for (unsigned int i = 0; i < this->m_stashLength; ++i)
+    {
+        std::cout << "Stash (" << i << ") \t |\t Key: " << this->m_stash[i].m_key << " -> Value: " << this->m_stash[i].m_val << std::endl;
+    }
+    std::cout << "======================" << std::endl;
+}
+
+/* calls f(key, val) for every entry */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+template <class F>
+void HashTable_Cuckoo<T, U, Hash, KeyEqual, Stats>::forEach(F f) const
+{
+    for (unsigned int i = 0; i < this->m_arrLength; ++i)
+    {
+        if (this->m_tags[i] != 0)
+            f(this->m_data[i].m_key, this->m_data[i].m_val);
+    }
+    for (unsigned int i = 0; i < this->m_stashLength; ++i)
+    {
+        f(this->m_stash[i].m_key, this->m_stash[i].m_val);
+    }
+}
+
+/* resize array - pairs are placed again in the new array */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+void HashTable_Cuckoo<T, U, Hash, KeyEqual, Stats>::resizeArray(const unsigned int& newLength)
+{
+    this->rebuild(newLength, false);
+}
+
+/* returns load factor */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+double HashTable_Cuckoo<T, U, Hash, KeyEqual, Stats>::loadFactor() const
+{
+    return ((double) this->m_numEntries) / ((double) this->m_arrLength);
+}
+
+/* returns number of entries */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+unsigned int HashTable_Cuckoo<T, U, Hash, KeyEqual, Stats>::size() const
+{
+    return this->m_numEntries;
+}
+
+/* returns number of entries held in the stash */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+unsigned int HashTable_Cuckoo<T, U, Hash, KeyEqual, Stats>::stashSize() const
+{
+    return this->m_stashLength;
+}
+
+/* returns the stats policy object - a snapshot of full slots per bucket is taken first if stats are enabled */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+const Stats& HashTable_Cuckoo<T, U, Hash, KeyEqual, Stats>::stats() const
+{
+    if constexpr (Stats::enabled)
+    {
+        this->beginSnapshot();
+        for (unsigned int bucket = 0; bucket < this->m_arrLength / detail::cuckooBucketLength; ++bucket)
+        {
+            this->recordChainLength(detail::cuckooBucketLength - __builtin_popcount(detail::cuckooMatchTag(this->bucketTags(bucket), 0)));
+        }
+        this->recordTombstones(0, this->m_arrLength);
+    }
+    return *this;
+}
+
+/* hashes key - mixed with the seed once a rebuild has picked one */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+size_t HashTable_Cuckoo<T, U, Hash, KeyEqual, Stats>::hashKey(const T& key) const
+{
+    size_t hash = this->m_hash(key);
+    if constexpr (!hashIsAvalanching<Hash>)
+        hash = static_cast<size_t>(hashInteger(hash));
+    if (this->m_seed != 0)
+        hash = static_cast<size_t>(hashInteger(hash ^ this->m_seed));
+    return hash;
+}
+
+/* checks the key's two buckets, then the stash - the second bucket's pairs are prefetched while the first is checked */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+unsigned int HashTable_Cuckoo<T, U, Hash, KeyEqual, Stats>::findSlot(const T& key, const size_t& hash, unsigned int& probeLength) const
+{
+    const uint8_t tag = tagOf(hash);
+    unsigned int bucket = this->firstBucket(hash);
+    const unsigned int alt = this->altBucket(bucket, tag);
+    detail::prefetch(this->m_data + alt * detail::cuckooBucketLength);
+    for (probeLength = 1; probeLength <= 2; ++probeLength)
+    {
+        uint32_t match = detail::cuckooMatchTag(this->bucketTags(bucket), tag);
+        while (match != 0)
+        {
+            unsigned int ind = bucket * detail::cuckooBucketLength + (__builtin_ctz(match) >> 3);
+            if (this->m_keyEqual(this->m_data[ind].m_key, key))
+                return ind;
+            match &= match - 1;
+        }
+        bucket = alt;
+    }
+    probeLength = 2;
+    for (unsigned int i = 0; i < this->m_stashLength; ++i)
+    {
+        if (this->m_keyEqual(this->m_stash[i].m_key, key))
+            return this->m_arrLength + i;
+    }
+    return this->m_arrLength + cuckooStashLength;
+}
+
+/* places kvp in a free slot of one of its buckets, otherwise walks: evict a random pair of the bucket, move it to its other bucket, repeat
+    - after cuckooMaxDisplacements steps the pair in hand goes to the stash
+    - returns false if the stash is full too, leaving the pair in hand in kvp
+    - numSteps is set to the number of buckets written to, counting the stash as one
+*/
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+bool HashTable_Cuckoo<T, U, Hash, KeyEqual, Stats>::place(KeyValPair<T, U>& kvp, unsigned int& numSteps)
+{
+    const size_t hash = this->hashKey(kvp.m_key);
+    uint8_t tag = tagOf(hash);
+    unsigned int bucket = this->firstBucket(hash);
+    for (unsigned int step = 0; step <= cuckooMaxDisplacements; ++step)
+    {
+        uint32_t freeMask = detail::cuckooMatchTag(this->bucketTags(bucket), 0);
+        if ((step == 0) && (freeMask == 0))
+        {
+            bucket = this->altBucket(bucket, tag); // try the other bucket before evicting anything
+            freeMask = detail::cuckooMatchTag(this->bucketTags(bucket), 0);
+        }
+        if (freeMask != 0)
+        {
+            unsigned int ind = bucket * detail::cuckooBucketLength + (__builtin_ctz(freeMask) >> 3);
+            ::new (static_cast<void*>(this->m_data + ind)) KeyValPair<T, U>(std::move(kvp));
+            this->m_tags[ind] = tag;
+            numSteps = step + 1;
+            return true;
+        }
+        if (step == cuckooMaxDisplacements)
+            break;
+        // swap the pair in hand with a random pair of the bucket, then carry the evicted pair to its other bucket
+        this->m_rngState ^= this->m_rngState << 13;
+        this->m_rngState ^= this->m_rngState >> 17;
+        this->m_rngState ^= this->m_rngState << 5;
+        unsigned int ind = bucket * detail::cuckooBucketLength + (this->m_rngState & (detail::cuckooBucketLength - 1));
+        std::swap(kvp, this->m_data[ind]);
+        std::swap(tag, this->m_tags[ind]);
+        bucket = this->altBucket(bucket, tag);
+    }
+    numSteps = cuckooMaxDisplacements + 2;
+    if (this->m_stashLength == cuckooStashLength)
+        return false;
+    ::new (static_cast<void*>(this->m_stash + this->m_stashLength)) KeyValPair<T, U>(std::move(kvp));
+    this->m_stashLength++;
+    return true;
+}
+
+/* rebuilds the table at newLength, with a new seed if reseed is set
+    - pairs are copied, so if one finds no place the new arrays are dropped and the rebuild retries with a fresh seed (and double length after repeated failures) from the intact old arrays
+*/
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+void HashTable_Cuckoo<T, U, Hash, KeyEqual, Stats>::rebuild(unsigned int newLength, const bool& reseed)
+{
+    this->beginResize();
+    uint8_t* oldTags = this->m_tags;
+    KeyValPair<T, U>* oldData = this->m_data;
+    KeyValPair<T, U>* oldStash = this->m_stash;
+    const unsigned int oldArrLength = this->m_arrLength;
+    const unsigned int oldStashLength = this->m_stashLength;
+    newLength = roundLength(newLength);
+    bool newSeed = reseed;
+    for (unsigned int attempt = 1; ; ++attempt)
+    {
+        if (newSeed)
+            this->m_seed = hashInteger(this->m_seed + attempt);
+        this->m_arrLength = newLength;
+        this->m_tags = new uint8_t[this->m_arrLength]();
+        this->m_data = detail::allocateStorage<KeyValPair<T, U>>(this->m_arrLength);
+        this->m_stash = detail::allocateStorage<KeyValPair<T, U>>(cuckooStashLength);
+        this->m_stashLength = 0;
+        bool placed = true;
+        unsigned int numSteps;
+        for (unsigned int i = 0; placed && (i < oldArrLength + oldStashLength); ++i)
+        {
+            if ((i < oldArrLength) && (oldTags[i] == 0))
+                continue;
+            KeyValPair<T, U> kvp((i < oldArrLength) ? oldData[i] : oldStash[i - oldArrLength]);
+            placed = this->place(kvp, numSteps);
+        }
+        if (placed)
+            break;
+        // drop the partial copy and try again
+        for (unsigned int i = 0; i < this->m_arrLength; ++i)
+        {
+            if (this->m_tags[i] != 0)
+                this->m_data[i].~KeyValPair<T, U>();
+        }
+        detail::destroyRange(this->m_stash, this->m_stashLength);
+        detail::deallocateStorage(this->m_data);
+        detail::deallocateStorage(this->m_stash);
+        delete[] this->m_tags;
+        newSeed = true;
+        if (attempt % 4 == 0)
+            newLength *= 2;
+    }
+    for (unsigned int i = 0; i < oldArrLength; ++i)
+    {
+        if (oldTags[i] != 0)
+            oldData[i].~KeyValPair<T, U>();
+    }
+    detail::destroyRange(oldStash, oldStashLength);
+    detail::deallocateStorage(oldData);
+    detail::deallocateStorage(oldStash);
+    delete[] oldTags;
+    this->endResize();
+}
+
+/* returns the 4 tags of bucket as one word, slot i in byte i */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+uint32_t HashTable_Cuckoo<T, U, Hash, KeyEqual, Stats>::bucketTags(const unsigned int& bucket) const
+{
+    const uint8_t* tags = this->m_tags + bucket * detail::cuckooBucketLength;
+    return (uint32_t) tags[0] | ((uint32_t) tags[1] << 8) | ((uint32_t) tags[2] << 16) | ((uint32_t) tags[3] << 24);
+}
+
+/* returns first bucket of hash - from the low bits, the tag comes from the high bits */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+unsigned int HashTable_Cuckoo<T, U, Hash, KeyEqual, Stats>::firstBucket(const size_t& hash) const
+{
+    return static_cast<unsigned int>(hash) & (this->m_arrLength / detail::cuckooBucketLength - 1);
+}
+
+/* returns the other bucket of a key given one of its buckets and its tag - applying it twice gives back the first bucket
+    - the xored offset is odd, so the two buckets always differ
+*/
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+unsigned int HashTable_Cuckoo<T, U, Hash, KeyEqual, Stats>::altBucket(const unsigned int& bucket, const uint8_t& tag) const
+{
+    return (bucket ^ ((tag * 0x5BD1E995u) | 1)) & (this->m_arrLength / detail::cuckooBucketLength - 1);
+}
+
+/* top 8 bits of hash as tag, 0 is moved to 1 as it marks empty slots */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+uint8_t HashTable_Cuckoo<T, U, Hash, KeyEqual, Stats>::tagOf(const size_t& hash)
+{
+    uint8_t tag = static_cast<uint8_t>(static_cast<uint64_t>(hash) >> 56);
+    return (tag == 0) ? 1 : tag;
+}
+
+/* rounds length up to a power of two of at least two buckets */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+unsigned int HashTable_Cuckoo<T, U, Hash, KeyEqual, Stats>::roundLength(const unsigned int& length)
+{
+    unsigned int rounded = 2 * detail::cuckooBucketLength;
+    while (rounded < length)
+    {
+        rounded <<= 1;
+    }
+    return rounded;
+}
+
+}; // namespace datastructlib
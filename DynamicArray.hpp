@@ -1,200 +1,556 @@
-/* Dynamic array by W Denny */
+/* Dynamic array by W Denny
+    - elements live in raw uninitialised storage and are constructed in place
+    - growth relocates elements by move (memcpy for trivially copyable types) instead of default-constructing and copying
+    - contains, valIndArr and removeVal use the SIMD kernels in SimdSearch.hpp for arithmetic element types
+    - when the stat array grows and shrinks is set by the growth policy template parameter G
+*/
 
 #pragma once
 
+#include "SimdSearch.hpp"
 #include <iostream>
 #include <assert.h>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace datastructlib
 {
-    
+
+namespace detail
+{
+
+/* allocates uninitialised storage for n elements - no constructors are run */
+template <class T>
+T* allocateStorage(const unsigned int& n)
+{
+    if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        return static_cast<T*>(::operator new(sizeof(T) * n, std::align_val_t(alignof(T))));
+    else
+        return static_cast<T*>(::operator new(sizeof(T) * n));
+}
+
+/* frees storage obtained from allocateStorage - elements must already be destroyed */
+template <class T>
+void deallocateStorage(T* ptr)
+{
+    if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        ::operator delete(ptr, std::align_val_t(alignof(T)));
+    else
+        ::operator delete(ptr);
+}
+
+/* runs destructors over n constructed elements */
+template <class T>
+void destroyRange(T* first, const unsigned int& n)
+{
+    if constexpr (!std::is_trivially_destructible<T>::value)
+    {
+        for (unsigned int i = 0; i < n; ++i)
+            first[i].~T();
+    }
+}
+
+/* relocates n elements from src to dst, leaving src uninitialised
+    - ranges may overlap, so this is also used to shift elements left/right within one array
+    - trivially copyable types are moved with a single memmove
+*/
+template <class T>
+void relocate(T* dst, T* src, const unsigned int& n)
+{
+    if ((n == 0) || (dst == src))
+        return;
+    if constexpr (std::is_trivially_copyable<T>::value)
+    {
+        std::memmove(static_cast<void*>(dst), static_cast<const void*>(src), sizeof(T) * n);
+    }
+    else if (dst < src)
+    {
+        for (unsigned int i = 0; i < n; ++i) // left to right so no element is overwritten before it is moved
+        {
+            ::new (static_cast<void*>(dst + i)) T(std::move(src[i]));
+            src[i].~T();
+        }
+    }
+    else
+    {
+        for (unsigned int i = n; i > 0; --i) // right to left for the same reason
+        {
+            ::new (static_cast<void*>(dst + i - 1)) T(std::move(src[i - 1]));
+            src[i - 1].~T();
+        }
+    }
+}
+
+/* copy constructs n elements from src into uninitialised dst - ranges must not overlap */
 template <class T>
+void copyConstruct(T* dst, const T* src, const unsigned int& n)
+{
+    if (n == 0)
+        return;
+    if constexpr (std::is_trivially_copyable<T>::value)
+    {
+        std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), sizeof(T) * n);
+    }
+    else
+    {
+        for (unsigned int i = 0; i < n; ++i)
+            ::new (static_cast<void*>(dst + i)) T(src[i]);
+    }
+}
+
+} // namespace detail
+
+/* growth policy for DynamicArray
+    - when full, the stat array grows by a factor of GrowthNum / GrowthDen (rounded up so it always grows)
+    - the stat array is halved once length <= stat array length / ShrinkDivisor, so a shrink leaves the array at most 2 / ShrinkDivisor full
+    - ShrinkDivisor > 2 gives hysteresis: appends/removes alternating around one size no longer reallocate every call
+    - ShrinkDivisor = 0 disables shrinking
+    - the stat array never shrinks below MinCapacity, or the array's minimum length (its default length, or the length last reserved) if that is larger
+*/
+template <unsigned int GrowthNum = 2, unsigned int GrowthDen = 1, unsigned int ShrinkDivisor = 4, unsigned int MinCapacity = 1>
+struct GrowthPolicy
+{
+    static_assert((GrowthDen > 0) && (GrowthNum > GrowthDen), "growth factor must be greater than one");
+    static_assert((ShrinkDivisor == 0) || (ShrinkDivisor > 2), "shrink threshold must be below half full so that a shrink is not undone by the next append");
+
+    /* returns new stat array length that holds at least required elements */
+    static unsigned int grow(const unsigned int& staticArrLength, const unsigned int& required)
+    {
+        unsigned long long newLength = (staticArrLength > MinCapacity) ? staticArrLength : MinCapacity;
+        if (newLength == 0)
+            newLength = 1;
+        while (newLength < required)
+        {
+            newLength = (newLength * GrowthNum + GrowthDen - 1) / GrowthDen;
+        }
+        return (newLength > 0xFFFFFFFFull) ? 0xFFFFFFFFu : static_cast<unsigned int>(newLength);
+    }
+
+    /* returns stat array length after any shrinking - unchanged if the array is not sparse enough */
+    static unsigned int shrink(const unsigned int& staticArrLength, const unsigned int& length, const unsigned int& minStaticArrLength)
+    {
+        if (ShrinkDivisor == 0)
+            return staticArrLength;
+        unsigned int minLength = (minStaticArrLength > MinCapacity) ? minStaticArrLength : MinCapacity;
+        unsigned int newLength = staticArrLength;
+        while ((length <= newLength / ShrinkDivisor) && (newLength / 2 >= minLength))
+        {
+            newLength /= 2;
+        }
+        return newLength;
+    }
+};
+
+/* doubles when full, halves when a quarter full */
+using DefaultGrowthPolicy = GrowthPolicy<>;
+
+template <class T, class G = DefaultGrowthPolicy>
 class DynamicArray
 {
 private:
-    T* m_staticArr;
+    T* m_staticArr; // raw storage - only the first m_length slots hold constructed elements
     unsigned int m_length;
     unsigned int m_staticArrLength; // this grows/shrinks as elements added/removed
     unsigned int m_defaultStaticArrLength = 16;
-    
+    unsigned int m_minStaticArrLength; // stat array never shrinks below this on removal - the default length, or more while a reserve holds
+
 public:
     DynamicArray();
     DynamicArray(const unsigned int& defaultStaticArrLength);
     DynamicArray(const DynamicArray&);
+    DynamicArray(DynamicArray&&) noexcept;
+    ~DynamicArray();
+    DynamicArray& operator=(DynamicArray); // copy-and-swap handles both copy and move assignment
+    void swap(DynamicArray&) noexcept;
+
     T get(const unsigned int& ind) const;
     T* getPtr(const unsigned int& ind) const; // returns ptr of element in array
     void set(const unsigned int& ind, const T& val);
+    void set(const unsigned int& ind, T&& val);
     void insert(const unsigned int& ind, const T& val);
+    void insert(const unsigned int& ind, T&& val);
     void append(const T& val);
+    void append(T&& val);
+    template <class... Args>
+    T& emplaceBack(Args&&... args); // constructs new element in place at end of array
+    void insertRange(const unsigned int& ind, const T* vals, const unsigned int& n); // inserts n values at index with a single shift
+    void insertRange(const unsigned int& ind, const DynamicArray& arr);
+    void appendRange(const T* vals, const unsigned int& n);
+    void appendRange(const DynamicArray& arr);
     void remove(const unsigned int& ind);
+    void removeRange(const unsigned int& first, const unsigned int& last); // removes elements in [first, last)
+    template <class Pred>
+    unsigned int removeIf(Pred pred); // removes all elements satisfying pred, returns number removed
     void removeVal(const T& val);
     void clear();
     DynamicArray<unsigned int> valIndArr(const T& val) const; // returns dynamic array of indexes to elements in this array with a given value
     bool contains(const T& val) const;
     unsigned int length() const;
+    unsigned int capacity() const; // number of elements the stat array can hold before it must grow
+    void reserve(const unsigned int& n); // grows stat array to hold at least n elements, and keeps it that large until shrinkToFit
+    void shrinkToFit(); // shrinks stat array to exactly the current length, dropping any reserve
     void print();
 
 private:
     void reallocStaticArr(); // reallocate stat array - to be used once the static array length has been changed and new space to be allocated/old space to be deallocated
+    unsigned int grownStaticArrLength(const unsigned int& required) const; // returns stat array length from growth policy large enough to hold required elements
+    void shrinkIfSparse(); // shrinks the stat array as set by the growth policy, reallocating at most once
 };
 
 /* default ctor */
-template <class T>
-DynamicArray<T>::DynamicArray()
+template <class T, class G>
+DynamicArray<T, G>::DynamicArray()
 {
     this->m_staticArrLength = this->m_defaultStaticArrLength; // no array size provided, therefore set to default size
-    this->m_staticArr = new T[this->m_staticArrLength]; // initialise stat array
+    this->m_minStaticArrLength = this->m_defaultStaticArrLength;
+    this->m_staticArr = detail::allocateStorage<T>(this->m_staticArrLength); // initialise stat array - no elements constructed yet
     this->m_length = 0; // set length to zero
 }
 
 /* ctor with custom default static array size */
-template <class T>
-DynamicArray<T>::DynamicArray(const unsigned int& defaultStaticArrLength)
+template <class T, class G>
+DynamicArray<T, G>::DynamicArray(const unsigned int& defaultStaticArrLength)
 {
     this->m_defaultStaticArrLength = defaultStaticArrLength; // set array size
     this->m_staticArrLength = this->m_defaultStaticArrLength; // no array size provided, therefore set to default size
-    this->m_staticArr = new T[this->m_staticArrLength]; // initialise stat arr
+    this->m_minStaticArrLength = this->m_defaultStaticArrLength;
+    this->m_staticArr = detail::allocateStorage<T>(this->m_staticArrLength); // initialise stat arr
     this->m_length = 0; // set length to zero as dynamic arr is empty
 }
 
 /* copy ctor */
-template <class T>
-DynamicArray<T>::DynamicArray(const DynamicArray<T>& dynamicArr)
+template <class T, class G>
+DynamicArray<T, G>::DynamicArray(const DynamicArray<T, G>& dynamicArr)
 {
-    this->m_staticArrLength = this->m_defaultStaticArrLength;
-    this->m_staticArr = new T[this->m_staticArrLength];
+    this->m_defaultStaticArrLength = dynamicArr.m_defaultStaticArrLength;
+    this->m_minStaticArrLength = dynamicArr.m_minStaticArrLength;
+    this->m_staticArrLength = dynamicArr.m_staticArrLength;
+    this->m_staticArr = detail::allocateStorage<T>(this->m_staticArrLength);
     this->m_length = dynamicArr.length();
     for (unsigned int i = 0; i < dynamicArr.length(); ++i)
     {
-        this->m_staticArr[i] = dynamicArr.get(i);
+        ::new (static_cast<void*>(this->m_staticArr + i)) T(dynamicArr.m_staticArr[i]); // copy construct into raw storage
     }
-    //std::cout << "Copy constructor called" << std::endl;
+}
+
+/* move ctor - steals the stat array, leaving the source empty with no storage */
+template <class T, class G>
+DynamicArray<T, G>::DynamicArray(DynamicArray<T, G>&& dynamicArr) noexcept
+{
+    this->m_defaultStaticArrLength = dynamicArr.m_defaultStaticArrLength;
+    this->m_minStaticArrLength = dynamicArr.m_minStaticArrLength;
+    this->m_staticArrLength = dynamicArr.m_staticArrLength;
+    this->m_staticArr = dynamicArr.m_staticArr;
+    this->m_length = dynamicArr.m_length;
+    dynamicArr.m_minStaticArrLength = dynamicArr.m_defaultStaticArrLength;
+    dynamicArr.m_staticArr = nullptr;
+    dynamicArr.m_staticArrLength = 0;
+    dynamicArr.m_length = 0;
+}
+
+/* dtor */
+template <class T, class G>
+DynamicArray<T, G>::~DynamicArray()
+{
+    detail::destroyRange(this->m_staticArr, this->m_length);
+    detail::deallocateStorage(this->m_staticArr);
+}
+
+/* assignment - parameter is already a copy (or moved-into object), so just swap with it */
+template <class T, class G>
+DynamicArray<T, G>& DynamicArray<T, G>::operator=(DynamicArray<T, G> dynamicArr)
+{
+    this->swap(dynamicArr);
+    return *this;
+}
+
+/* swaps contents with another array */
+template <class T, class G>
+void DynamicArray<T, G>::swap(DynamicArray<T, G>& dynamicArr) noexcept
+{
+    std::swap(this->m_staticArr, dynamicArr.m_staticArr);
+    std::swap(this->m_length, dynamicArr.m_length);
+    std::swap(this->m_staticArrLength, dynamicArr.m_staticArrLength);
+    std::swap(this->m_defaultStaticArrLength, dynamicArr.m_defaultStaticArrLength);
+    std::swap(this->m_minStaticArrLength, dynamicArr.m_minStaticArrLength);
 }
 
 /* returns value given index */
-template <class T>
-T DynamicArray<T>::get(const unsigned int& ind) const
+template <class T, class G>
+T DynamicArray<T, G>::get(const unsigned int& ind) const
 {
     assert(ind < this->m_length); // check index does not exceed dynamic array length
     return this->m_staticArr[ind];
 }
 
 /* returns ptr of value given index */
-template <class T>
-T* DynamicArray<T>::getPtr(const unsigned int& ind) const
+template <class T, class G>
+T* DynamicArray<T, G>::getPtr(const unsigned int& ind) const
 {
     assert(ind < this->m_length);
     return &(this->m_staticArr[ind]);
 }
 
 /* returns length of array */
-template <class T>
-unsigned int DynamicArray<T>::length() const
+template <class T, class G>
+unsigned int DynamicArray<T, G>::length() const
 {
     return this->m_length;
 }
 
+/* returns length of stat array */
+template <class T, class G>
+unsigned int DynamicArray<T, G>::capacity() const
+{
+    return this->m_staticArrLength;
+}
+
+/* grows stat array so that n elements fit without further reallocation - never shrinks
+    - removals don't shrink the stat array below n until shrinkToFit is called, so a reserved array stays pre-sized while it is emptied and refilled
+*/
+template <class T, class G>
+void DynamicArray<T, G>::reserve(const unsigned int& n)
+{
+    if (n > this->m_minStaticArrLength)
+        this->m_minStaticArrLength = n;
+    if (n > this->m_staticArrLength)
+    {
+        this->m_staticArrLength = n;
+        this->reallocStaticArr();
+    }
+}
+
+/* releases unused stat array space and any reserve - may go below the default length */
+template <class T, class G>
+void DynamicArray<T, G>::shrinkToFit()
+{
+    this->m_minStaticArrLength = this->m_defaultStaticArrLength;
+    if (this->m_length != this->m_staticArrLength)
+    {
+        this->m_staticArrLength = this->m_length;
+        this->reallocStaticArr();
+    }
+}
+
 /* sets value given index */
-template <class T>
-void DynamicArray<T>::set(const unsigned int& ind, const T& value)
+template <class T, class G>
+void DynamicArray<T, G>::set(const unsigned int& ind, const T& value)
 {
     assert(ind < this->m_length); // check index does not exceed dynamic array length
     this->m_staticArr[ind] = value;
 }
 
+/* sets value given index by moving it into place */
+template <class T, class G>
+void DynamicArray<T, G>::set(const unsigned int& ind, T&& value)
+{
+    assert(ind < this->m_length);
+    this->m_staticArr[ind] = std::move(value);
+}
+
 /* appends array with new element of given value to the end */
-template <class T>
-void DynamicArray<T>::append(const T& value)
+template <class T, class G>
+void DynamicArray<T, G>::append(const T& value)
+{
+    this->emplaceBack(value);
+}
+
+/* appends array by moving new element to the end */
+template <class T, class G>
+void DynamicArray<T, G>::append(T&& value)
+{
+    this->emplaceBack(std::move(value));
+}
+
+/* constructs new element at the end of the array from the given ctor args
+    - when the stat array must grow, the new element is constructed before the old elements are relocated, as args may refer to an element of this array
+*/
+template <class T, class G>
+template <class... Args>
+T& DynamicArray<T, G>::emplaceBack(Args&&... args)
 {
     if (this->m_length + 1 > this->m_staticArrLength) // check if stat array needs to be made bigger
     {
-        this->m_staticArrLength *= 2;
-        this->reallocStaticArr(); // double the stat array size
+        unsigned int newStaticArrLength = this->grownStaticArrLength(this->m_length + 1);
+        T* tmp = detail::allocateStorage<T>(newStaticArrLength);
+        ::new (static_cast<void*>(tmp + this->m_length)) T(std::forward<Args>(args)...);
+        detail::relocate(tmp, this->m_staticArr, this->m_length); // move old elements across
+        detail::deallocateStorage(this->m_staticArr);
+        this->m_staticArr = tmp;
+        this->m_staticArrLength = newStaticArrLength;
+    }
+    else
+    {
+        ::new (static_cast<void*>(this->m_staticArr + this->m_length)) T(std::forward<Args>(args)...);
     }
-    this->m_length++; // increase length of dynamic array and add value
-    this->m_staticArr[this->m_length - 1] = value;
+    this->m_length++;
+    return this->m_staticArr[this->m_length - 1];
 }
 
 /* inserts an element given index into array */
-template <class T>
-void DynamicArray<T>::insert(const unsigned int& ind, const T& val)
+template <class T, class G>
+void DynamicArray<T, G>::insert(const unsigned int& ind, const T& val)
+{
+    this->insert(ind, T(val)); // take copy first as val may be an element that is about to be shifted
+}
+
+/* inserts an element given index into array by moving it into place */
+template <class T, class G>
+void DynamicArray<T, G>::insert(const unsigned int& ind, T&& val)
 {
     assert(ind <= this->m_length);
     if (this->m_length + 1 > this->m_staticArrLength) // check if stat array needs to be made bigger
     {
-        this->m_staticArrLength *= 2;
-        this->reallocStaticArr(); // double the stat array size
+        this->m_staticArrLength = this->grownStaticArrLength(this->m_length + 1);
+        this->reallocStaticArr(); // grow the stat array
     }
-    for (unsigned int i = ind; i < this->m_length; ++i)
-    {
-        this->m_staticArr[i + 1] = this->m_staticArr[i]; // shift values after and including position ind to the right
-    }
-    this->m_staticArr[ind] = val; // set value
+    detail::relocate(this->m_staticArr + ind + 1, this->m_staticArr + ind, this->m_length - ind); // shift values after and including position ind to the right
+    ::new (static_cast<void*>(this->m_staticArr + ind)) T(std::move(val)); // construct value in the vacated slot
     this->m_length++;
 }
 
-/* removes an element given index from array */
-template <class T>
-void DynamicArray<T>::remove(const unsigned int& ind)
+/* inserts n values at given index
+    - elements right of ind are shifted once by n places and the stat array is reallocated at most once
+    - vals may point into this array, in which case they are copied out before shifting
+*/
+template <class T, class G>
+void DynamicArray<T, G>::insertRange(const unsigned int& ind, const T* vals, const unsigned int& n)
 {
-    assert(ind < this->m_length); // check index does not exceed dynamic array length
-    for (unsigned int i = ind + 1; i < this->m_length; ++i) 
+    assert(ind <= this->m_length);
+    if (n == 0)
+        return;
+    if ((vals + n > this->m_staticArr) && (vals < this->m_staticArr + this->m_length))
     {
-        this->m_staticArr[i - 1] = this->m_staticArr[i]; // shift RH values to left by one, thereby removing target value
+        DynamicArray<T, G> tmp(n); // vals alias this array - take a copy before anything moves
+        tmp.appendRange(vals, n);
+        this->insertRange(ind, tmp.m_staticArr, n);
+        return;
     }
-    this->m_staticArr[this->m_length - 1] = 0; // set end value to be nil and reduce length
-    this->m_length--;
-
-    // check if array can be downsized -> length <= arrSize / 2
-    // only if arraySize is greater than defaultArrSize
-    if ((this->m_length <= this->m_staticArrLength / 2) && (this->m_staticArrLength > this->m_defaultStaticArrLength))
+    if (this->m_length + n > this->m_staticArrLength) // grow straight to the final size
     {
-        this->m_staticArrLength /= 2;
+        this->m_staticArrLength = this->grownStaticArrLength(this->m_length + n);
         this->reallocStaticArr();
     }
+    detail::relocate(this->m_staticArr + ind + n, this->m_staticArr + ind, this->m_length - ind); // shift values after and including position ind right by n
+    detail::copyConstruct(this->m_staticArr + ind, vals, n);
+    this->m_length += n;
 }
 
-/* remove any elements in array that have a given value */
-template <class T>
-void DynamicArray<T>::removeVal(const T& val)
+/* inserts contents of another array at given index */
+template <class T, class G>
+void DynamicArray<T, G>::insertRange(const unsigned int& ind, const DynamicArray<T, G>& arr)
+{
+    this->insertRange(ind, arr.m_staticArr, arr.m_length);
+}
+
+/* appends n values to the end of the array */
+template <class T, class G>
+void DynamicArray<T, G>::appendRange(const T* vals, const unsigned int& n)
+{
+    this->insertRange(this->m_length, vals, n);
+}
+
+/* appends contents of another array to the end of this array */
+template <class T, class G>
+void DynamicArray<T, G>::appendRange(const DynamicArray<T, G>& arr)
+{
+    this->insertRange(this->m_length, arr.m_staticArr, arr.m_length);
+}
+
+/* removes an element given index from array */
+template <class T, class G>
+void DynamicArray<T, G>::remove(const unsigned int& ind)
+{
+    assert(ind < this->m_length); // check index does not exceed dynamic array length
+    this->m_staticArr[ind].~T();
+    detail::relocate(this->m_staticArr + ind, this->m_staticArr + ind + 1, this->m_length - ind - 1); // shift RH values to left by one, thereby removing target value
+    this->m_length--;
+
+    this->shrinkIfSparse();
+}
+
+/* removes all elements in [first, last) with one shift of the elements to the right of the range */
+template <class T, class G>
+void DynamicArray<T, G>::removeRange(const unsigned int& first, const unsigned int& last)
+{
+    assert((first <= last) && (last <= this->m_length));
+    detail::destroyRange(this->m_staticArr + first, last - first);
+    detail::relocate(this->m_staticArr + first, this->m_staticArr + last, this->m_length - last); // shift RH values left over the removed range
+    this->m_length -= last - first;
+    this->shrinkIfSparse();
+}
+
+/* removes all elements for which pred returns true
+    - kept elements are compacted to the left in a single pass, preserving their order
+*/
+template <class T, class G>
+template <class Pred>
+unsigned int DynamicArray<T, G>::removeIf(Pred pred)
 {
     unsigned int found = 0;
-    unsigned int initLength = this->m_length;
-    for (unsigned int i = 0; i < initLength; ++i)
+    for (unsigned int i = 0; i < this->m_length; ++i)
     {
-        if (found > 0)
-            this->m_staticArr[i - found] = this->m_staticArr[i];
-        if (this->m_staticArr[i] == val)
+        if (pred(this->m_staticArr[i]))
         {
+            this->m_staticArr[i].~T();
             found++;
-            this->m_length--;
+        }
+        else if (found > 0)
+        {
+            detail::relocate(this->m_staticArr + i - found, this->m_staticArr + i, 1); // compact kept elements to the left
         }
     }
+    this->m_length -= found;
+    this->shrinkIfSparse();
+    return found;
+}
 
-    // check if array can be downsized -> length <= arrSize / 2
-    // only if arraySize is greater than defaultArrSize
-    if ((this->m_length <= this->m_staticArrLength / 2) && (this->m_staticArrLength > this->m_defaultStaticArrLength))
+/* remove any elements in array that have a given value */
+template <class T, class G>
+void DynamicArray<T, G>::removeVal(const T& val)
+{
+    if constexpr (simd::isSearchable<T>::value)
     {
-        this->m_staticArrLength /= 2;
-        this->reallocStaticArr();
+        this->m_length = simd::removeAll(this->m_staticArr, this->m_length, val); // trivially destructible, so dropped elements need no dtor
+        this->shrinkIfSparse();
+    }
+    else
+    {
+        this->removeIf([&val](const T& elem) { return elem == val; });
     }
 }
 
 /* clears the whole array */
-template <class T>
-void DynamicArray<T>::clear()
+template <class T, class G>
+void DynamicArray<T, G>::clear()
 {
-    delete[] this->m_staticArr;
-    this->m_staticArrLength = this->m_defaultStaticArrLength; // reset dynamic array length to default length
-    this->m_staticArr = new T[this->m_staticArrLength];
+    detail::destroyRange(this->m_staticArr, this->m_length);
+    detail::deallocateStorage(this->m_staticArr);
+    this->m_staticArrLength = this->m_minStaticArrLength; // reset dynamic array length to default length, or the reserved length
+    this->m_staticArr = detail::allocateStorage<T>(this->m_staticArrLength);
     this->m_length = 0;
 }
 
 /* returns dynamic array containing indexes of all elements with given value */
-template <class T>
-DynamicArray<unsigned int> DynamicArray<T>::valIndArr(const T& value) const
+template <class T, class G>
+DynamicArray<unsigned int> DynamicArray<T, G>::valIndArr(const T& value) const
 {
     DynamicArray<unsigned int> indArr; // create dynamic array to store indexes
+    if constexpr (simd::isSearchable<T>::value)
+    {
+        // scan in blocks so matching indexes can be written out to a fixed buffer and appended in bulk
+        const unsigned int blockLength = 1024;
+        unsigned int buffer[blockLength];
+        for (unsigned int i = 0; i < this->m_length; i += blockLength)
+        {
+            unsigned int n = (this->m_length - i < blockLength) ? this->m_length - i : blockLength;
+            unsigned int found = simd::findAll(this->m_staticArr + i, n, value, buffer, i);
+            indArr.appendRange(buffer, found);
+        }
+        return indArr;
+    }
     for (unsigned int i = 0; i < this->m_length; ++i)
     {
         if (this->m_staticArr[i] == value)
@@ -206,9 +562,13 @@ DynamicArray<unsigned int> DynamicArray<T>::valIndArr(const T& value) const
 }
 
 /* O(n) scan through array returning true if value present */
-template <class T>
-bool DynamicArray<T>::contains(const T& value) const
+template <class T, class G>
+bool DynamicArray<T, G>::contains(const T& value) const
 {
+    if constexpr (simd::isSearchable<T>::value)
+    {
+        return simd::findFirst(this->m_staticArr, this->m_length, value) < this->m_length;
+    }
     for (unsigned int i = 0; i < this->m_length; ++i)
     {
         if (this->m_staticArr[i] == value)
@@ -220,8 +580,8 @@ bool DynamicArray<T>::contains(const T& value) const
 }
 
 /* prints dynamic array */
-template <class T>
-void DynamicArray<T>::print()
+template <class T, class G>
+void DynamicArray<T, G>::print()
 {
     for (unsigned int i = 0; i < this->m_length; ++i)
     {
@@ -230,16 +590,35 @@ void DynamicArray<T>::print()
 }
 
 /* used to reallocate to array when the array size has grown or shrunk */
-template <class T>
-void DynamicArray<T>::reallocStaticArr()
+template <class T, class G>
+void DynamicArray<T, G>::reallocStaticArr()
 {
-    T* tmp = new T[this->m_staticArrLength]; // create temp stat array
-    for (unsigned int i = 0; i < this->m_length; ++i)
+    assert(this->m_staticArrLength >= this->m_length);
+    T* tmp = detail::allocateStorage<T>(this->m_staticArrLength); // create temp stat array
+    detail::relocate(tmp, this->m_staticArr, this->m_length); // move values - source slots are left uninitialised
+    detail::deallocateStorage(this->m_staticArr); // free old stat array then set it to temp stat array
+    this->m_staticArr = tmp;
+}
+
+/* returns stat array length after growing enough times to hold required elements */
+template <class T, class G>
+unsigned int DynamicArray<T, G>::grownStaticArrLength(const unsigned int& required) const
+{
+    return G::grow(this->m_staticArrLength, required);
+}
+
+/* check if array can be downsized, as set by the growth policy
+    - bulk removals may free several halvings worth of space, so the new size is found first and reallocated once
+*/
+template <class T, class G>
+void DynamicArray<T, G>::shrinkIfSparse()
+{
+    unsigned int newLength = G::shrink(this->m_staticArrLength, this->m_length, this->m_minStaticArrLength);
+    if (newLength != this->m_staticArrLength)
     {
-        tmp[i] = this->m_staticArr[i]; // copy values
+        this->m_staticArrLength = newLength;
+        this->reallocStaticArr();
     }
-    delete[] this->m_staticArr; // clear contents of stat array then set it to temp stat array
-    this->m_staticArr = tmp;
 }
 
 } // namespace datastructlib
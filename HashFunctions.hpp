@@ -0,0 +1,420 @@
+/* Hash functions - by W Denny
+    - fast, well-mixed 64-bit hashes, used as the default hashing of the hash tables
+    - integers: Fibonacci hashing - multiply by 2^64/phi to 128 bits and xor the high half into the low half, so low bits depend on the whole key
+    - strings and byte spans: wyhash-style - input words are xored with secret constants, multiplied 64x64->128 bits, and the two halves folded
+    - inputs over 48 bytes are read 48 bytes at a time into three independent lanes, so the multiplies overlap instead of forming one chain
+    - inputs of bulkHashLength bytes or more first run an accumulate loop over 64 byte stripes - AVX2 if the cpu supports it, else SSE2 or scalar
+    - every version of the stripe loop computes the same result, so hashes never depend on the target
+    - hashCombine folds two hashes into one (order matters); Hasher<std::pair> and Hasher<std::tuple> use it over their elements
+    - Hasher<T> returns a full size_t hash like std::hash; MaskedHash<T> turns it into an index for a power-of-two length with a mask instead of a modulo
+    - string hashers are transparent (is_transparent), so tables with std::equal_to<> can be searched by std::string_view without building a std::string
+    - hashes are for hash tables, not for security - they are not designed to resist deliberately colliding keys
+*/
+#pragma once
+
+#include "SimdSearch.hpp"
+#include <assert.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace datastructlib
+{
+
+constexpr size_t bulkHashLength = 1024; // inputs of at least this many bytes use the stripe accumulate loop
+
+namespace detail
+{
+
+constexpr uint64_t hashSecret[4] = {0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull};
+alignas(16) constexpr uint64_t hashStripeSecret[8] = {0x1cad21f72c81017cull, 0xbe4ba423396cfeb8ull, 0xdb979083e96dd4deull, 0x7c01812cf721ad1cull,
+    0x1f67b3b7a4a44072ull, 0x78e5c0cc4ee679cbull, 0x2172ffcc7dd05a82ull, 0x8e2443f7744608b8ull};
+
+/* multiplies a by b in place, leaving the low half of the product in a and the high half in b */
+inline void mumPair(uint64_t& a, uint64_t& b)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t product = static_cast<__uint128_t>(a) * b;
+    a = static_cast<uint64_t>(product);
+    b = static_cast<uint64_t>(product >> 64);
+#else
+    uint64_t aLo = a & 0xFFFFFFFF, aHi = a >> 32, bLo = b & 0xFFFFFFFF, bHi = b >> 32;
+    uint64_t lo = aLo * bLo, mid1 = aHi * bLo, mid2 = aLo * bHi, hi = aHi * bHi;
+    uint64_t carry = ((lo >> 32) + (mid1 & 0xFFFFFFFF) + (mid2 & 0xFFFFFFFF)) >> 32;
+    a = lo + (mid1 << 32) + (mid2 << 32);
+    b = hi + (mid1 >> 32) + (mid2 >> 32) + carry;
+#endif
+}
+
+/* multiplies two 64-bit words and xors the high and low halves of the 128-bit product */
+inline uint64_t mum(uint64_t a, uint64_t b)
+{
+    mumPair(a, b);
+    return a ^ b;
+}
+
+/* unaligned reads in native byte order - memcpy compiles to a single load */
+inline uint64_t read64(const unsigned char* p)
+{
+    uint64_t val;
+    std::memcpy(&val, p, sizeof(val));
+    return val;
+}
+
+inline uint64_t read32(const unsigned char* p)
+{
+    uint32_t val;
+    std::memcpy(&val, p, sizeof(val));
+    return val;
+}
+
+/* reads 1 to 3 bytes: first, middle and last, which cover every byte for these lengths */
+inline uint64_t read3(const unsigned char* p, const size_t& len)
+{
+    return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[len >> 1]) << 8) | p[len - 1];
+}
+
+/* accumulates 64 byte stripes into 8 lanes: lane i adds lo32 * hi32 of (word i xor secret i), its neighbour lane adds word i itself */
+inline void hashStripesScalar(uint64_t* acc, const unsigned char* p, const size_t& numStripes)
+{
+    for (size_t s = 0; s < numStripes; ++s, p += 64)
+    {
+        for (unsigned int i = 0; i < 8; ++i)
+        {
+            uint64_t word = read64(p + 8 * i);
+            uint64_t keyed = word ^ hashStripeSecret[i];
+            acc[i ^ 1] += word;
+            acc[i] += (keyed & 0xFFFFFFFF) * (keyed >> 32);
+        }
+    }
+}
+
+#ifdef DATASTRUCTLIB_SIMD_X86
+/* SSE2 version - two lanes per register, mul_epu32 multiplies the low 32 bits of each 64-bit lane */
+inline void hashStripesSse2(uint64_t* acc, const unsigned char* p, const size_t& numStripes)
+{
+    __m128i lanes[4];
+    for (unsigned int j = 0; j < 4; ++j)
+    {
+        lanes[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + 2 * j));
+    }
+    for (size_t s = 0; s < numStripes; ++s, p += 64)
+    {
+        for (unsigned int j = 0; j < 4; ++j)
+        {
+            __m128i word = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * j));
+            __m128i keyed = _mm_xor_si128(word, _mm_load_si128(reinterpret_cast<const __m128i*>(hashStripeSecret + 2 * j)));
+            __m128i product = _mm_mul_epu32(keyed, _mm_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1))); // lo32 * hi32 of each lane
+            lanes[j] = _mm_add_epi64(lanes[j], _mm_shuffle_epi32(word, _MM_SHUFFLE(1, 0, 3, 2))); // words swapped into the neighbour lane
+            lanes[j] = _mm_add_epi64(lanes[j], product);
+        }
+    }
+    for (unsigned int j = 0; j < 4; ++j)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + 2 * j), lanes[j]);
+    }
+}
+
+/* AVX2 version - four lanes per register, same arithmetic as the SSE2 version */
+DATASTRUCTLIB_TARGET_AVX2 inline void hashStripesAvx2(uint64_t* acc, const unsigned char* p, const size_t& numStripes)
+{
+    __m256i lanes[2];
+    for (unsigned int j = 0; j < 2; ++j)
+    {
+        lanes[j] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + 4 * j));
+    }
+    for (size_t s = 0; s < numStripes; ++s, p += 64)
+    {
+        for (unsigned int j = 0; j < 2; ++j)
+        {
+            __m256i word = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32 * j));
+            __m256i keyed = _mm256_xor_si256(word, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hashStripeSecret + 4 * j)));
+            __m256i product = _mm256_mul_epu32(keyed, _mm256_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1)));
+            lanes[j] = _mm256_add_epi64(lanes[j], _mm256_shuffle_epi32(word, _MM_SHUFFLE(1, 0, 3, 2)));
+            lanes[j] = _mm256_add_epi64(lanes[j], product);
+        }
+    }
+    for (unsigned int j = 0; j < 2; ++j)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + 4 * j), lanes[j]);
+    }
+}
+#endif
+
+/* picks the widest stripe loop the cpu supports */
+inline void hashStripes(uint64_t* acc, const unsigned char* p, const size_t& numStripes)
+{
+#ifdef DATASTRUCTLIB_SIMD_X86
+    if (simd::detail::hasAvx2())
+        hashStripesAvx2(acc, p, numStripes);
+    else
+        hashStripesSse2(acc, p, numStripes);
+#else
+    hashStripesScalar(acc, p, numStripes);
+#endif
+}
+
+/* member detection for the hash policy traits below */
+template <class H, class = void>
+struct hashPowerOfTwoLength : std::false_type
+{
+};
+
+template <class H>
+struct hashPowerOfTwoLength<H, std::void_t<decltype(H::powerOfTwoLength)>> : std::integral_constant<bool, H::powerOfTwoLength>
+{
+};
+
+template <class H, class = void>
+struct hashIsAvalanching : std::false_type
+{
+};
+
+template <class H>
+struct hashIsAvalanching<H, std::void_t<decltype(H::isAvalanching)>> : std::integral_constant<bool, H::isAvalanching>
+{
+};
+
+template <class F, class = void>
+struct isTransparent : std::false_type
+{
+};
+
+template <class F>
+struct isTransparent<F, std::void_t<typename F::is_transparent>> : std::true_type
+{
+};
+
+/* passes is_transparent on from a wrapped policy - base class of policies that forward keys to another */
+template <class F, class = void>
+struct transparentTag
+{
+};
+
+template <class F>
+struct transparentTag<F, std::void_t<typename F::is_transparent>>
+{
+    using is_transparent = void;
+};
+
+} // namespace detail
+
+/* true if an index hash policy requires power-of-two table lengths (declares powerOfTwoLength) - tables round their lengths up to suit */
+template <class H>
+constexpr bool hashUsesPowerOfTwoLength = detail::hashPowerOfTwoLength<H>::value;
+
+/* true if a full hash policy already mixes its output well (declares isAvalanching) - tables then skip their own mixing step
+    - full hash policies return a whole size_t hash (std::hash style) rather than an index; HashTable_Swiss, HashTable_Cuckoo and BlockedBloomFilter take them
+    - the hash of a policy that doesn't avalanche (e.g. std::hash, the identity for integers) is mixed with hashInteger before its bits are used
+*/
+template <class H>
+constexpr bool hashIsAvalanching = detail::hashIsAvalanching<H>::value;
+
+/* true if a table with these policies can be searched by a key of type K other than its key type T - both policies must declare
+   is_transparent (std::equal_to<> does, Hasher does for string types), so that K is hashed and compared without building a T
+*/
+template <class Hash, class KeyEqual, class T, class K>
+constexpr bool isTransparentLookup = detail::isTransparent<Hash>::value && detail::isTransparent<KeyEqual>::value && !std::is_same<K, T>::value;
+
+/* hashes an integer key */
+inline uint64_t hashInteger(const uint64_t& key)
+{
+    return detail::mum(key, 0x9E3779B97F4A7C15ull);
+}
+
+/* hashes len bytes starting at data */
+inline uint64_t hashBytes(const void* data, const size_t& len, uint64_t seed = 0)
+{
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    seed ^= detail::mum(seed ^ detail::hashSecret[0], detail::hashSecret[1]);
+    uint64_t a, b;
+    if (len <= 16)
+    {
+        if (len >= 4)
+        {
+            // two overlapping pairs of 4 byte reads cover every byte of 4 to 16 byte inputs
+            size_t mid = (len >> 3) << 2;
+            a = (detail::read32(p) << 32) | detail::read32(p + mid);
+            b = (detail::read32(p + len - 4) << 32) | detail::read32(p + len - 4 - mid);
+        }
+        else if (len > 0)
+        {
+            a = detail::read3(p, len);
+            b = 0;
+        }
+        else
+        {
+            a = b = 0;
+        }
+    }
+    else
+    {
+        size_t remaining = len;
+        if (len >= bulkHashLength)
+        {
+            uint64_t acc[8];
+            for (unsigned int i = 0; i < 8; ++i)
+            {
+                acc[i] = detail::hashStripeSecret[i] ^ seed;
+            }
+            size_t numStripes = len / 64;
+            detail::hashStripes(acc, p, numStripes);
+            for (unsigned int i = 0; i < 8; i += 2)
+            {
+                seed = detail::mum(acc[i] ^ detail::hashSecret[1], acc[i + 1] ^ seed);
+            }
+            p += numStripes * 64;
+            remaining -= numStripes * 64;
+        }
+        if (remaining > 48)
+        {
+            uint64_t seed1 = seed, seed2 = seed; // three independent lanes
+            do
+            {
+                seed = detail::mum(detail::read64(p) ^ detail::hashSecret[1], detail::read64(p + 8) ^ seed);
+                seed1 = detail::mum(detail::read64(p + 16) ^ detail::hashSecret[2], detail::read64(p + 24) ^ seed1);
+                seed2 = detail::mum(detail::read64(p + 32) ^ detail::hashSecret[3], detail::read64(p + 40) ^ seed2);
+                p += 48;
+                remaining -= 48;
+            } while (remaining > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (remaining > 16)
+        {
+            seed = detail::mum(detail::read64(p) ^ detail::hashSecret[1], detail::read64(p + 8) ^ seed);
+            p += 16;
+            remaining -= 16;
+        }
+        // last 16 bytes of the input - may overlap bytes already read, len > 16 keeps the reads in bounds
+        a = detail::read64(p + remaining - 16);
+        b = detail::read64(p + remaining - 8);
+    }
+    a ^= detail::hashSecret[1];
+    b ^= seed;
+    detail::mumPair(a, b);
+    return detail::mum(a ^ detail::hashSecret[0] ^ len, b ^ detail::hashSecret[1]);
+}
+
+/* combines hash of a further value into seed - not symmetric, so (a, b) and (b, a) hash differently */
+inline uint64_t hashCombine(const uint64_t& seed, const uint64_t& hash)
+{
+    return detail::mum(seed ^ detail::hashSecret[0], hash ^ detail::hashSecret[2]);
+}
+
+/* full hash policy (std::hash style) - integers, enums and pointers use hashInteger, strings use hashBytes, pairs and tuples combine
+    - any other type falls back to std::hash, mixed by hashInteger as std::hash is often the identity
+*/
+template <class T, class Enable = void>
+class Hasher
+{
+public:
+    static constexpr bool isAvalanching = true;
+    size_t operator()(const T& key) const
+    {
+        return static_cast<size_t>(hashInteger(static_cast<uint64_t>(std::hash<T>()(key))));
+    }
+};
+
+template <class T>
+class Hasher<T, typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type>
+{
+public:
+    static constexpr bool isAvalanching = true;
+    size_t operator()(const T& key) const
+    {
+        return static_cast<size_t>(hashInteger(static_cast<uint64_t>(key)));
+    }
+};
+
+template <class T>
+class Hasher<T*>
+{
+public:
+    static constexpr bool isAvalanching = true;
+    size_t operator()(T* key) const
+    {
+        return static_cast<size_t>(hashInteger(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(key))));
+    }
+};
+
+/* string hashes are transparent - std::string, std::string_view and const char* all hash through std::string_view, so equal text hashes equal */
+template <>
+class Hasher<std::string_view>
+{
+public:
+    static constexpr bool isAvalanching = true;
+    using is_transparent = void;
+    size_t operator()(const std::string_view& key) const
+    {
+        return static_cast<size_t>(hashBytes(key.data(), key.size()));
+    }
+};
+
+template <>
+class Hasher<std::string> : public Hasher<std::string_view>
+{
+};
+
+template <class A, class B>
+class Hasher<std::pair<A, B>>
+{
+public:
+    static constexpr bool isAvalanching = true;
+    size_t operator()(const std::pair<A, B>& key) const
+    {
+        return static_cast<size_t>(hashCombine(Hasher<A>()(key.first), Hasher<B>()(key.second)));
+    }
+};
+
+template <class... Ts>
+class Hasher<std::tuple<Ts...>>
+{
+public:
+    static constexpr bool isAvalanching = true;
+    size_t operator()(const std::tuple<Ts...>& key) const
+    {
+        return std::apply([](const Ts&... elems) {
+            uint64_t hash = 0;
+            ((hash = hashCombine(hash, Hasher<Ts>()(elems))), ...);
+            return static_cast<size_t>(hash);
+        }, key);
+    }
+};
+
+/* index hash policy for the HashTable classes - masks a full hash down to an index, so table lengths must be powers of two
+    - the tables round their lengths up to a power of two when given this policy, and replace the modulo in probing with a mask
+*/
+template <class T, class H = Hasher<T>>
+class MaskedHash : public detail::transparentTag<H>
+{
+private:
+    H m_hash;
+public:
+    static constexpr bool powerOfTwoLength = true;
+    MaskedHash(const H& hash = H()) : m_hash(hash) {}
+    template <class K> // any key type H accepts - T, or e.g. std::string_view when H is transparent
+    unsigned int operator()(const K& key, const unsigned int& arrLength) const
+    {
+        assert((arrLength & (arrLength - 1)) == 0);
+        return static_cast<unsigned int>(this->m_hash(key)) & (arrLength - 1);
+    }
+};
+
+/* rounds length up to a power of two (at least 1) */
+inline unsigned int roundUpPowerOfTwo(const unsigned int& length)
+{
+    unsigned int rounded = 1;
+    while (rounded < length)
+    {
+        rounded <<= 1;
+    }
+    return rounded;
+}
+
+}; // namespace datastructlib
@@ -1,15 +1,27 @@
 /* Hash table - W Denny
     - uses functors for hashing function and probing function
+    - hashing, key equality and probing are template policies resolved at compile time; the defaults adapt HashFunctor/ProbeFunctor ptrs
+    - MaskedHash<T> (HashFunctions.hpp) hashes with Hasher<T> and masks instead of taking a modulo; tables given it keep power-of-two lengths and mask probe indices too
+    - a Stats policy can collect probe-length histograms and counters behind stats(); the default NullStats compiles to nothing
+    - open-addressing and seperate-chaining take a Filter policy consulted before probing, e.g. BlockedBloomFilter (BloomFilter.hpp), so most misses cost one cache line
     - supports seperate-chaining and open-addressing collision resolution methods
     - seperate-chaining is flexible for different data structure objects by means of an interface class object
-    - this interface class object must be defined for a given datatype - currently defined for own-made DynamicArray and SinglyLinkedList data structure classes
+    - this interface class object must be defined for a given datatype - currently defined for own-made DynamicArray, SmallDynamicArray and SinglyLinkedList data structure classes
     - upon creating seperate-chaining object you pass the interface derived class for the required data type
+    - seperate-chaining key-value pairs (and singly-linked list chain nodes) come from slab allocators with free lists, not one new per insert; arenaUsage() reports their memory
+    - flat open-addressing stores key-value pairs and slot state inline in one array instead of ptrs to heap allocated pairs
+    - robin hood open-addressing keeps probe lengths even and deletes by backward shift, so churn leaves no tombstones
 */
 #pragma once
 
 #include "DynamicArray.hpp"
+#include "SmallDynamicArray.hpp"
 #include "SinglyLinkedList.hpp"
+#include "HashFunctions.hpp"
+#include "SlabAllocator.hpp"
 #include <assert.h>
+#include <chrono>
+#include <functional>
 
 namespace datastructlib
 {
@@ -41,6 +53,10 @@ public:
 /* Base Functor for probing sequence
     - takes input x - usually a natural number??
     - the probing function must be able to map onto every index in the array
+    - offset(x) gives the offset of probe step x (x >= 1) from the hashed index without touching any state, so lookups can run concurrently
+    - reset/increment step through the same offsets using the functor's own counter
+    - functors that only override reset/increment still work: the default offset replays reset and x increments on the functor,
+      which costs x calls per step and mutates the functor, so such a functor must not be const or shared between threads
 */
 
 class ProbeFunctor
@@ -58,6 +74,17 @@ public:
     {
         return 0;
     }
+    virtual unsigned int offset(const unsigned int& x, const unsigned int& arrLength) const
+    {
+        ProbeFunctor* stepper = const_cast<ProbeFunctor*>(this); // the stepping api is non-const
+        stepper->reset();
+        unsigned int stepOffset = 0;
+        for (unsigned int i = 0; i < x; ++i)
+        {
+            stepOffset = stepper->increment(arrLength);
+        }
+        return stepOffset;
+    }
 };
 
 /* Linear probing function */
@@ -84,7 +111,11 @@ public:
     {
         //assert(arrLength % m_a != 0); // ensure that a and array size are relatively prime
         this->m_x += 1;
-        return m_a*this->m_x + m_b;
+        return this->offset(this->m_x, arrLength);
+    }
+    unsigned int offset(const unsigned int& x, const unsigned int& arrLength) const
+    {
+        return this->m_a*x + this->m_b;
     }
 };
 
@@ -114,7 +145,82 @@ public:
     {
         //assert(arrLength % m_a != 0); // ensure that a and array size are relatively prime
         this->m_x += 1;
-        return m_a*this->m_x*this->m_x + m_b*this->m_x + this->m_c;
+        return this->offset(this->m_x, arrLength);
+    }
+    unsigned int offset(const unsigned int& x, const unsigned int& arrLength) const
+    {
+        return this->m_a*x*x + this->m_b*x + this->m_c;
+    }
+};
+
+/********************************************************************************************************************/
+/* HASH, KEY EQUALITY AND PROBE POLICIES */
+
+/* the hash tables take hashing, key equality and probing as template policies, so calls are resolved (and usually inlined) at compile time
+    - Hash: unsigned int operator()(const T& key, const unsigned int& arrLength) const - returns index into the array
+    - KeyEqual: bool operator()(const T& a, const T& b) const - defaults to std::equal_to<T>
+    - Probe: unsigned int operator()(const unsigned int& x, const unsigned int& arrLength) const - returns offset of probe step x (x >= 1) from the hashed index
+    - the default policies adapt the functor classes above, so tables can still be built from HashFunctor/ProbeFunctor ptrs
+*/
+
+/* adapts a HashFunctor ptr to the hash policy - implicitly constructible from the ptr, calls through the virtual operator() */
+template <class T>
+class HashFunctorAdapter
+{
+private:
+    HashFunctor<T>* m_hashFunctionPtr;
+public:
+    HashFunctorAdapter(HashFunctor<T>* hashFunctionPtr) : m_hashFunctionPtr(hashFunctionPtr) {}
+    unsigned int operator()(const T& key, const unsigned int& arrLength) const
+    {
+        return (*this->m_hashFunctionPtr)(key, arrLength);
+    }
+};
+
+/* adapts a ProbeFunctor ptr to the probe policy - uses offset, so the functor is never mutated unless it only overrides reset/increment */
+class ProbeFunctorAdapter
+{
+private:
+    const ProbeFunctor* m_probeFunctionPtr;
+public:
+    ProbeFunctorAdapter(const ProbeFunctor* probeFunctionPtr) : m_probeFunctionPtr(probeFunctionPtr) {}
+    unsigned int operator()(const unsigned int& x, const unsigned int& arrLength) const
+    {
+        return this->m_probeFunctionPtr->offset(x, arrLength);
+    }
+};
+
+/* hash policy using std::hash, reduced modulo the array length */
+template <class T>
+class StdHash
+{
+public:
+    unsigned int operator()(const T& key, const unsigned int& arrLength) const
+    {
+        return static_cast<unsigned int>(std::hash<T>()(key) % arrLength);
+    }
+};
+
+/* linear probing policy with compile-time coefficients - offset a*x + b */
+template <unsigned int A = 1, unsigned int B = 0>
+class LinearProbe
+{
+    static_assert(A > 0, "linear probe step must be non-zero");
+public:
+    unsigned int operator()(const unsigned int& x, const unsigned int& arrLength) const
+    {
+        return A*x + B;
+    }
+};
+
+/* quadratic probing policy with compile-time coefficients - offset a*x^2 + b*x + c */
+template <unsigned int A = 1, unsigned int B = 0, unsigned int C = 0>
+class QuadraticProbe
+{
+public:
+    unsigned int operator()(const unsigned int& x, const unsigned int& arrLength) const
+    {
+        return A*x*x + B*x + C;
     }
 };
 
@@ -153,16 +259,202 @@ public:
     KeyValPair<T, U>* m_kvpPtr; // ptr to the key value pair object
 };
 
+/********************************************************************************************************************/
+/* HASH TABLE STATISTICS */
+
+/* the hash tables take a Stats policy that is told about every lookup, insert, remove and resize
+    - NullStats (the default) has empty inline functions, so instrumented tables compile to the same code as uninstrumented ones
+    - HashTableStats counts hits/misses, keeps a histogram of probe lengths and times resizes; use it to tune load factors
+    - probe length is the number of slots (open addressing) or chain entries (separate chaining) examined by an operation
+    - only calls made by the user are counted - rehashing on resize records no inserts, and the probe inside remove records no lookup
+    - stats() also refreshes a snapshot of the table's shape: histogram of chain lengths (separate chaining) or of runs of
+      occupied slots (open addressing), and the fraction of slots holding tombstones
+    - record functions are const as lookups are const, so HashTableStats keeps its counters mutable
+*/
+
+/* stats policy that records nothing */
+class NullStats
+{
+public:
+    static constexpr bool enabled = false;
+    void recordLookup(const unsigned int& probeLength, const bool& hit) const {}
+    void recordInsert(const unsigned int& probeLength) const {}
+    void recordRemove() const {}
+    void beginResize() const {}
+    void endResize() const {}
+    void beginSnapshot() const {}
+    void recordChainLength(const unsigned int& length) const {}
+    void recordTombstones(const unsigned int& numTombstones, const unsigned int& numSlots) const {}
+};
+
+/* stats policy that collects counters and histograms - histogram bin i counts lengths of i, the last bin counts everything longer */
+class HashTableStats
+{
+public:
+    static constexpr bool enabled = true;
+    static constexpr unsigned int histogramLength = 32;
+
+    mutable unsigned long long m_hits = 0;
+    mutable unsigned long long m_misses = 0;
+    mutable unsigned long long m_inserts = 0;
+    mutable unsigned long long m_removes = 0;
+    mutable unsigned long long m_resizes = 0;
+    mutable double m_resizeSeconds = 0; // total time spent resizing
+    mutable unsigned long long m_probeLengths[histogramLength] = {}; // per lookup/insert
+    mutable unsigned long long m_chainLengths[histogramLength] = {}; // snapshot - per chain (separate chaining) or run of occupied slots (open addressing)
+    mutable double m_tombstoneRatio = 0; // snapshot - tombstones divided by number of slots
+
+    void recordLookup(const unsigned int& probeLength, const bool& hit) const
+    {
+        if (hit)
+            this->m_hits++;
+        else
+            this->m_misses++;
+        this->m_probeLengths[bin(probeLength)]++;
+    }
+    void recordInsert(const unsigned int& probeLength) const
+    {
+        this->m_inserts++;
+        this->m_probeLengths[bin(probeLength)]++;
+    }
+    void recordRemove() const
+    {
+        this->m_removes++;
+    }
+    void beginResize() const
+    {
+        this->m_resizeStart = std::chrono::steady_clock::now();
+    }
+    void endResize() const
+    {
+        this->m_resizes++;
+        this->m_resizeSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - this->m_resizeStart).count();
+    }
+    void beginSnapshot() const
+    {
+        for (unsigned int i = 0; i < histogramLength; ++i)
+        {
+            this->m_chainLengths[i] = 0;
+        }
+    }
+    void recordChainLength(const unsigned int& length) const
+    {
+        this->m_chainLengths[bin(length)]++;
+    }
+    void recordTombstones(const unsigned int& numTombstones, const unsigned int& numSlots) const
+    {
+        this->m_tombstoneRatio = (numSlots > 0) ? (double) numTombstones / (double) numSlots : 0;
+    }
+
+    /* returns mean probe length over all recorded lookups and inserts */
+    double averageProbeLength() const
+    {
+        unsigned long long count = 0, total = 0;
+        for (unsigned int i = 0; i < histogramLength; ++i)
+        {
+            count += this->m_probeLengths[i];
+            total += this->m_probeLengths[i] * i;
+        }
+        return (count > 0) ? (double) total / (double) count : 0;
+    }
+
+    /* clears counters and histograms */
+    void reset()
+    {
+        *this = HashTableStats();
+    }
+
+    void print() const
+    {
+        std::cout << "hits: " << this->m_hits << ", misses: " << this->m_misses << ", inserts: " << this->m_inserts << ", removes: " << this->m_removes << std::endl;
+        std::cout << "resizes: " << this->m_resizes << " (" << this->m_resizeSeconds << " s), tombstone ratio: " << this->m_tombstoneRatio << ", average probe length: " << this->averageProbeLength() << std::endl;
+        std::cout << "length \t probes \t chains" << std::endl;
+        for (unsigned int i = 0; i < histogramLength; ++i)
+        {
+            if ((this->m_probeLengths[i] != 0) || (this->m_chainLengths[i] != 0))
+                std::cout << i << ((i + 1 == histogramLength) ? "+" : "") << " \t " << this->m_probeLengths[i] << " \t\t " << this->m_chainLengths[i] << std::endl;
+        }
+    }
+
+private:
+    mutable std::chrono::steady_clock::time_point m_resizeStart;
+
+    static unsigned int bin(const unsigned int& length)
+    {
+        return (length < histogramLength) ? length : histogramLength - 1;
+    }
+};
+
+/********************************************************************************************************************/
+/* HASH TABLE FRONT FILTER */
+
+/* HashTable_OpenAddressing and HashTable_SeperateChaining take a Filter policy that approximates the set of keys
+    - find asks mayContain(key) first and returns not found straight away when it is false, recording a probe length of 0
+    - insert adds the key; keys are never taken out, so removed keys cost a wasted probe until the filter is next rebuilt
+    - when full() the table resets the filter to its current size and adds every live key again (open addressing also resets it on resizeArray)
+    - a filter only pays off when most lookups miss - a hit always checks the filter and then probes
+    - NullFilter (the default) is compiled out; BlockedBloomFilter<T> (BloomFilter.hpp) is a cache-line-blocked Bloom filter
+    - the filter passed to the ctor is copied, which sets the bits per key (the ctor then resizes it for the table)
+*/
+
+/* filter policy that filters nothing */
+class NullFilter
+{
+public:
+    static constexpr bool enabled = false;
+    template <class K>
+    bool mayContain(const K& key) const { return true; }
+    template <class K>
+    void add(const K& key) {}
+    void reset(const unsigned int& expectedKeys) {}
+    bool full() const { return false; }
+};
+
 /********************************************************************************************************************/
 /* HASH TABLE BASE CLASS */
 
-template <class T, class U>
-class HashTable 
+constexpr unsigned int hashTableBatchLength = 16; // keys hashed and prefetched ahead of resolving them in findBatch/insertBatch
+
+namespace detail
+{
+
+/* hints the cpu to start loading the cache line holding ptr - lets the misses of independent lookups overlap */
+inline void prefetch(const void* ptr)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(ptr);
+#endif
+}
+
+} // namespace detail
+
+template <class T, class U, class Hash = HashFunctorAdapter<T>, class KeyEqual = std::equal_to<T>, class Stats = NullStats>
+class HashTable : protected Stats // stats policy is a base so that NullStats takes no space
 {
 protected:
     unsigned int m_arrLength;
-    unsigned int m_numEntries;
-    HashFunctor<T>* m_hashFunctionPtr;
+    mutable unsigned int m_numEntries; // mutable as incremental resizes free tombstoned pairs while migrating, which const lookups also do
+    Hash m_hash;
+    KeyEqual m_keyEqual;
+    HashTable(const Hash& hash, const KeyEqual& keyEqual) : m_hash(hash), m_keyEqual(keyEqual) {}
+
+    /* rounds a requested length up to a power of two if the hash policy masks instead of taking a modulo (e.g. MaskedHash) */
+    static unsigned int roundLength(const unsigned int& length)
+    {
+        if constexpr (hashUsesPowerOfTwoLength<Hash>)
+            return roundUpPowerOfTwo(length);
+        else
+            return length;
+    }
+
+    /* wraps a probe index into an array of given length - a mask for power-of-two lengths, otherwise a modulo */
+    static unsigned int wrapIndex(const unsigned int& ind, const unsigned int& length)
+    {
+        if constexpr (hashUsesPowerOfTwoLength<Hash>)
+            return ind & (length - 1);
+        else
+            return ind % length;
+    }
 public:
     double loadFactor() const
     {
@@ -191,6 +483,8 @@ public:
         std::cout << "Error in data struct interface derivation" << std::endl;
         return 0;
     }
+    virtual void clear(T& ds) {} // releases memory the interface allocated for a chain - arrays own their storage so need nothing
+    virtual SlabUsage arenaUsage() const { return SlabUsage(); } // memory held in the interface's slab allocators
 };
 
 /* interface for dynamic array class */
@@ -217,10 +511,39 @@ public:
     }
 };
 
-/* interface for singly-linked list */
+/* interface for small dynamic array class
+    - chains of up to N entries are stored inline in the bucket array, so most buckets never allocate
+*/
+template <class T, class U, unsigned int N>
+class HashTable_SmallDynamicArrayInterface : virtual public HashTable_DataStructInterface< SmallDynamicArray<KeyValPair<T, U>*, N>, KeyValPair<T, U>* >
+{
+public:
+    KeyValPair<T, U>* get(const SmallDynamicArray<KeyValPair<T, U>*, N>& ds, const unsigned int& ind)
+    {
+        return ds.get(ind);
+    }
+    void append(SmallDynamicArray<KeyValPair<T, U>*, N>& ds, KeyValPair<T, U>* kvpPtr)
+    {
+        ds.append(kvpPtr);
+    }
+    void remove(SmallDynamicArray<KeyValPair<T, U>*, N>& ds, const unsigned int& ind)
+    {
+        ds.remove(ind);
+    }
+    unsigned int length(const SmallDynamicArray<KeyValPair<T, U>*, N>& ds)
+    {
+        return ds.length();
+    }
+};
+
+/* interface for singly-linked list
+    - nodes are taken from the interface's slab allocator and returned to it on remove/clear, so the interface must outlive the tables using it
+*/
 template <class T, class U>
 class HashTable_SinglyLinkedListInterface : virtual public HashTable_DataStructInterface< SinglyLinkedList<KeyValPair<T, U>*>, KeyValPair< T, U>* >
 {
+private:
+    SlabAllocator<SingleNode<KeyValPair<T, U>*>> m_nodeAllocator;
 public:
     
     KeyValPair<T, U>* get(const SinglyLinkedList<KeyValPair<T, U>*>& ds, const unsigned int& ind)
@@ -230,67 +553,142 @@ public:
     }
     void append(SinglyLinkedList<KeyValPair<T, U>*>& ds, KeyValPair<T, U>* kvpPtr)
     {
-        SingleNode<KeyValPair<T, U>*>* nodePtr = new SingleNode<KeyValPair<T, U>*>(kvpPtr);
+        SingleNode<KeyValPair<T, U>*>* nodePtr = this->m_nodeAllocator.allocate(kvpPtr);
         ds.insertTail(nodePtr);
     }
     void remove(SinglyLinkedList<KeyValPair<T, U>*>& ds, const unsigned int& ind)
     {
-        ds.remove(ind);
+        SingleNode<KeyValPair<T, U>*>* nodePtr = ds.getPtr(ind);
+        if (ind == 0) // list remove only handles interior nodes
+        {
+            ds.removeHead();
+        }
+        else if (ind == ds.length() - 1)
+        {
+            ds.removeTail();
+        }
+        else
+        {
+            ds.remove(ind);
+        }
+        this->m_nodeAllocator.deallocate(nodePtr);
     }
     unsigned int length(const SinglyLinkedList<KeyValPair<T, U>*>& ds)
     {
         return ds.length();
     }
+    void clear(SinglyLinkedList<KeyValPair<T, U>*>& ds)
+    {
+        while (ds.length() > 0)
+        {
+            SingleNode<KeyValPair<T, U>*>* nodePtr = ds.headPtr();
+            ds.removeHead();
+            this->m_nodeAllocator.deallocate(nodePtr);
+        }
+    }
+    SlabUsage arenaUsage() const
+    {
+        return this->m_nodeAllocator.usage();
+    }
 };
 
 /* Seperate chaining hash table 
 */
-template <class T, class U, class V>
-class HashTable_SeperateChaining : public HashTable<T, U>
+template <class T, class U, class V, class Hash = HashFunctorAdapter<T>, class KeyEqual = std::equal_to<T>, class Stats = NullStats, class Filter = NullFilter>
+class HashTable_SeperateChaining : public HashTable<T, U, Hash, KeyEqual, Stats>
 {
 private:
     V* m_data; // array of data structures of type V containing ptrs to key-value pairs
     HashTable_DataStructInterface<V, KeyValPair<T, U>*>* m_dataStructInterfacePtr; // interface for manipulating general data structure (as each type has different calling functions, they require individual interface)
+    SlabAllocator<KeyValPair<T, U>> m_kvpAllocator; // key-value pairs pointed to by the chains
+    Filter m_filter; // front filter of the keys in the chains
 public:
     HashTable_SeperateChaining() = delete;
-    HashTable_SeperateChaining(const unsigned int& length, HashTable_DataStructInterface<V, KeyValPair<T, U>*>* dataStructInterfacePtr, HashFunctor<T>* hashFunctionPtr);
+    HashTable_SeperateChaining(const unsigned int& length, HashTable_DataStructInterface<V, KeyValPair<T, U>*>* dataStructInterfacePtr, const Hash& hash, const KeyEqual& keyEqual = KeyEqual(), const Filter& filter = Filter());
     ~HashTable_SeperateChaining();
     HashTable_SearchResult<T, U> find(const T& key) const;
+    template <class K, class = typename std::enable_if<isTransparentLookup<Hash, KeyEqual, T, K>>::type>
+    HashTable_SearchResult<T, U> find(const K& key) const; // heterogeneous lookup, e.g. by std::string_view for std::string keys - needs transparent Hash and KeyEqual
     void insert(const T& key, const U& val);
     bool remove(const T& key);
     void display();
+    const Stats& stats() const; // refreshes the chain length histogram when Stats is enabled
+    SlabUsage arenaUsage() const; // key-value pair slabs plus any chain node slabs of the interface
+    const Filter& filter() const;
+private:
+    template <class K>
+    HashTable_SearchResult<T, U> findKey(const K& key, const bool& recordStats) const; // find for the key type and for transparent lookup types - remove passes false, so it isn't counted as a lookup
+    void rebuildFilter(); // resets the filter for twice the entries and adds every key again
 };
 
 /* ctor */
-template <class T, class U, class V>
-HashTable_SeperateChaining<T, U, V>::HashTable_SeperateChaining(const unsigned int& length, HashTable_DataStructInterface<V, KeyValPair<T, U>*>* dataStructInterfacePtr, HashFunctor<T>* hashFunctionPtr)
+template <class T, class U, class V, class Hash, class KeyEqual, class Stats, class Filter>
+HashTable_SeperateChaining<T, U, V, Hash, KeyEqual, Stats, Filter>::HashTable_SeperateChaining(const unsigned int& length, HashTable_DataStructInterface<V, KeyValPair<T, U>*>* dataStructInterfacePtr, const Hash& hash, const KeyEqual& keyEqual, const Filter& filter)
+    : HashTable<T, U, Hash, KeyEqual, Stats>(hash, keyEqual), m_filter(filter)
 {
-    this->m_arrLength = length;
-    this->m_data = new V[length]; // create array of data structures of type V containing ptrs to key-value pairs
-    this->m_hashFunctionPtr = hashFunctionPtr;
+    this->m_arrLength = this->roundLength(length);
+    this->m_data = new V[this->m_arrLength]; // create array of data structures of type V containing ptrs to key-value pairs
     this->m_dataStructInterfacePtr = dataStructInterfacePtr;
     this->m_numEntries = 0;
+    this->m_filter.reset(this->m_arrLength); // sized for one key per chain, rebuilt larger once full
 }
 
 /* dtor */
-template <class T, class U, class V>
-HashTable_SeperateChaining<T, U, V>::~HashTable_SeperateChaining()
+template <class T, class U, class V, class Hash, class KeyEqual, class Stats, class Filter>
+HashTable_SeperateChaining<T, U, V, Hash, KeyEqual, Stats, Filter>::~HashTable_SeperateChaining()
 {
-    // finish this function properly
+    for (unsigned int i = 0; i < this->m_arrLength; ++i)
+    {
+        unsigned int chainLength = this->m_dataStructInterfacePtr->length(this->m_data[i]);
+        for (unsigned int j = 0; j < chainLength; ++j)
+        {
+            this->m_kvpAllocator.deallocate(this->m_dataStructInterfacePtr->get(this->m_data[i], j));
+        }
+        this->m_dataStructInterfacePtr->clear(this->m_data[i]); // chain nodes, if the interface allocated any
+    }
     delete[] this->m_data;
 }
 
 /* returns the pointer to a key value pair given key */
-template <class T, class U, class V>
-HashTable_SearchResult<T, U> HashTable_SeperateChaining<T, U, V>::find(const T& key) const
+template <class T, class U, class V, class Hash, class KeyEqual, class Stats, class Filter>
+HashTable_SearchResult<T, U> HashTable_SeperateChaining<T, U, V, Hash, KeyEqual, Stats, Filter>::find(const T& key) const
+{
+    return this->findKey(key, true);
+}
+
+/* returns the pointer to a key value pair given a key of another type that hashes and compares equal to the stored key - no temporary key is built */
+template <class T, class U, class V, class Hash, class KeyEqual, class Stats, class Filter>
+template <class K, class>
+HashTable_SearchResult<T, U> HashTable_SeperateChaining<T, U, V, Hash, KeyEqual, Stats, Filter>::find(const K& key) const
+{
+    return this->findKey(key, true);
+}
+
+/* walks the key's chain */
+template <class T, class U, class V, class Hash, class KeyEqual, class Stats, class Filter>
+template <class K>
+HashTable_SearchResult<T, U> HashTable_SeperateChaining<T, U, V, Hash, KeyEqual, Stats, Filter>::findKey(const K& key, const bool& recordStats) const
 {  
-    unsigned int hashedKey = (*this->m_hashFunctionPtr)(key, this->m_arrLength);
-    for (unsigned int i = 0; i < this->m_dataStructInterfacePtr->length(this->m_data[hashedKey]); ++i) // traverse chain
+    if constexpr (Filter::enabled)
+    {
+        if (!this->m_filter.mayContain(key)) // never inserted - the chain is not touched
+        {
+            if (recordStats)
+                this->recordLookup(0, false);
+            HashTable_SearchResult<T, U> result;
+            result.m_kvpPtr = nullptr;
+            return result;
+        }
+    }
+    unsigned int hashedKey = this->m_hash(key, this->m_arrLength);
+    unsigned int chainLength = this->m_dataStructInterfacePtr->length(this->m_data[hashedKey]);
+    for (unsigned int i = 0; i < chainLength; ++i) // traverse chain
     {
-        if (this->m_dataStructInterfacePtr->get(this->m_data[hashedKey], i)->m_key == key)
+        if (this->m_keyEqual(this->m_dataStructInterfacePtr->get(this->m_data[hashedKey], i)->m_key, key))
         {
-            std::cout << "Found" << std::endl;
             // found
+            if (recordStats)
+                this->recordLookup(i + 1, true);
             HashTable_SearchResult<T, U> result;
             result.m_hashedKey = hashedKey;
             result.m_sepChainInd = i;
@@ -299,42 +697,51 @@ HashTable_SearchResult<T, U> HashTable_SeperateChaining<T, U, V>::find(const T&
         }
     }
     // not found
+    if (recordStats)
+        this->recordLookup(chainLength, false);
     HashTable_SearchResult<T, U> result;
     result.m_kvpPtr = nullptr;
     return result;
 }
 
 /* inserts new entry into hash table */
-template <class T, class U, class V>
-void HashTable_SeperateChaining<T, U, V>::insert(const T& key, const U& val)
+template <class T, class U, class V, class Hash, class KeyEqual, class Stats, class Filter>
+void HashTable_SeperateChaining<T, U, V, Hash, KeyEqual, Stats, Filter>::insert(const T& key, const U& val)
 {
-    unsigned int hashedKey = (*this->m_hashFunctionPtr)(key, this->m_arrLength);
-    std::cout << "Insertion : Key " << key << " maps onto index " << hashedKey << "\t";
-    std::cout << "Chain @ index " << hashedKey << " has " << this->m_dataStructInterfacePtr->length(this->m_data[hashedKey]) << " existing entry/entries" << std::endl;
-    KeyValPair<T, U>* kvpPtr = new KeyValPair<T, U>(key, val); // copies the key and value into new key-value pair object
+    unsigned int hashedKey = this->m_hash(key, this->m_arrLength);
+    this->recordInsert(this->m_dataStructInterfacePtr->length(this->m_data[hashedKey])); // appending walks past the existing chain
+    KeyValPair<T, U>* kvpPtr = this->m_kvpAllocator.allocate(key, val); // copies the key and value into a key-value pair from the slab
     this->m_dataStructInterfacePtr->append(this->m_data[hashedKey], kvpPtr); // use data structure interface to append onto the chain
     this->m_numEntries++;
+    if constexpr (Filter::enabled)
+    {
+        this->m_filter.add(key);
+        if (this->m_filter.full())
+            this->rebuildFilter();
+    }
 }
 
 /* remove entry from hash table by key */
-template <class T, class U, class V>
-bool HashTable_SeperateChaining<T, U, V>::remove(const T& key)
+template <class T, class U, class V, class Hash, class KeyEqual, class Stats, class Filter>
+bool HashTable_SeperateChaining<T, U, V, Hash, KeyEqual, Stats, Filter>::remove(const T& key)
 {
-    HashTable_SearchResult<T, U> result = this->find(key);
+    HashTable_SearchResult<T, U> result = this->findKey(key, false);
     if (result.m_kvpPtr == nullptr)
     {
         return false; // object not found inside hash table
     }
     this->m_dataStructInterfacePtr->remove(this->m_data[result.m_hashedKey], result.m_sepChainInd); // use data structure interface to remove from the chain
-    std::cout << "Removal : Key " << key << " and value pair removed from dynamic array @ index " << result.m_hashedKey << std::endl;
+    this->m_kvpAllocator.deallocate(result.m_kvpPtr); // cell goes on the free list for the next insert
     this->m_numEntries--;
+    this->recordRemove();
+    return true;
 }
 
 /* display 
     - note the value datatype must be defined for ostream operator
 */
-template <class T, class U, class V>
-void HashTable_SeperateChaining<T, U, V>::display()
+template <class T, class U, class V, class Hash, class KeyEqual, class Stats, class Filter>
+void HashTable_SeperateChaining<T, U, V, Hash, KeyEqual, Stats, Filter>::display()
 {
     std::cout << "======================" << std::endl;
     for (unsigned int i = 0; i < this->m_arrLength; ++i)
@@ -349,118 +756,261 @@ void HashTable_SeperateChaining<T, U, V>::display()
     std::cout << "======================" << std::endl;
 }
 
+/* returns the stats policy object - a snapshot of chain lengths is taken first if stats are enabled */
+template <class T, class U, class V, class Hash, class KeyEqual, class Stats, class Filter>
+const Stats& HashTable_SeperateChaining<T, U, V, Hash, KeyEqual, Stats, Filter>::stats() const
+{
+    if constexpr (Stats::enabled)
+    {
+        this->beginSnapshot();
+        for (unsigned int i = 0; i < this->m_arrLength; ++i)
+        {
+            this->recordChainLength(this->m_dataStructInterfacePtr->length(this->m_data[i]));
+        }
+        this->recordTombstones(0, this->m_arrLength);
+    }
+    return *this;
+}
+
+/* returns memory held in slab allocators - an interface shared between tables reports its nodes for all of them */
+template <class T, class U, class V, class Hash, class KeyEqual, class Stats, class Filter>
+SlabUsage HashTable_SeperateChaining<T, U, V, Hash, KeyEqual, Stats, Filter>::arenaUsage() const
+{
+    SlabUsage usage = this->m_kvpAllocator.usage();
+    usage += this->m_dataStructInterfacePtr->arenaUsage();
+    return usage;
+}
+
+/* returns the front filter */
+template <class T, class U, class V, class Hash, class KeyEqual, class Stats, class Filter>
+const Filter& HashTable_SeperateChaining<T, U, V, Hash, KeyEqual, Stats, Filter>::filter() const
+{
+    return this->m_filter;
+}
+
+/* resets the filter for twice the entries and adds every key again
+    - the chains never shrink the table, so the filter grows with the entries instead; doubling keeps rebuilds amortized O(1) per insert
+    - also drops the bits of removed keys
+*/
+template <class T, class U, class V, class Hash, class KeyEqual, class Stats, class Filter>
+void HashTable_SeperateChaining<T, U, V, Hash, KeyEqual, Stats, Filter>::rebuildFilter()
+{
+    this->m_filter.reset(2 * this->m_numEntries);
+    for (unsigned int i = 0; i < this->m_arrLength; ++i)
+    {
+        unsigned int chainLength = this->m_dataStructInterfacePtr->length(this->m_data[i]);
+        for (unsigned int j = 0; j < chainLength; ++j)
+        {
+            this->m_filter.add(this->m_dataStructInterfacePtr->get(this->m_data[i], j)->m_key);
+        }
+    }
+}
+
 /********************************************************************************************************************/
 /* HASH TABLE WITH OPEN ADDRESSING */
 
-template <class T, class U>
-class HashTable_OpenAddressing : public HashTable<T, U>
+template <class T, class U, class Hash = HashFunctorAdapter<T>, class Probe = ProbeFunctorAdapter, class KeyEqual = std::equal_to<T>, class Stats = NullStats, class Filter = NullFilter>
+class HashTable_OpenAddressing : public HashTable<T, U, Hash, KeyEqual, Stats>
 {
 private:
-    ProbeFunctor* m_probeFunctionPtr;
+    Probe m_probe;
     KeyValPair<T, U>** m_data; // array of pointers to key-val pairs
     double m_maxLoadFactor;
+    Filter m_filter; // front filter of the keys in both arrays
+    // incremental resize state - find is const but still migrates, so this is mutable
+    mutable KeyValPair<T, U>** m_oldData; // array being migrated from, nullptr when no resize is in progress
+    mutable unsigned int m_oldArrLength;
+    mutable unsigned int m_migrateInd; // next old slot to migrate
+    unsigned int m_migrationStep; // old slots migrated per find/insert/remove - 0 resizes in one pass
+    unsigned int m_resizeStep; // old slots migrated per operation by the resize in progress - m_migrationStep, raised so migration ends before the next resize
 public:
     HashTable_OpenAddressing() = delete;
-    HashTable_OpenAddressing(const unsigned int& length, HashFunctor<T>* hashFunctionPtr, ProbeFunctor* probeFunctionPtr, const double& maxLoadFactor);
+    HashTable_OpenAddressing(const unsigned int& length, const Hash& hash, const Probe& probe, const double& maxLoadFactor, const KeyEqual& keyEqual = KeyEqual(), const Filter& filter = Filter());
     ~HashTable_OpenAddressing();
     HashTable_SearchResult<T, U> find(const T& key) const;
+    template <class K, class = typename std::enable_if<isTransparentLookup<Hash, KeyEqual, T, K>>::type>
+    HashTable_SearchResult<T, U> find(const K& key) const; // heterogeneous lookup, e.g. by std::string_view for std::string keys - needs transparent Hash and KeyEqual
     void insert(const T& key, const U& val);
     bool remove(const T& key);
     void display();
     void resizeArray(const unsigned int& newLength); 
+    void setIncrementalResize(const unsigned int& migrationStep); // > 0 spreads each resize over later operations, migrating this many old slots per call
+    bool isResizing() const; // true while an incremental resize has old slots left to migrate
+    const Stats& stats() const; // refreshes the run length histogram and tombstone ratio when Stats is enabled
+    const Filter& filter() const;
+private:
+    template <class K>
+    HashTable_SearchResult<T, U> findKey(const K& key, const bool& recordStats) const; // find for the key type and for transparent lookup types - remove passes false, so it isn't counted as a lookup
+    void migrate(const unsigned int& numSlots) const; // moves pair ptrs of the next numSlots old slots into the new array, freeing tombstoned pairs
+    void placeInNewArray(KeyValPair<T, U>* kvpPtr) const; // puts a pair ptr in the first empty slot of its probe sequence in m_data, recording no insert
+    void rebuildFilter(); // resets the filter for the max load of the current length and adds every live key again
+    static KeyValPair<T, U>* movedSentinel(); // marks migrated old slots, so that probes through the old array don't stop there
 };
 
 /* ctor */
-template <class T, class U>
-HashTable_OpenAddressing<T, U>::HashTable_OpenAddressing(const unsigned int& length, HashFunctor<T>* hashFunctionPtr, ProbeFunctor* probeFunctionPtr, const double& maxLoadFactor)
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats, class Filter>
+HashTable_OpenAddressing<T, U, Hash, Probe, KeyEqual, Stats, Filter>::HashTable_OpenAddressing(const unsigned int& length, const Hash& hash, const Probe& probe, const double& maxLoadFactor, const KeyEqual& keyEqual, const Filter& filter)
+    : HashTable<T, U, Hash, KeyEqual, Stats>(hash, keyEqual), m_probe(probe), m_filter(filter)
 {
     //assert(length % 2 == 0); // array length must be even, to ensure probing function gcd = 1
-    this->m_arrLength = length;
-    this->m_data = new KeyValPair<T, U>*[length]; // allocate key value pairs on the heap - this is so they can be deleted when removed
-    this->m_hashFunctionPtr = hashFunctionPtr;
-    this->m_probeFunctionPtr = probeFunctionPtr;
+    this->m_arrLength = this->roundLength(length);
+    this->m_data = new KeyValPair<T, U>*[this->m_arrLength](); // allocate key value pairs on the heap - this is so they can be deleted when removed (slots start as nullptr)
     this->m_numEntries = 0;
     this->m_maxLoadFactor = maxLoadFactor;
+    this->m_oldData = nullptr;
+    this->m_oldArrLength = 0;
+    this->m_migrateInd = 0;
+    this->m_migrationStep = 0;
+    this->m_resizeStep = 0;
+    this->m_filter.reset(static_cast<unsigned int>(this->m_arrLength * this->m_maxLoadFactor));
 }
 
 /* dtor */
-template <class T, class U>
-HashTable_OpenAddressing<T, U>::~HashTable_OpenAddressing()
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats, class Filter>
+HashTable_OpenAddressing<T, U, Hash, Probe, KeyEqual, Stats, Filter>::~HashTable_OpenAddressing()
 {
+    delete[] this->m_oldData;
     delete[] this->m_data;
 }
 
 /* returns the pointer to a key value pair given key */
-template <class T, class U>
-HashTable_SearchResult<T, U> HashTable_OpenAddressing<T, U>::find(const T& key) const
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats, class Filter>
+HashTable_SearchResult<T, U> HashTable_OpenAddressing<T, U, Hash, Probe, KeyEqual, Stats, Filter>::find(const T& key) const
+{
+    return this->findKey(key, true);
+}
+
+/* returns the pointer to a key value pair given a key of another type that hashes and compares equal to the stored key - no temporary key is built */
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats, class Filter>
+template <class K, class>
+HashTable_SearchResult<T, U> HashTable_OpenAddressing<T, U, Hash, Probe, KeyEqual, Stats, Filter>::find(const K& key) const
+{
+    return this->findKey(key, true);
+}
+
+/* probes the new array, then the old one during an incremental resize - a found pair is swapped into the first tombstone on its probe sequence */
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats, class Filter>
+template <class K>
+HashTable_SearchResult<T, U> HashTable_OpenAddressing<T, U, Hash, Probe, KeyEqual, Stats, Filter>::findKey(const K& key, const bool& recordStats) const
 {  
-    unsigned int hashedKey = (*this->m_hashFunctionPtr)(key, this->m_arrLength);
+    this->migrate(this->m_resizeStep);
+    if constexpr (Filter::enabled)
+    {
+        if (!this->m_filter.mayContain(key)) // never inserted - neither array is probed
+        {
+            if (recordStats)
+                this->recordLookup(0, false);
+            HashTable_SearchResult<T, U> result;
+            result.m_kvpPtr = nullptr;
+            return result;
+        }
+    }
+    unsigned int hashedKey = this->m_hash(key, this->m_arrLength);
     unsigned int ind = hashedKey;
-    KeyValPair<T, U>* tombstonePtr = nullptr;
-    this->m_probeFunctionPtr->reset(); // reset probe function ptr to base value
+    unsigned int tombstoneInd = this->m_arrLength; // first tombstone on the probe sequence, m_arrLength if none
+    unsigned int probeStep = 0; // probe sequence is computed locally, so lookups never mutate shared state
     while (this->m_data[ind] != nullptr)
     {
-        if ((this->m_data[ind]->m_key == key) && (this->m_data[ind]->m_tombstone == false)) // if key matches and the key-value pair hasn't been marked with tombstone
+        if (this->m_keyEqual(this->m_data[ind]->m_key, key) && (this->m_data[ind]->m_tombstone == false)) // if key matches and the key-value pair hasn't been marked with tombstone
         {
             // found
             HashTable_SearchResult<T, U> result;
             result.m_hashedKey = hashedKey;
-            if (tombstonePtr != nullptr) // if relevent tombstone was encountered in probing, transfer data to this and delete the original key-value pair
+            if (tombstoneInd != this->m_arrLength) // if relevent tombstone was encountered in probing, swap the pair into its slot so the next lookup is shorter
             {
-                tombstonePtr->m_key = key; 
-                tombstonePtr->m_val = this->m_data[ind]->m_val;
-                tombstonePtr->m_tombstone = false;
-                result.m_kvpPtr = tombstonePtr;
-                delete this->m_data[ind]; // delete original
-                this->m_data[ind] = nullptr;
-                std::cout << "Found key " << key << " and moved from index " << ind << std::endl;
+                // the tombstone takes the pair's old slot rather than leaving it empty, which would cut the probe sequence of later keys
+                KeyValPair<T, U>* tombstonePtr = this->m_data[tombstoneInd];
+                this->m_data[tombstoneInd] = this->m_data[ind];
+                this->m_data[ind] = tombstonePtr;
+                result.m_kvpPtr = this->m_data[tombstoneInd];
             }
             else
             {
                 result.m_kvpPtr = this->m_data[ind];
-                std::cout << "Found key" << std::endl;
             }
+            if (recordStats)
+                this->recordLookup(probeStep + 1, true);
             return result;
         }
         else
         {
-            if ((this->m_data[ind]->m_tombstone == true) && (tombstonePtr == nullptr))
+            if ((this->m_data[ind]->m_tombstone == true) && (tombstoneInd == this->m_arrLength))
+            {
+                tombstoneInd = ind; // keep track of first tombstone to move value to this...
+            }
+            ind = this->wrapIndex(hashedKey + this->m_probe(++probeStep, this->m_arrLength), this->m_arrLength); // increment probing sequence
+        }
+    }
+    // not in the new array - during an incremental resize it may still be waiting in the old one
+    if (this->m_oldData != nullptr)
+    {
+        hashedKey = this->m_hash(key, this->m_oldArrLength);
+        ind = hashedKey;
+        probeStep = 0;
+        for (unsigned int probes = 0; (probes < this->m_oldArrLength) && (this->m_oldData[ind] != nullptr); ++probes) // migrated slots hold the sentinel, so probing continues past them
+        {
+            KeyValPair<T, U>* kvpPtr = this->m_oldData[ind];
+            if ((kvpPtr != movedSentinel()) && this->m_keyEqual(kvpPtr->m_key, key) && (kvpPtr->m_tombstone == false))
             {
-                tombstonePtr = this->m_data[ind]; // keep track of first tombstone to move value to this...
+                HashTable_SearchResult<T, U> result;
+                result.m_hashedKey = hashedKey;
+                result.m_kvpPtr = kvpPtr; // pair objects are not reallocated by migration, so the ptr stays valid once it moves
+                if (recordStats)
+                    this->recordLookup(probeStep + 1, true);
+                return result;
             }
-            ind = (hashedKey + this->m_probeFunctionPtr->increment(this->m_arrLength)) % this->m_arrLength; // increment probing sequence
+            ind = this->wrapIndex(hashedKey + this->m_probe(++probeStep, this->m_oldArrLength), this->m_oldArrLength);
         }
     }
     // not found
+    if (recordStats)
+        this->recordLookup(probeStep + 1, false);
     HashTable_SearchResult<T, U> result;
     result.m_kvpPtr = nullptr;
     return result;
 }
 
 /* inserts new entry into hash table */
-template <class T, class U>
-void HashTable_OpenAddressing<T, U>::insert(const T& key, const U& val)
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats, class Filter>
+void HashTable_OpenAddressing<T, U, Hash, Probe, KeyEqual, Stats, Filter>::insert(const T& key, const U& val)
 {
     // calculate projected load factor to check if array size must increase
+    this->migrate(this->m_resizeStep);
     double projLoadFactor = (double) (this->m_numEntries + 1) / (double) (this->m_arrLength);
-    std::cout << "Projected load factor: " << projLoadFactor << std::endl;
     if (projLoadFactor > this->m_maxLoadFactor)
     {
-        std::cout << "Array size must increase to: " << 2 * this->m_arrLength << std::endl;
-        this->resizeArray(this->m_arrLength * 2);
+        if (this->m_migrationStep == 0)
+        {
+            this->resizeArray(this->m_arrLength * 2);
+        }
+        else
+        {
+            // incremental - swap in the empty new array now, pairs move across over the following operations
+            this->migrate(this->m_oldArrLength); // a previous resize must be finished first - a no-op, as the step below ends it in time
+            this->beginResize(); // only the swap is timed - migration cost is spread over later operations
+            this->m_oldData = this->m_data;
+            this->m_oldArrLength = this->m_arrLength;
+            this->m_migrateInd = 0;
+            this->m_arrLength *= 2;
+            this->m_data = new KeyValPair<T, U>*[this->m_arrLength]();
+            // at least this many inserts (each migrating first) come before the next resize, so the step is raised to move every old slot within them
+            unsigned int maxEntries = static_cast<unsigned int>(this->m_arrLength * this->m_maxLoadFactor);
+            unsigned int numInserts = (maxEntries > this->m_numEntries) ? maxEntries - this->m_numEntries : 1;
+            unsigned int minStep = (this->m_oldArrLength + numInserts - 1) / numInserts;
+            this->m_resizeStep = (this->m_migrationStep > minStep) ? this->m_migrationStep : minStep;
+            this->endResize();
+        }
     }
 
     // proceed with inserting the new key-value pair by hashing key and probing if necessary
-    unsigned int hashedKey = (*this->m_hashFunctionPtr)(key, this->m_arrLength);
-    std::cout << "Insertion (" << this->m_numEntries << ") : Key " << key << " maps onto index " << hashedKey << std::endl;
+    unsigned int hashedKey = this->m_hash(key, this->m_arrLength);
     unsigned int ind = hashedKey;
-    this->m_probeFunctionPtr->reset(); // reset probe function ptr to base value
+    unsigned int probeStep = 0;
     while ((this->m_data[ind] != nullptr) && (this->m_data[ind]->m_tombstone == false)) // either empty bucket or entry marked with tombstone
     {
-        std::cout << "\t Hash collision @ index " << ind << std::endl;
-        ind = (hashedKey + this->m_probeFunctionPtr->increment(this->m_arrLength)) % this->m_arrLength;
+        ind = this->wrapIndex(hashedKey + this->m_probe(++probeStep, this->m_arrLength), this->m_arrLength);
     }
-    std::cout << "\t Final index: " << ind << std::endl;
+    this->recordInsert(probeStep + 1);
     if ((this->m_data[ind] == nullptr)) // empty bucket
     {
         KeyValPair<T, U>* kvpPtr = new KeyValPair<T, U>(key, val); // copies the key and value
@@ -473,28 +1023,34 @@ void HashTable_OpenAddressing<T, U>::insert(const T& key, const U& val)
         this->m_data[ind]->m_val = val;
         this->m_data[ind]->m_tombstone = false;
     }    
+    if constexpr (Filter::enabled)
+    {
+        this->m_filter.add(key);
+        if (this->m_filter.full()) // reached by reusing tombstones, or by inserting during an incremental resize
+            this->rebuildFilter();
+    }
 }
 
 /* remove entry from hash table by key */
-template <class T, class U>
-bool HashTable_OpenAddressing<T, U>::remove(const T& key)
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats, class Filter>
+bool HashTable_OpenAddressing<T, U, Hash, Probe, KeyEqual, Stats, Filter>::remove(const T& key)
 {
-    HashTable_SearchResult<T, U> result = this->find(key);
+    HashTable_SearchResult<T, U> result = this->findKey(key, false);
     if (result.m_kvpPtr == nullptr)
     {
         return false; // object not found inside hash table
     }
     result.m_kvpPtr->m_tombstone = true; // mark as tombstone
-    std::cout << "Removal : Key " << key << " and value pair removed from dynamic array @ index " << result.m_hashedKey << ", now marked as tombstone" << std::endl;
     //this->m_numEntries--;
+    this->recordRemove();
     return true;
 }
 
 /* display 
     - note the value datatype must be defined for ostream operator
 */
-template <class T, class U>
-void HashTable_OpenAddressing<T, U>::display()
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats, class Filter>
+void HashTable_OpenAddressing<T, U, Hash, Probe, KeyEqual, Stats, Filter>::display()
 {
     std::cout << "======================" << std::endl;
     for (unsigned int i = 0; i < this->m_arrLength; ++i)
@@ -517,39 +1073,956 @@ void HashTable_OpenAddressing<T, U>::display()
             std::cout << std::endl;
         }
     }
+    if (this->m_oldData != nullptr)
+    {
+        std::cout << "Resizing: " << this->m_oldArrLength - this->m_migrateInd << " of " << this->m_oldArrLength << " old slots left to migrate" << std::endl;
+    }
     std::cout << "======================" << std::endl;
 }
 
 /* resize array
 - adjust the array to new size - new size cannot be smaller than existing number of entries
+- pair ptrs are moved into the new array without going through insert, so a rehash isn't counted as inserts in Stats; tombstoned pairs are freed
 */
-template <class T, class U>
-void HashTable_OpenAddressing<T, U>::resizeArray(const unsigned int& newLength)
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats, class Filter>
+void HashTable_OpenAddressing<T, U, Hash, Probe, KeyEqual, Stats, Filter>::resizeArray(const unsigned int& newLength)
 {
-    // make copy of existing data and clear array
+    // collect the live key-value pairs and clear array
     assert(newLength >= this->m_numEntries);
-    DynamicArray<KeyValPair<T, U>*> tmp; // make a copy of the key-value pairs in a new array
+    this->migrate(this->m_oldArrLength); // finish any incremental resize, so that every pair is in m_data
+    this->beginResize();
+    DynamicArray<KeyValPair<T, U>*> tmp;
     for (unsigned int i = 0; i < this->m_arrLength; ++i)
     {
-        if ((this->m_data[i] != nullptr) && (this->m_data[i]->m_tombstone == false)) // check key-value pair exists and isn't marked with tombstone
-        {
-            KeyValPair<T, U>* kvpPtr = new KeyValPair<T, U>(this->m_data[i]->m_key, this->m_data[i]->m_val);
-            tmp.append(kvpPtr);
+        if (this->m_data[i] == nullptr)
+            continue;
+        if (this->m_data[i]->m_tombstone == false)
+            tmp.append(this->m_data[i]);
+        else
             delete this->m_data[i];
-            this->m_data[i] = nullptr;
-        }
     }
     delete[] this->m_data;
 
-    // repopulate array with data from copy
-    this->m_arrLength = newLength;
-    this->m_data = new KeyValPair<T, U>*[this->m_arrLength]; // create array of pointers with the new size
-    this->m_numEntries = 0;
+    // repopulate array with the same pairs
+    this->m_arrLength = this->roundLength(newLength);
+    this->m_data = new KeyValPair<T, U>*[this->m_arrLength](); // create array of null pointers with the new size
+    this->m_numEntries = tmp.length();
+    this->m_filter.reset(static_cast<unsigned int>(this->m_arrLength * this->m_maxLoadFactor));
     for (unsigned int i = 0; i < tmp.length(); ++i)
     {
-        this->insert(tmp.get(i)->m_key, tmp.get(i)->m_val);
-        delete tmp.get(i);
+        this->placeInNewArray(tmp.get(i));
+        this->m_filter.add(tmp.get(i)->m_key);
+    }
+    this->endResize();
+}
+
+/* enables incremental resizing
+    - each find/insert/remove migrates migrationStep old slots, so no single call pays for the whole resize
+    - the step of a resize is raised to at least ceil(oldLength / (newLength * maxLoadFactor - numEntries)), the number of inserts left
+      before the next resize, so migration always ends before the next resize starts and no call migrates more than that step
+    - old and new arrays coexist until migration finishes; lookups check the new array, then the old one
+    - migration moves pair ptrs, so live pairs are never reallocated; tombstoned pairs are freed instead of moved, as in resizeArray
+    - migrationStep of 0 goes back to resizing in one pass
+*/
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats, class Filter>
+void HashTable_OpenAddressing<T, U, Hash, Probe, KeyEqual, Stats, Filter>::setIncrementalResize(const unsigned int& migrationStep)
+{
+    if (migrationStep == 0)
+        this->migrate(this->m_oldArrLength);
+    this->m_migrationStep = migrationStep;
+    if ((this->m_oldData == nullptr) || (migrationStep > this->m_resizeStep)) // a resize in progress keeps the raised step it needs
+        this->m_resizeStep = migrationStep;
+}
+
+/* returns true while old slots remain to be migrated */
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats, class Filter>
+bool HashTable_OpenAddressing<T, U, Hash, Probe, KeyEqual, Stats, Filter>::isResizing() const
+{
+    return this->m_oldData != nullptr;
+}
+
+/* returns the stats policy object - a snapshot of runs of occupied slots and the tombstone ratio is taken first if stats are enabled
+    - runs of the array being migrated from are not included
+*/
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats, class Filter>
+const Stats& HashTable_OpenAddressing<T, U, Hash, Probe, KeyEqual, Stats, Filter>::stats() const
+{
+    if constexpr (Stats::enabled)
+    {
+        this->beginSnapshot();
+        unsigned int runLength = 0, numTombstones = 0;
+        for (unsigned int i = 0; i < this->m_arrLength; ++i)
+        {
+            if (this->m_data[i] != nullptr)
+            {
+                runLength++;
+                numTombstones += (this->m_data[i]->m_tombstone == true);
+            }
+            else if (runLength > 0)
+            {
+                this->recordChainLength(runLength);
+                runLength = 0;
+            }
+        }
+        if (runLength > 0)
+            this->recordChainLength(runLength);
+        this->recordTombstones(numTombstones, this->m_arrLength);
+    }
+    return *this;
+}
+
+/* migrates up to numSlots old slots, freeing the old array once the last one has moved
+    - tombstoned pairs are deleted rather than moved, so churn during incremental resizes doesn't pile up dead pairs in the probe sequences
+*/
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats, class Filter>
+void HashTable_OpenAddressing<T, U, Hash, Probe, KeyEqual, Stats, Filter>::migrate(const unsigned int& numSlots) const
+{
+    if (this->m_oldData == nullptr)
+        return;
+    unsigned int end = (numSlots < this->m_oldArrLength - this->m_migrateInd) ? this->m_migrateInd + numSlots : this->m_oldArrLength;
+    for (; this->m_migrateInd < end; ++this->m_migrateInd)
+    {
+        KeyValPair<T, U>* kvpPtr = this->m_oldData[this->m_migrateInd];
+        if (kvpPtr == nullptr)
+            continue; // empty slots are left empty - probes stop there in the new array as well
+        if (kvpPtr->m_tombstone == true)
+        {
+            delete kvpPtr;
+            this->m_numEntries--;
+        }
+        else
+        {
+            this->placeInNewArray(kvpPtr);
+        }
+        this->m_oldData[this->m_migrateInd] = movedSentinel();
+    }
+    if (this->m_migrateInd == this->m_oldArrLength)
+    {
+        delete[] this->m_oldData;
+        this->m_oldData = nullptr;
+        this->m_oldArrLength = 0;
+        this->m_migrateInd = 0;
+    }
+}
+
+/* returns the front filter */
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats, class Filter>
+const Filter& HashTable_OpenAddressing<T, U, Hash, Probe, KeyEqual, Stats, Filter>::filter() const
+{
+    return this->m_filter;
+}
+
+/* resets the filter for the max load of the current length and adds every live key again
+    - keys still waiting in the old array of an incremental resize are added too, so this is one pass over both arrays
+    - drops the bits of keys that are now tombstones
+*/
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats, class Filter>
+void HashTable_OpenAddressing<T, U, Hash, Probe, KeyEqual, Stats, Filter>::rebuildFilter()
+{
+    this->m_filter.reset(static_cast<unsigned int>(this->m_arrLength * this->m_maxLoadFactor));
+    for (unsigned int i = 0; i < this->m_arrLength; ++i)
+    {
+        if ((this->m_data[i] != nullptr) && (this->m_data[i]->m_tombstone == false))
+            this->m_filter.add(this->m_data[i]->m_key);
+    }
+    for (unsigned int i = 0; i < this->m_oldArrLength; ++i)
+    {
+        KeyValPair<T, U>* kvpPtr = this->m_oldData[i];
+        if ((kvpPtr != nullptr) && (kvpPtr != movedSentinel()) && (kvpPtr->m_tombstone == false))
+            this->m_filter.add(kvpPtr->m_key);
+    }
+}
+
+/* puts a pair ptr in the first empty slot of its probe sequence in m_data - tombstones are not reused, as the caller moves every pair across */
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats, class Filter>
+void HashTable_OpenAddressing<T, U, Hash, Probe, KeyEqual, Stats, Filter>::placeInNewArray(KeyValPair<T, U>* kvpPtr) const
+{
+    unsigned int hashedKey = this->m_hash(kvpPtr->m_key, this->m_arrLength);
+    unsigned int ind = hashedKey;
+    unsigned int probeStep = 0;
+    while (this->m_data[ind] != nullptr)
+    {
+        ind = this->wrapIndex(hashedKey + this->m_probe(++probeStep, this->m_arrLength), this->m_arrLength);
+    }
+    this->m_data[ind] = kvpPtr;
+}
+
+/* returns address of a pair that is never stored in the table, used as the migrated marker */
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats, class Filter>
+KeyValPair<T, U>* HashTable_OpenAddressing<T, U, Hash, Probe, KeyEqual, Stats, Filter>::movedSentinel()
+{
+    static KeyValPair<T, U> sentinel;
+    return &sentinel;
+}
+
+/********************************************************************************************************************/
+/* HASH TABLE WITH FLAT OPEN ADDRESSING */
+
+/* slot states for flat open addressing */
+enum class HashTable_SlotState : unsigned char
+{
+    empty = 0,
+    full,
+    tombstone
+};
+
+/* slot for flat open addressing
+    - state byte and key-value pair sit side by side, so checking a slot and comparing its key touch the same cache line
+    - the pair is raw storage that is only constructed while the slot is full
+*/
+template <class T, class U>
+class HashTable_FlatSlot
+{
+public:
+    HashTable_SlotState m_state;
+    alignas(KeyValPair<T, U>) unsigned char m_kvpStorage[sizeof(KeyValPair<T, U>)];
+
+    KeyValPair<T, U>* kvpPtr()
+    {
+        return reinterpret_cast<KeyValPair<T, U>*>(this->m_kvpStorage);
+    }
+};
+
+/* Flat open addressing hash table
+    - same interface as HashTable_OpenAddressing, but pairs are stored inline in the slot array instead of as ptrs to separately allocated pairs
+    - a probe step reads one slot rather than following a ptr, and resizing moves pairs into the new array rather than reallocating them
+    - removal marks a tombstone; tombstones count towards the load factor so that resizing also clears them out
+    - inserting a key that is already present overwrites its value
+    - search result ptrs are only valid until the next insert, as an insert may resize the array
+*/
+template <class T, class U, class Hash = HashFunctorAdapter<T>, class Probe = ProbeFunctorAdapter, class KeyEqual = std::equal_to<T>, class Stats = NullStats>
+class HashTable_FlatOpenAddressing : public HashTable<T, U, Hash, KeyEqual, Stats>
+{
+private:
+    Probe m_probe;
+    HashTable_FlatSlot<T, U>* m_data; // array of slots holding key-val pairs inline
+    unsigned int m_numTombstones;
+    double m_maxLoadFactor;
+public:
+    HashTable_FlatOpenAddressing() = delete;
+    HashTable_FlatOpenAddressing(const unsigned int& length, const Hash& hash, const Probe& probe, const double& maxLoadFactor, const KeyEqual& keyEqual = KeyEqual());
+    HashTable_FlatOpenAddressing(const HashTable_FlatOpenAddressing&) = delete;
+    HashTable_FlatOpenAddressing& operator=(const HashTable_FlatOpenAddressing&) = delete;
+    ~HashTable_FlatOpenAddressing();
+    HashTable_SearchResult<T, U> find(const T& key) const;
+    template <class K, class = typename std::enable_if<isTransparentLookup<Hash, KeyEqual, T, K>>::type>
+    HashTable_SearchResult<T, U> find(const K& key) const; // heterogeneous lookup, e.g. by std::string_view for std::string keys - needs transparent Hash and KeyEqual
+    void findBatch(const T* keys, const unsigned int& n, HashTable_SearchResult<T, U>* out) const; // finds n keys, overlapping their cache misses
+    void insert(const T& key, const U& val);
+    void insertBatch(const T* keys, const U* vals, const unsigned int& n); // inserts n pairs, resizing at most once up front
+    bool remove(const T& key);
+    void display();
+    template <class F>
+    void forEach(F f) const; // calls f(key, val) for every entry, in slot order
+    void resizeArray(const unsigned int& newLength);
+    const Stats& stats() const; // refreshes the run length histogram and tombstone ratio when Stats is enabled
+private:
+    template <class K>
+    unsigned int findSlot(const K& key, const unsigned int& hashedKey, unsigned int& probeLength) const; // returns slot index holding key, or m_arrLength if not present - probeLength is set to the number of slots read
+    template <class K>
+    HashTable_SearchResult<T, U> findHashed(const K& key, const unsigned int& hashedKey) const;
+    void insertHashed(const T& key, const U& val, unsigned int hashedKey); // hashedKey is recomputed if the insert resizes the array
+    void reserve(const unsigned int& numNewEntries); // resizes now if inserting numNewEntries would need it later
+};
+
+/* ctor */
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats>
+HashTable_FlatOpenAddressing<T, U, Hash, Probe, KeyEqual, Stats>::HashTable_FlatOpenAddressing(const unsigned int& length, const Hash& hash, const Probe& probe, const double& maxLoadFactor, const KeyEqual& keyEqual)
+    : HashTable<T, U, Hash, KeyEqual, Stats>(hash, keyEqual), m_probe(probe)
+{
+    assert(length > 0);
+    this->m_arrLength = this->roundLength(length);
+    this->m_data = new HashTable_FlatSlot<T, U>[this->m_arrLength]; // slot array - pairs are not constructed until inserted
+    for (unsigned int i = 0; i < this->m_arrLength; ++i)
+    {
+        this->m_data[i].m_state = HashTable_SlotState::empty;
+    }
+    this->m_numEntries = 0;
+    this->m_numTombstones = 0;
+    this->m_maxLoadFactor = maxLoadFactor;
+}
+
+/* dtor - destroys pairs in full slots */
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats>
+HashTable_FlatOpenAddressing<T, U, Hash, Probe, KeyEqual, Stats>::~HashTable_FlatOpenAddressing()
+{
+    for (unsigned int i = 0; i < this->m_arrLength; ++i)
+    {
+        if (this->m_data[i].m_state == HashTable_SlotState::full)
+            this->m_data[i].kvpPtr()->~KeyValPair<T, U>();
+    }
+    delete[] this->m_data;
+}
+
+/* returns slot index of key by probing from its home index until the key or an empty slot is found - tombstones are skipped over */
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats>
+template <class K>
+unsigned int HashTable_FlatOpenAddressing<T, U, Hash, Probe, KeyEqual, Stats>::findSlot(const K& key, const unsigned int& hashedKey, unsigned int& probeLength) const
+{
+    unsigned int ind = hashedKey;
+    unsigned int probeStep = 0; // probe sequence is computed locally, so lookups never mutate shared state
+    for (probeLength = 1; probeLength <= this->m_arrLength; ++probeLength) // bounded in case the probe sequence cycles without reaching an empty slot
+    {
+        HashTable_FlatSlot<T, U>& slot = this->m_data[ind];
+        if (slot.m_state == HashTable_SlotState::empty)
+            break;
+        if ((slot.m_state == HashTable_SlotState::full) && this->m_keyEqual(slot.kvpPtr()->m_key, key))
+            return ind;
+        ind = this->wrapIndex(hashedKey + this->m_probe(++probeStep, this->m_arrLength), this->m_arrLength); // increment probing sequence
+    }
+    return this->m_arrLength;
+}
+
+/* returns the pointer to a key value pair given key */
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats>
+HashTable_SearchResult<T, U> HashTable_FlatOpenAddressing<T, U, Hash, Probe, KeyEqual, Stats>::find(const T& key) const
+{
+    return this->findHashed(key, this->m_hash(key, this->m_arrLength));
+}
+
+/* returns the pointer to a key value pair given a key of another type that hashes and compares equal to the stored key - no temporary key is built */
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats>
+template <class K, class>
+HashTable_SearchResult<T, U> HashTable_FlatOpenAddressing<T, U, Hash, Probe, KeyEqual, Stats>::find(const K& key) const
+{
+    return this->findHashed(key, this->m_hash(key, this->m_arrLength));
+}
+
+/* finds n keys into out[0..n)
+    - each block of keys is hashed and has its home slots prefetched before any of them is resolved, so the cache misses overlap
+*/
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats>
+void HashTable_FlatOpenAddressing<T, U, Hash, Probe, KeyEqual, Stats>::findBatch(const T* keys, const unsigned int& n, HashTable_SearchResult<T, U>* out) const
+{
+    unsigned int hashedKeys[hashTableBatchLength];
+    for (unsigned int start = 0; start < n; start += hashTableBatchLength)
+    {
+        unsigned int blockLength = (n - start < hashTableBatchLength) ? n - start : hashTableBatchLength;
+        for (unsigned int i = 0; i < blockLength; ++i)
+        {
+            hashedKeys[i] = this->m_hash(keys[start + i], this->m_arrLength);
+            detail::prefetch(this->m_data + hashedKeys[i]);
+        }
+        for (unsigned int i = 0; i < blockLength; ++i)
+        {
+            out[start + i] = this->findHashed(keys[start + i], hashedKeys[i]);
+        }
+    }
+}
+
+/* returns the pointer to a key value pair given key and its home index */
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats>
+template <class K>
+HashTable_SearchResult<T, U> HashTable_FlatOpenAddressing<T, U, Hash, Probe, KeyEqual, Stats>::findHashed(const K& key, const unsigned int& hashedKey) const
+{
+    HashTable_SearchResult<T, U> result;
+    unsigned int probeLength;
+    unsigned int ind = this->findSlot(key, hashedKey, probeLength);
+    this->recordLookup(probeLength, ind != this->m_arrLength);
+    if (ind == this->m_arrLength)
+    {
+        result.m_kvpPtr = nullptr; // not found
+        return result;
+    }
+    result.m_hashedKey = ind;
+    result.m_kvpPtr = this->m_data[ind].kvpPtr();
+    return result;
+}
+
+/* inserts new entry, or overwrites the value if key already present */
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats>
+void HashTable_FlatOpenAddressing<T, U, Hash, Probe, KeyEqual, Stats>::insert(const T& key, const U& val)
+{
+    this->insertHashed(key, val, this->m_hash(key, this->m_arrLength));
+}
+
+/* inserts n pairs - the array is grown once to fit them all, then keys are hashed and prefetched a block at a time like findBatch
+    - keys already present count towards the up front growth even though they only overwrite
+*/
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats>
+void HashTable_FlatOpenAddressing<T, U, Hash, Probe, KeyEqual, Stats>::insertBatch(const T* keys, const U* vals, const unsigned int& n)
+{
+    this->reserve(n);
+    unsigned int hashedKeys[hashTableBatchLength];
+    for (unsigned int start = 0; start < n; start += hashTableBatchLength)
+    {
+        unsigned int blockLength = (n - start < hashTableBatchLength) ? n - start : hashTableBatchLength;
+        for (unsigned int i = 0; i < blockLength; ++i)
+        {
+            hashedKeys[i] = this->m_hash(keys[start + i], this->m_arrLength);
+            detail::prefetch(this->m_data + hashedKeys[i]);
+        }
+        for (unsigned int i = 0; i < blockLength; ++i)
+        {
+            this->insertHashed(keys[start + i], vals[start + i], hashedKeys[i]);
+        }
+    }
+}
+
+/* grows the array (or rebuilds it to clear tombstones) so that numNewEntries more inserts fit under the max load factor */
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats>
+void HashTable_FlatOpenAddressing<T, U, Hash, Probe, KeyEqual, Stats>::reserve(const unsigned int& numNewEntries)
+{
+    if ((double) (this->m_numEntries + this->m_numTombstones + numNewEntries) <= this->m_maxLoadFactor * this->m_arrLength)
+        return;
+    unsigned int length = this->m_arrLength;
+    while ((double) (this->m_numEntries + numNewEntries) > this->m_maxLoadFactor * length)
+    {
+        length *= 2;
+    }
+    this->resizeArray(length);
+}
+
+/* inserts new entry given its home index */
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats>
+void HashTable_FlatOpenAddressing<T, U, Hash, Probe, KeyEqual, Stats>::insertHashed(const T& key, const U& val, unsigned int hashedKey)
+{
+    unsigned int probeLength;
+    unsigned int existing = this->findSlot(key, hashedKey, probeLength);
+    if (existing != this->m_arrLength)
+    {
+        this->m_data[existing].kvpPtr()->m_val = val;
+        this->recordInsert(probeLength);
+        return;
+    }
+
+    // tombstones lengthen probe sequences just like entries do, so both count towards the load factor
+    double projLoadFactor = (double) (this->m_numEntries + this->m_numTombstones + 1) / (double) (this->m_arrLength);
+    if (projLoadFactor > this->m_maxLoadFactor)
+    {
+        // only grow if live entries alone need it - otherwise rebuilding at the same size clears the tombstones
+        double liveLoadFactor = (double) (this->m_numEntries + 1) / (double) (this->m_arrLength);
+        this->resizeArray((liveLoadFactor > this->m_maxLoadFactor / 2) ? this->m_arrLength * 2 : this->m_arrLength);
+        hashedKey = this->m_hash(key, this->m_arrLength);
+    }
+
+    // probe for first empty or tombstone slot
+    unsigned int ind = hashedKey;
+    unsigned int probeStep = 0;
+    unsigned int probes = 0;
+    while (this->m_data[ind].m_state == HashTable_SlotState::full)
+    {
+        probes++;
+        assert(probes < this->m_arrLength); // probe sequence must reach a free slot
+        ind = this->wrapIndex(hashedKey + this->m_probe(++probeStep, this->m_arrLength), this->m_arrLength);
+    }
+    this->recordInsert(probes + 1);
+    if (this->m_data[ind].m_state == HashTable_SlotState::tombstone)
+        this->m_numTombstones--;
+    ::new (static_cast<void*>(this->m_data[ind].kvpPtr())) KeyValPair<T, U>(key, val); // copies key and value into the slot
+    this->m_data[ind].m_state = HashTable_SlotState::full;
+    this->m_numEntries++;
+}
+
+/* remove entry by key - destroys the pair and marks slot as tombstone */
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats>
+bool HashTable_FlatOpenAddressing<T, U, Hash, Probe, KeyEqual, Stats>::remove(const T& key)
+{
+    unsigned int probeLength;
+    unsigned int ind = this->findSlot(key, this->m_hash(key, this->m_arrLength), probeLength);
+    if (ind == this->m_arrLength)
+    {
+        return false; // object not found inside hash table
+    }
+    this->m_data[ind].kvpPtr()->~KeyValPair<T, U>();
+    this->m_data[ind].m_state = HashTable_SlotState::tombstone;
+    this->m_numEntries--;
+    this->m_numTombstones++;
+    this->recordRemove();
+    return true;
+}
+
+/* display
+    - note the value datatype must be defined for ostream operator
+*/
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats>
+void HashTable_FlatOpenAddressing<T, U, Hash, Probe, KeyEqual, Stats>::display()
+{
+    std::cout << "======================" << std::endl;
+    for (unsigned int i = 0; i < this->m_arrLength; ++i)
+    {
+        std::cout << "Index (" << i << ") \t |";
+        if (this->m_data[i].m_state == HashTable_SlotState::full)
+        {
+            std::cout << "\t Key: " << this->m_data[i].kvpPtr()->m_key << " -> Value: " << this->m_data[i].kvpPtr()->m_val << std::endl;
+        }
+        else if (this->m_data[i].m_state == HashTable_SlotState::tombstone)
+        {
+            std::cout << "\t Tombstone" << std::endl;
+        }
+        else
+        {
+            std::cout << std::endl;
+        }
+    }
+    std::cout << "======================" << std::endl;
+}
+
+/* calls f(key, val) for every entry */
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats>
+template <class F>
+void HashTable_FlatOpenAddressing<T, U, Hash, Probe, KeyEqual, Stats>::forEach(F f) const
+{
+    for (unsigned int i = 0; i < this->m_arrLength; ++i)
+    {
+        if (this->m_data[i].m_state == HashTable_SlotState::full)
+            f(this->m_data[i].kvpPtr()->m_key, this->m_data[i].kvpPtr()->m_val);
+    }
+}
+
+/* resize array
+    - pairs are moved straight into their new slots, tombstones are dropped
+*/
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats>
+void HashTable_FlatOpenAddressing<T, U, Hash, Probe, KeyEqual, Stats>::resizeArray(const unsigned int& newLength)
+{
+    unsigned int length = this->roundLength(newLength);
+    assert(length > this->m_numEntries);
+    this->beginResize();
+    HashTable_FlatSlot<T, U>* oldData = this->m_data;
+    unsigned int oldLength = this->m_arrLength;
+
+    this->m_arrLength = length;
+    this->m_data = new HashTable_FlatSlot<T, U>[length];
+    for (unsigned int i = 0; i < length; ++i)
+    {
+        this->m_data[i].m_state = HashTable_SlotState::empty;
+    }
+    for (unsigned int i = 0; i < oldLength; ++i)
+    {
+        if (oldData[i].m_state != HashTable_SlotState::full)
+            continue;
+        unsigned int hashedKey = this->m_hash(oldData[i].kvpPtr()->m_key, length);
+        unsigned int ind = hashedKey;
+        unsigned int probeStep = 0;
+        while (this->m_data[ind].m_state == HashTable_SlotState::full)
+        {
+            ind = this->wrapIndex(hashedKey + this->m_probe(++probeStep, length), length);
+        }
+        detail::relocate(this->m_data[ind].kvpPtr(), oldData[i].kvpPtr(), 1); // move pair across, no reallocation
+        this->m_data[ind].m_state = HashTable_SlotState::full;
+    }
+    this->m_numTombstones = 0;
+    delete[] oldData;
+    this->endResize();
+}
+
+/* returns the stats policy object - a snapshot of runs of non-empty slots and the tombstone ratio is taken first if stats are enabled */
+template <class T, class U, class Hash, class Probe, class KeyEqual, class Stats>
+const Stats& HashTable_FlatOpenAddressing<T, U, Hash, Probe, KeyEqual, Stats>::stats() const
+{
+    if constexpr (Stats::enabled)
+    {
+        this->beginSnapshot();
+        unsigned int runLength = 0;
+        for (unsigned int i = 0; i < this->m_arrLength; ++i)
+        {
+            if (this->m_data[i].m_state != HashTable_SlotState::empty)
+            {
+                runLength++;
+            }
+            else if (runLength > 0)
+            {
+                this->recordChainLength(runLength);
+                runLength = 0;
+            }
+        }
+        if (runLength > 0)
+            this->recordChainLength(runLength);
+        this->recordTombstones(this->m_numTombstones, this->m_arrLength);
+    }
+    return *this;
+}
+
+/********************************************************************************************************************/
+/* HASH TABLE WITH ROBIN HOOD OPEN ADDRESSING */
+
+/* slot for robin hood open addressing
+    - m_probeLength is 0 for an empty slot, otherwise 1 + distance of the entry from its home index
+*/
+template <class T, class U>
+class HashTable_RobinHoodSlot
+{
+public:
+    unsigned int m_probeLength;
+    alignas(KeyValPair<T, U>) unsigned char m_kvpStorage[sizeof(KeyValPair<T, U>)];
+
+    KeyValPair<T, U>* kvpPtr()
+    {
+        return reinterpret_cast<KeyValPair<T, U>*>(this->m_kvpStorage);
+    }
+};
+
+/* Robin hood open addressing hash table
+    - linear probing where an inserted entry takes the slot of any entry closer to its home index than itself ("takes from the rich")
+    - this keeps the spread of probe lengths small, so worst-case lookups stay short at high load factors
+    - entries along a probe run are ordered by home index, so an unsuccessful lookup stops as soon as it meets an entry closer to home than the search
+    - removal shifts the following entries of the run back one slot instead of leaving a tombstone, so churn never lengthens probe runs
+    - no probe functor: backward shift relies on every entry sitting a known linear distance from its home index
+    - pairs are stored inline like HashTable_FlatOpenAddressing; inserting a key that is already present overwrites its value
+*/
+template <class T, class U, class Hash = HashFunctorAdapter<T>, class KeyEqual = std::equal_to<T>, class Stats = NullStats>
+class HashTable_RobinHood : public HashTable<T, U, Hash, KeyEqual, Stats>
+{
+private:
+    HashTable_RobinHoodSlot<T, U>* m_data; // array of slots holding key-val pairs inline
+    double m_maxLoadFactor;
+public:
+    HashTable_RobinHood() = delete;
+    HashTable_RobinHood(const unsigned int& length, const Hash& hash, const double& maxLoadFactor, const KeyEqual& keyEqual = KeyEqual());
+    HashTable_RobinHood(const HashTable_RobinHood&) = delete;
+    HashTable_RobinHood& operator=(const HashTable_RobinHood&) = delete;
+    ~HashTable_RobinHood();
+    HashTable_SearchResult<T, U> find(const T& key) const;
+    template <class K, class = typename std::enable_if<isTransparentLookup<Hash, KeyEqual, T, K>>::type>
+    HashTable_SearchResult<T, U> find(const K& key) const; // heterogeneous lookup, e.g. by std::string_view for std::string keys - needs transparent Hash and KeyEqual
+    void findBatch(const T* keys, const unsigned int& n, HashTable_SearchResult<T, U>* out) const; // finds n keys, overlapping their cache misses
+    void insert(const T& key, const U& val);
+    void insertBatch(const T* keys, const U* vals, const unsigned int& n); // inserts n pairs, resizing at most once up front
+    bool remove(const T& key);
+    void display();
+    template <class F>
+    void forEach(F f) const; // calls f(key, val) for every entry, in slot order
+    void resizeArray(const unsigned int& newLength);
+    double averageProbeLength() const; // mean number of slots read by a successful lookup
+    unsigned int maxProbeLength() const; // slots read by the worst successful lookup
+    const Stats& stats() const; // refreshes the run length histogram and tombstone ratio when Stats is enabled
+private:
+    template <class K>
+    unsigned int findSlot(const K& key, const unsigned int& hashedKey, unsigned int& probeLength) const; // returns slot index holding key, or m_arrLength if not present - probeLength is set to the number of slots read
+    template <class K>
+    HashTable_SearchResult<T, U> findHashed(const K& key, const unsigned int& hashedKey) const;
+    void insertHashed(const T& key, const U& val, unsigned int hashedKey); // hashedKey is recomputed if the insert resizes the array
+    void reserve(const unsigned int& numNewEntries); // resizes now if inserting numNewEntries would need it later
+    void place(KeyValPair<T, U>&& kvp, const unsigned int& homeInd); // inserts pair known not to be present, displacing entries closer to home
+};
+
+/* ctor */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+HashTable_RobinHood<T, U, Hash, KeyEqual, Stats>::HashTable_RobinHood(const unsigned int& length, const Hash& hash, const double& maxLoadFactor, const KeyEqual& keyEqual)
+    : HashTable<T, U, Hash, KeyEqual, Stats>(hash, keyEqual)
+{
+    assert(length > 0);
+    assert((maxLoadFactor > 0) && (maxLoadFactor < 1)); // at least one empty slot must always remain to end probe runs
+    this->m_arrLength = this->roundLength(length);
+    this->m_data = new HashTable_RobinHoodSlot<T, U>[this->m_arrLength];
+    for (unsigned int i = 0; i < this->m_arrLength; ++i)
+    {
+        this->m_data[i].m_probeLength = 0;
+    }
+    this->m_numEntries = 0;
+    this->m_maxLoadFactor = maxLoadFactor;
+}
+
+/* dtor - destroys pairs in occupied slots */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+HashTable_RobinHood<T, U, Hash, KeyEqual, Stats>::~HashTable_RobinHood()
+{
+    for (unsigned int i = 0; i < this->m_arrLength; ++i)
+    {
+        if (this->m_data[i].m_probeLength != 0)
+            this->m_data[i].kvpPtr()->~KeyValPair<T, U>();
+    }
+    delete[] this->m_data;
+}
+
+/* returns slot index of key
+    - stops at an empty slot, or at an entry whose probe length is shorter than the current one, as the key would have displaced it
+*/
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+template <class K>
+unsigned int HashTable_RobinHood<T, U, Hash, KeyEqual, Stats>::findSlot(const K& key, const unsigned int& hashedKey, unsigned int& probeLength) const
+{
+    unsigned int ind = hashedKey;
+    for (probeLength = 1; probeLength <= this->m_data[ind].m_probeLength; ++probeLength)
+    {
+        if ((this->m_data[ind].m_probeLength == probeLength) && this->m_keyEqual(this->m_data[ind].kvpPtr()->m_key, key))
+            return ind;
+        ind = (ind + 1 == this->m_arrLength) ? 0 : ind + 1;
+    }
+    return this->m_arrLength;
+}
+
+/* returns the pointer to a key value pair given key */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+HashTable_SearchResult<T, U> HashTable_RobinHood<T, U, Hash, KeyEqual, Stats>::find(const T& key) const
+{
+    return this->findHashed(key, this->m_hash(key, this->m_arrLength));
+}
+
+/* returns the pointer to a key value pair given a key of another type that hashes and compares equal to the stored key - no temporary key is built */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+template <class K, class>
+HashTable_SearchResult<T, U> HashTable_RobinHood<T, U, Hash, KeyEqual, Stats>::find(const K& key) const
+{
+    return this->findHashed(key, this->m_hash(key, this->m_arrLength));
+}
+
+/* finds n keys into out[0..n) - each block of keys is hashed and prefetched before any of them is resolved */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+void HashTable_RobinHood<T, U, Hash, KeyEqual, Stats>::findBatch(const T* keys, const unsigned int& n, HashTable_SearchResult<T, U>* out) const
+{
+    unsigned int hashedKeys[hashTableBatchLength];
+    for (unsigned int start = 0; start < n; start += hashTableBatchLength)
+    {
+        unsigned int blockLength = (n - start < hashTableBatchLength) ? n - start : hashTableBatchLength;
+        for (unsigned int i = 0; i < blockLength; ++i)
+        {
+            hashedKeys[i] = this->m_hash(keys[start + i], this->m_arrLength);
+            detail::prefetch(this->m_data + hashedKeys[i]);
+        }
+        for (unsigned int i = 0; i < blockLength; ++i)
+        {
+            out[start + i] = this->findHashed(keys[start + i], hashedKeys[i]);
+        }
+    }
+}
+
+/* returns the pointer to a key value pair given key and its home index */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+template <class K>
+HashTable_SearchResult<T, U> HashTable_RobinHood<T, U, Hash, KeyEqual, Stats>::findHashed(const K& key, const unsigned int& hashedKey) const
+{
+    HashTable_SearchResult<T, U> result;
+    unsigned int probeLength;
+    unsigned int ind = this->findSlot(key, hashedKey, probeLength);
+    this->recordLookup(probeLength, ind != this->m_arrLength);
+    if (ind == this->m_arrLength)
+    {
+        result.m_kvpPtr = nullptr; // not found
+        return result;
+    }
+    result.m_hashedKey = ind;
+    result.m_kvpPtr = this->m_data[ind].kvpPtr();
+    return result;
+}
+
+/* inserts new entry, or overwrites the value if key already present */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+void HashTable_RobinHood<T, U, Hash, KeyEqual, Stats>::insert(const T& key, const U& val)
+{
+    this->insertHashed(key, val, this->m_hash(key, this->m_arrLength));
+}
+
+/* inserts n pairs - the array is grown once to fit them all, then keys are hashed and prefetched a block at a time like findBatch
+    - keys already present count towards the up front growth even though they only overwrite
+*/
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+void HashTable_RobinHood<T, U, Hash, KeyEqual, Stats>::insertBatch(const T* keys, const U* vals, const unsigned int& n)
+{
+    this->reserve(n);
+    unsigned int hashedKeys[hashTableBatchLength];
+    for (unsigned int start = 0; start < n; start += hashTableBatchLength)
+    {
+        unsigned int blockLength = (n - start < hashTableBatchLength) ? n - start : hashTableBatchLength;
+        for (unsigned int i = 0; i < blockLength; ++i)
+        {
+            hashedKeys[i] = this->m_hash(keys[start + i], this->m_arrLength);
+            detail::prefetch(this->m_data + hashedKeys[i]);
+        }
+        for (unsigned int i = 0; i < blockLength; ++i)
+        {
+            this->insertHashed(keys[start + i], vals[start + i], hashedKeys[i]);
+        }
+    }
+}
+
+/* grows the array so that numNewEntries more inserts fit under the max load factor */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+void HashTable_RobinHood<T, U, Hash, KeyEqual, Stats>::reserve(const unsigned int& numNewEntries)
+{
+    unsigned int length = this->m_arrLength;
+    while ((double) (this->m_numEntries + numNewEntries) > this->m_maxLoadFactor * length)
+    {
+        length *= 2;
+    }
+    if (length != this->m_arrLength)
+        this->resizeArray(length);
+}
+
+/* inserts new entry given its home index */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+void HashTable_RobinHood<T, U, Hash, KeyEqual, Stats>::insertHashed(const T& key, const U& val, unsigned int hashedKey)
+{
+    unsigned int probeLength;
+    unsigned int existing = this->findSlot(key, hashedKey, probeLength);
+    if (existing != this->m_arrLength)
+    {
+        this->m_data[existing].kvpPtr()->m_val = val;
+        this->recordInsert(probeLength);
+        return;
+    }
+    double projLoadFactor = (double) (this->m_numEntries + 1) / (double) (this->m_arrLength);
+    if (projLoadFactor > this->m_maxLoadFactor)
+    {
+        this->resizeArray(this->m_arrLength * 2);
+        hashedKey = this->m_hash(key, this->m_arrLength);
+    }
+    this->place(KeyValPair<T, U>(key, val), hashedKey);
+    this->m_numEntries++;
+    this->recordInsert(probeLength);
+}
+
+/* walks the probe run from the pair's home index, swapping it with any entry that is closer to its own home
+    - the displaced entry then carries on down the run, until an empty slot is reached
+*/
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+void HashTable_RobinHood<T, U, Hash, KeyEqual, Stats>::place(KeyValPair<T, U>&& kvp, const unsigned int& homeInd)
+{
+    unsigned int ind = homeInd;
+    unsigned int probeLength = 1;
+    while (this->m_data[ind].m_probeLength != 0)
+    {
+        if (this->m_data[ind].m_probeLength < probeLength)
+        {
+            std::swap(kvp, *this->m_data[ind].kvpPtr());
+            std::swap(probeLength, this->m_data[ind].m_probeLength);
+        }
+        ind = (ind + 1 == this->m_arrLength) ? 0 : ind + 1;
+        probeLength++;
+    }
+    ::new (static_cast<void*>(this->m_data[ind].kvpPtr())) KeyValPair<T, U>(std::move(kvp));
+    this->m_data[ind].m_probeLength = probeLength;
+}
+
+/* remove entry by key - following entries of the run shift back one slot until an empty slot or an entry already at home */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+bool HashTable_RobinHood<T, U, Hash, KeyEqual, Stats>::remove(const T& key)
+{
+    unsigned int probeLength;
+    unsigned int ind = this->findSlot(key, this->m_hash(key, this->m_arrLength), probeLength);
+    if (ind == this->m_arrLength)
+    {
+        return false; // object not found inside hash table
+    }
+    this->m_data[ind].kvpPtr()->~KeyValPair<T, U>();
+    unsigned int next = (ind + 1 == this->m_arrLength) ? 0 : ind + 1;
+    while (this->m_data[next].m_probeLength > 1)
+    {
+        detail::relocate(this->m_data[ind].kvpPtr(), this->m_data[next].kvpPtr(), 1);
+        this->m_data[ind].m_probeLength = this->m_data[next].m_probeLength - 1;
+        ind = next;
+        next = (next + 1 == this->m_arrLength) ? 0 : next + 1;
+    }
+    this->m_data[ind].m_probeLength = 0;
+    this->m_numEntries--;
+    this->recordRemove();
+    return true;
+}
+
+/* display
+    - note the value datatype must be defined for ostream operator
+*/
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+void HashTable_RobinHood<T, U, Hash, KeyEqual, Stats>::display()
+{
+    std::cout << "======================" << std::endl;
+    for (unsigned int i = 0; i < this->m_arrLength; ++i)
+    {
+        std::cout << "Index (" << i << ") \t |";
+        if (this->m_data[i].m_probeLength != 0)
+        {
+            std::cout << "\t Key: " << this->m_data[i].kvpPtr()->m_key << " -> Value: " << this->m_data[i].kvpPtr()->m_val << " (probe length " << this->m_data[i].m_probeLength << ")" << std::endl;
+        }
+        else
+        {
+            std::cout << std::endl;
+        }
+    }
+    std::cout << "======================" << std::endl;
+}
+
+/* calls f(key, val) for every entry */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+template <class F>
+void HashTable_RobinHood<T, U, Hash, KeyEqual, Stats>::forEach(F f) const
+{
+    for (unsigned int i = 0; i < this->m_arrLength; ++i)
+    {
+        if (this->m_data[i].m_probeLength != 0)
+            f(this->m_data[i].kvpPtr()->m_key, this->m_data[i].kvpPtr()->m_val);
+    }
+}
+
+/* resize array - every pair is moved into the new array and placed again */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+void HashTable_RobinHood<T, U, Hash, KeyEqual, Stats>::resizeArray(const unsigned int& newLength)
+{
+    unsigned int length = this->roundLength(newLength);
+    assert(length > this->m_numEntries);
+    this->beginResize();
+    HashTable_RobinHoodSlot<T, U>* oldData = this->m_data;
+    unsigned int oldLength = this->m_arrLength;
+
+    this->m_arrLength = length;
+    this->m_data = new HashTable_RobinHoodSlot<T, U>[length];
+    for (unsigned int i = 0; i < length; ++i)
+    {
+        this->m_data[i].m_probeLength = 0;
+    }
+    for (unsigned int i = 0; i < oldLength; ++i)
+    {
+        if (oldData[i].m_probeLength == 0)
+            continue;
+        this->place(std::move(*oldData[i].kvpPtr()), this->m_hash(oldData[i].kvpPtr()->m_key, length));
+        oldData[i].kvpPtr()->~KeyValPair<T, U>();
+    }
+    delete[] oldData;
+    this->endResize();
+}
+
+/* returns mean probe length over all entries */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+double HashTable_RobinHood<T, U, Hash, KeyEqual, Stats>::averageProbeLength() const
+{
+    if (this->m_numEntries == 0)
+        return 0;
+    unsigned long long total = 0;
+    for (unsigned int i = 0; i < this->m_arrLength; ++i)
+    {
+        total += this->m_data[i].m_probeLength;
+    }
+    return (double) total / (double) this->m_numEntries;
+}
+
+/* returns longest probe length over all entries */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+unsigned int HashTable_RobinHood<T, U, Hash, KeyEqual, Stats>::maxProbeLength() const
+{
+    unsigned int longest = 0;
+    for (unsigned int i = 0; i < this->m_arrLength; ++i)
+    {
+        if (this->m_data[i].m_probeLength > longest)
+            longest = this->m_data[i].m_probeLength;
+    }
+    return longest;
+}
+
+/* returns the stats policy object - a snapshot of runs of occupied slots is taken first if stats are enabled (robin hood leaves no tombstones) */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+const Stats& HashTable_RobinHood<T, U, Hash, KeyEqual, Stats>::stats() const
+{
+    if constexpr (Stats::enabled)
+    {
+        this->beginSnapshot();
+        unsigned int runLength = 0;
+        for (unsigned int i = 0; i < this->m_arrLength; ++i)
+        {
+            if (this->m_data[i].m_probeLength != 0)
+            {
+                runLength++;
+            }
+            else if (runLength > 0)
+            {
+                this->recordChainLength(runLength);
+                runLength = 0;
+            }
+        }
+        if (runLength > 0)
+            this->recordChainLength(runLength);
+        this->recordTombstones(0, this->m_arrLength);
     }
+    return *this;
 }
 
 }; // namespace datastructlib
\ No newline at end of file
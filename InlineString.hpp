@@ -0,0 +1,105 @@
+/* Inline string - by W Denny
+    - fixed-capacity string of up to N chars stored inside the object itself, meant for short hash table keys
+    - as a hash table key the chars live inside the table's key-value pair, so inserting and finding never allocate
+      (std::string keys allocate once they outgrow the small string buffer, ~15 chars)
+    - constructing from more than N chars throws std::length_error in every build (the ctors are implicit, so a long key passed to insert/find lands here)
+    - converts implicitly to std::string_view and compares equal to std::string_view, std::string and const char*
+    - Hasher<InlineString<N>> is transparent and hashes the same as Hasher<std::string_view>, so tables with std::equal_to<> can be
+      searched by std::string_view without building an InlineString
+*/
+#pragma once
+
+#include "HashFunctions.hpp"
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+
+namespace datastructlib
+{
+
+template <unsigned int N>
+class InlineString
+{
+    static_assert((N > 0) && (N < 256), "length is stored in one byte");
+private:
+    char m_chars[N];
+    unsigned char m_length;
+public:
+    InlineString();
+    InlineString(const std::string_view& str);
+    InlineString(const char* str);
+    unsigned int length() const;
+    const char* data() const; // not null-terminated
+    std::string_view view() const;
+    operator std::string_view() const;
+
+    friend bool operator==(const InlineString& a, const InlineString& b) { return a.view() == b.view(); }
+    friend bool operator==(const InlineString& a, const std::string_view& b) { return a.view() == b; }
+    friend bool operator==(const std::string_view& a, const InlineString& b) { return a == b.view(); }
+    friend bool operator==(const InlineString& a, const char* b) { return a.view() == std::string_view(b); }
+    friend bool operator==(const char* a, const InlineString& b) { return std::string_view(a) == b.view(); }
+    friend bool operator!=(const InlineString& a, const InlineString& b) { return !(a == b); }
+    friend bool operator!=(const InlineString& a, const std::string_view& b) { return !(a == b); }
+    friend bool operator!=(const std::string_view& a, const InlineString& b) { return !(a == b); }
+    friend bool operator!=(const InlineString& a, const char* b) { return !(a == b); }
+    friend bool operator!=(const char* a, const InlineString& b) { return !(a == b); }
+    friend std::ostream& operator<<(std::ostream& os, const InlineString& str) { return os << str.view(); }
+};
+
+/* default ctor - empty string */
+template <unsigned int N>
+InlineString<N>::InlineString() : m_length(0)
+{
+}
+
+/* copies chars of str - throws std::length_error if str holds more than N chars, rather than overflowing into the neighbouring pair */
+template <unsigned int N>
+InlineString<N>::InlineString(const std::string_view& str)
+{
+    if (str.size() > N)
+        throw std::length_error("InlineString: more chars than capacity");
+    std::memcpy(this->m_chars, str.data(), str.size());
+    this->m_length = static_cast<unsigned char>(str.size());
+}
+
+/* copies chars of null-terminated str */
+template <unsigned int N>
+InlineString<N>::InlineString(const char* str) : InlineString(std::string_view(str))
+{
+}
+
+/* returns number of chars */
+template <unsigned int N>
+unsigned int InlineString<N>::length() const
+{
+    return this->m_length;
+}
+
+/* returns ptr to first char */
+template <unsigned int N>
+const char* InlineString<N>::data() const
+{
+    return this->m_chars;
+}
+
+/* returns a view of the chars */
+template <unsigned int N>
+std::string_view InlineString<N>::view() const
+{
+    return std::string_view(this->m_chars, this->m_length);
+}
+
+template <unsigned int N>
+InlineString<N>::operator std::string_view() const
+{
+    return this->view();
+}
+
+/* hashes an InlineString as its chars - same hash as the equal std::string_view */
+template <unsigned int N>
+class Hasher<InlineString<N>> : public Hasher<std::string_view>
+{
+};
+
+}; // namespace datastructlib
@@ -0,0 +1,337 @@
+/* Memory-mapped dynamic array - by W Denny
+    - dynamic array of trivially copyable elements whose storage is a file mapped into memory (POSIX mmap)
+    - the file starts with a versioned header holding the element size, length and capacity, followed directly by the elements
+    - opening an existing file maps it with zero copy, so start-up cost is independent of length - pages are faulted in on access
+    - can be opened read-only or read-write; growing a read-write array extends the file and remaps it
+    - the header is updated in place, so a file left by a process that exits without close() still holds every appended element
+*/
+#pragma once
+
+#include "DynamicArray.hpp"
+#include <cstdint>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace datastructlib
+{
+
+/* header at the start of every mapped array file - padded to 64 bytes so elements start cache line aligned */
+struct MappedArrayHeader
+{
+    uint64_t m_magic;
+    uint32_t m_version;
+    uint32_t m_elemSize;
+    uint64_t m_length;
+    uint64_t m_capacity;
+    uint8_t m_padding[32];
+
+    static constexpr uint64_t magic = 0x5941524150414D44ull; // "DMAPARAY"
+    static constexpr uint32_t version = 1;
+};
+static_assert(sizeof(MappedArrayHeader) == 64, "mapped array header must be 64 bytes");
+
+template <class T>
+class MappedDynamicArray
+{
+    static_assert(std::is_trivially_copyable<T>::value, "mapped array elements are stored as raw bytes and must be trivially copyable");
+    static_assert(alignof(T) <= sizeof(MappedArrayHeader), "element alignment must not exceed header size");
+
+private:
+    int m_fd;
+    bool m_readOnly;
+    void* m_mapPtr; // start of mapping - the header
+    size_t m_mapLength; // bytes mapped
+    unsigned int m_defaultCapacity = 16;
+
+public:
+    MappedDynamicArray();
+    MappedDynamicArray(const MappedDynamicArray&) = delete;
+    MappedDynamicArray& operator=(const MappedDynamicArray&) = delete;
+    ~MappedDynamicArray();
+
+    bool create(const char* path, const unsigned int& capacity = 16); // creates/truncates file and opens it read-write
+    bool open(const char* path, const bool& readOnly = true); // maps existing file, returns false if it is missing or has a bad header
+    void close();
+    bool sync(); // flushes dirty pages to the file
+    bool isOpen() const;
+    bool isReadOnly() const;
+
+    T get(const unsigned int& ind) const;
+    T* getPtr(const unsigned int& ind) const; // ptr into the mapping - only valid until the array next grows
+    void set(const unsigned int& ind, const T& val);
+    bool append(const T& val); // returns false, writing nothing, if the file could not grow (e.g. disk full)
+    bool appendRange(const T* vals, const unsigned int& n);
+    void removeLast();
+    void clear(); // sets length to zero - file keeps its size
+    unsigned int length() const;
+    unsigned int capacity() const;
+    bool reserve(const unsigned int& n); // extends file to hold n elements
+    void print();
+
+private:
+    MappedArrayHeader* header() const;
+    T* data() const;
+    bool mapFile(const size_t& mapLength);
+    static size_t fileLength(const unsigned int& capacity);
+};
+
+/* default ctor - not attached to any file */
+template <class T>
+MappedDynamicArray<T>::MappedDynamicArray()
+{
+    this->m_fd = -1;
+    this->m_readOnly = true;
+    this->m_mapPtr = nullptr;
+    this->m_mapLength = 0;
+}
+
+/* dtor - unmaps and closes the file, changes are left to the kernel to write back */
+template <class T>
+MappedDynamicArray<T>::~MappedDynamicArray()
+{
+    this->close();
+}
+
+/* creates (or truncates) file at path, writes an empty header and maps it read-write */
+template <class T>
+bool MappedDynamicArray<T>::create(const char* path, const unsigned int& capacity)
+{
+    this->close();
+    this->m_fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (this->m_fd < 0)
+        return false;
+    this->m_readOnly = false;
+    unsigned int initCapacity = (capacity > 0) ? capacity : this->m_defaultCapacity;
+    if ((::ftruncate(this->m_fd, fileLength(initCapacity)) != 0) || !this->mapFile(fileLength(initCapacity)))
+    {
+        this->close();
+        return false;
+    }
+    MappedArrayHeader* hdr = this->header();
+    hdr->m_magic = MappedArrayHeader::magic;
+    hdr->m_version = MappedArrayHeader::version;
+    hdr->m_elemSize = sizeof(T);
+    hdr->m_length = 0;
+    hdr->m_capacity = initCapacity;
+    return true;
+}
+
+/* maps an existing array file - no element is read or copied */
+template <class T>
+bool MappedDynamicArray<T>::open(const char* path, const bool& readOnly)
+{
+    this->close();
+    this->m_readOnly = readOnly;
+    this->m_fd = ::open(path, readOnly ? O_RDONLY : O_RDWR);
+    if (this->m_fd < 0)
+        return false;
+    struct stat st;
+    if ((::fstat(this->m_fd, &st) != 0) || (static_cast<size_t>(st.st_size) < sizeof(MappedArrayHeader)) || !this->mapFile(st.st_size))
+    {
+        this->close();
+        return false;
+    }
+    // check the file was written by this class for this element type
+    const MappedArrayHeader* hdr = this->header();
+    if ((hdr->m_magic != MappedArrayHeader::magic) || (hdr->m_version != MappedArrayHeader::version) || (hdr->m_elemSize != sizeof(T))
+        || (hdr->m_length > hdr->m_capacity) || (fileLength(hdr->m_capacity) > this->m_mapLength))
+    {
+        this->close();
+        return false;
+    }
+    return true;
+}
+
+/* unmaps and closes file */
+template <class T>
+void MappedDynamicArray<T>::close()
+{
+    if (this->m_mapPtr != nullptr)
+        ::munmap(this->m_mapPtr, this->m_mapLength);
+    if (this->m_fd >= 0)
+        ::close(this->m_fd);
+    this->m_fd = -1;
+    this->m_mapPtr = nullptr;
+    this->m_mapLength = 0;
+}
+
+/* synchronously writes dirty pages back to the file */
+template <class T>
+bool MappedDynamicArray<T>::sync()
+{
+    assert(this->isOpen());
+    if (this->m_readOnly)
+        return true;
+    return ::msync(this->m_mapPtr, this->m_mapLength, MS_SYNC) == 0;
+}
+
+/* returns true if attached to a file */
+template <class T>
+bool MappedDynamicArray<T>::isOpen() const
+{
+    return this->m_mapPtr != nullptr;
+}
+
+/* returns true if opened read-only */
+template <class T>
+bool MappedDynamicArray<T>::isReadOnly() const
+{
+    return this->m_readOnly;
+}
+
+/* returns value given index */
+template <class T>
+T MappedDynamicArray<T>::get(const unsigned int& ind) const
+{
+    assert(ind < this->length());
+    return this->data()[ind];
+}
+
+/* returns ptr of value given index */
+template <class T>
+T* MappedDynamicArray<T>::getPtr(const unsigned int& ind) const
+{
+    assert(ind < this->length());
+    return this->data() + ind;
+}
+
+/* sets value given index */
+template <class T>
+void MappedDynamicArray<T>::set(const unsigned int& ind, const T& val)
+{
+    assert(!this->m_readOnly);
+    assert(ind < this->length());
+    this->data()[ind] = val;
+}
+
+/* appends value to the end, doubling the file size when full */
+template <class T>
+bool MappedDynamicArray<T>::append(const T& val)
+{
+    return this->appendRange(&val, 1);
+}
+
+/* appends n values to the end, growing the file at most once
+    - returns false if the file could not be grown - nothing is written, and the array is closed if the remap failed (see reserve)
+*/
+template <class T>
+bool MappedDynamicArray<T>::appendRange(const T* vals, const unsigned int& n)
+{
+    assert(!this->m_readOnly);
+    unsigned int len = this->length();
+    if (len + n > this->capacity())
+    {
+        // vals may point into the mapping, which moves when the file grows - keep its offset instead
+        const bool aliased = (vals >= this->data()) && (vals < this->data() + len);
+        const size_t offset = aliased ? static_cast<size_t>(vals - this->data()) : 0;
+        if (!this->reserve(DefaultGrowthPolicy::grow(this->capacity(), len + n)))
+            return false;
+        if (aliased)
+            vals = this->data() + offset;
+    }
+    std::memcpy(static_cast<void*>(this->data() + len), static_cast<const void*>(vals), sizeof(T) * n);
+    this->header()->m_length = len + n; // length only published once the elements are written
+    return true;
+}
+
+/* removes last element */
+template <class T>
+void MappedDynamicArray<T>::removeLast()
+{
+    assert(!this->m_readOnly);
+    assert(this->length() > 0);
+    this->header()->m_length--;
+}
+
+/* sets length to zero */
+template <class T>
+void MappedDynamicArray<T>::clear()
+{
+    assert(!this->m_readOnly);
+    this->header()->m_length = 0;
+}
+
+/* returns length of array */
+template <class T>
+unsigned int MappedDynamicArray<T>::length() const
+{
+    return this->isOpen() ? static_cast<unsigned int>(this->header()->m_length) : 0;
+}
+
+/* returns number of elements the file can hold before it must grow */
+template <class T>
+unsigned int MappedDynamicArray<T>::capacity() const
+{
+    return this->isOpen() ? static_cast<unsigned int>(this->header()->m_capacity) : 0;
+}
+
+/* extends the file to hold n elements and remaps it - never shrinks
+    - returns false if the file can't be extended, leaving the array as it was, or can't be remapped, in which case it is closed
+*/
+template <class T>
+bool MappedDynamicArray<T>::reserve(const unsigned int& n)
+{
+    assert(this->isOpen() && !this->m_readOnly);
+    if (n <= this->capacity())
+        return true;
+    if (::ftruncate(this->m_fd, fileLength(n)) != 0)
+        return false;
+    ::munmap(this->m_mapPtr, this->m_mapLength);
+    this->m_mapPtr = nullptr;
+    if (!this->mapFile(fileLength(n)))
+    {
+        this->close();
+        return false;
+    }
+    this->header()->m_capacity = n;
+    return true;
+}
+
+/* prints array */
+template <class T>
+void MappedDynamicArray<T>::print()
+{
+    for (unsigned int i = 0; i < this->length(); ++i)
+    {
+        std::cout << "(" << i << "): " << this->data()[i] << std::endl;
+    }
+}
+
+/* returns ptr to header at start of the mapping */
+template <class T>
+MappedArrayHeader* MappedDynamicArray<T>::header() const
+{
+    return static_cast<MappedArrayHeader*>(this->m_mapPtr);
+}
+
+/* returns ptr to first element, directly after the header */
+template <class T>
+T* MappedDynamicArray<T>::data() const
+{
+    return reinterpret_cast<T*>(static_cast<unsigned char*>(this->m_mapPtr) + sizeof(MappedArrayHeader));
+}
+
+/* maps the first mapLength bytes of the open file */
+template <class T>
+bool MappedDynamicArray<T>::mapFile(const size_t& mapLength)
+{
+    int prot = this->m_readOnly ? PROT_READ : (PROT_READ | PROT_WRITE);
+    void* ptr = ::mmap(nullptr, mapLength, prot, MAP_SHARED, this->m_fd, 0);
+    if (ptr == MAP_FAILED)
+        return false;
+    this->m_mapPtr = ptr;
+    this->m_mapLength = mapLength;
+    return true;
+}
+
+/* returns file size in bytes for given capacity */
+template <class T>
+size_t MappedDynamicArray<T>::fileLength(const unsigned int& capacity)
+{
+    return sizeof(MappedArrayHeader) + sizeof(T) * static_cast<size_t>(capacity);
+}
+
+} // namespace datastructlib
@@ -0,0 +1,467 @@
+/* Memory-mapped hash table - by W Denny
+    - immutable hash table snapshot stored in a file that is used straight from an mmap, with no deserialization at start-up
+    - MappedHashTableWriter collects pairs (or every pair of an existing table through forEach) and writes the file once
+    - the file holds a header, an array of fixed-size slots and a blob region holding the key and value bytes
+    - slots refer to the blob by offset, so the file is position independent and can be mapped at any address by any process
+    - slots keep the full 64-bit Hasher hash; Hasher is unseeded and gives the same hash on every target, so a file can be written on one machine and read on another
+    - MappedHashTable maps the file read-only and answers find with linear probing over the mapped slots - pages are faulted in as lookups touch them
+    - keys and values are either trivially copyable (stored as their bytes) or strings (stored as chars and read back as std::string_view into the mapping)
+    - the writer replaces the file by rename, so processes that still map an old snapshot keep a valid mapping
+    - only the header and the offsets of the regions are checked on open - slot contents are trusted, so only map files from a trusted writer
+*/
+#pragma once
+
+#include "DynamicArray.hpp"
+#include "HashFunctions.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace datastructlib
+{
+
+/* header at the start of every mapped hash table file - 64 bytes so the slots start cache line aligned
+    - written in native byte order; the magic reads back wrong on a machine of the other byte order, so open fails there
+*/
+struct MappedHashHeader
+{
+    uint64_t m_magic;
+    uint32_t m_version;
+    uint32_t m_slotSize;
+    uint64_t m_numSlots; // power of two
+    uint64_t m_numEntries;
+    uint64_t m_slotsOffset; // from start of file
+    uint64_t m_blobOffset; // from start of file
+    uint64_t m_blobLength;
+    uint32_t m_keyTag; // MappedHashCodec<T>::tag of the key type
+    uint32_t m_valTag; // MappedHashCodec<U>::tag of the value type
+
+    static constexpr uint64_t magic = 0x4853414850414D44ull; // "DMAPHASH"
+    static constexpr uint32_t version = 1;
+};
+static_assert(sizeof(MappedHashHeader) == 64, "mapped hash table header must be 64 bytes");
+
+/* one slot of the mapped table - the key bytes start at m_offset in the blob and the value bytes follow them directly */
+struct MappedHashSlot
+{
+    uint64_t m_hash;
+    uint64_t m_offset; // emptyOffset for an empty slot
+    uint32_t m_keyLength;
+    uint32_t m_valLength;
+
+    static constexpr uint64_t emptyOffset = ~0ull;
+};
+static_assert(sizeof(MappedHashSlot) == 24, "mapped hash table slot must be 24 bytes");
+
+namespace detail
+{
+
+/* type tag of a trivially copyable type - its size in the low 16 bits and its kind above, so e.g. uint32_t, int and float all differ
+    - kinds: 1 bool, 2 unsigned integer, 3 signed integer, 4 floating point, 5 enum, 0 anything else (structs, arrays)
+    - two types of the same size and kind (two 8-byte structs, or int32_t and an int-based typedef) can't be told apart
+*/
+template <class T>
+constexpr uint32_t mappedHashTypeTag()
+{
+    uint32_t kind = std::is_same<T, bool>::value ? 1
+        : std::is_integral<T>::value ? (std::is_signed<T>::value ? 3 : 2)
+        : std::is_floating_point<T>::value ? 4
+        : std::is_enum<T>::value ? 5
+        : 0;
+    return (kind << 16) | static_cast<uint32_t>(sizeof(T));
+}
+
+} // namespace detail
+
+/* converts keys and values to and from their bytes in the blob
+    - trivially copyable types are stored as their bytes and read back by copy
+    - View is the type find takes and returns - the type itself here, std::string_view for strings
+    - tag is written to the header so a file is only opened with key and value types of the size and kind it was written with (see mappedHashTypeTag)
+*/
+template <class T>
+class MappedHashCodec
+{
+    static_assert(std::is_trivially_copyable<T>::value, "mapped hash table keys and values must be trivially copyable or strings");
+public:
+    using View = T;
+    static constexpr uint32_t tag = detail::mappedHashTypeTag<T>();
+
+    static uint32_t length(const T& val)
+    {
+        return sizeof(T);
+    }
+    static void write(const T& val, unsigned char* dst)
+    {
+        std::memcpy(static_cast<void*>(dst), static_cast<const void*>(&val), sizeof(T));
+    }
+    static View read(const unsigned char* src, const uint32_t& length)
+    {
+        T val;
+        std::memcpy(static_cast<void*>(&val), static_cast<const void*>(src), sizeof(T)); // blob bytes carry no alignment
+        return val;
+    }
+};
+
+namespace detail
+{
+
+/* strings are stored as their chars without a terminator and read back as a view into the mapping */
+class MappedHashStringCodec
+{
+public:
+    using View = std::string_view;
+    static constexpr uint32_t tag = 0;
+
+    static uint32_t length(const std::string_view& val)
+    {
+        return static_cast<uint32_t>(val.size());
+    }
+    static void write(const std::string_view& val, unsigned char* dst)
+    {
+        std::memcpy(static_cast<void*>(dst), static_cast<const void*>(val.data()), val.size());
+    }
+    static View read(const unsigned char* src, const uint32_t& length)
+    {
+        return std::string_view(reinterpret_cast<const char*>(src), length);
+    }
+};
+
+} // namespace detail
+
+template <>
+class MappedHashCodec<std::string> : public detail::MappedHashStringCodec
+{
+};
+
+template <>
+class MappedHashCodec<std::string_view> : public detail::MappedHashStringCodec
+{
+};
+
+/* collects pairs in memory and writes them as a mapped hash table file
+    - adding a key twice keeps the last value
+*/
+template <class T, class U, class Hash = Hasher<T>>
+class MappedHashTableWriter
+{
+private:
+    DynamicArray<MappedHashSlot> m_entries; // one slot per added pair, placed into the slot array by write
+    std::vector<unsigned char> m_blob; // key and value bytes - may exceed 4GB, so not a DynamicArray
+    Hash m_hash;
+
+public:
+    MappedHashTableWriter(const Hash& hash = Hash());
+    void add(const T& key, const U& val);
+    template <class Table>
+    void addTable(const Table& table); // adds every pair of a table with forEach, e.g. HashTable_Swiss or HashTable_FlatOpenAddressing
+    unsigned int size() const;
+    bool write(const char* path, const double& maxLoadFactor = 0.5) const; // writes path.tmp, then renames it over path
+};
+
+/* read-only view of a mapped hash table file */
+template <class T, class U, class Hash = Hasher<T>>
+class MappedHashTable
+{
+public:
+    using KeyView = typename MappedHashCodec<T>::View;
+    using ValView = typename MappedHashCodec<U>::View;
+
+private:
+    int m_fd;
+    void* m_mapPtr;
+    size_t m_mapLength;
+    const MappedHashSlot* m_slots;
+    const unsigned char* m_blob;
+    uint64_t m_mask; // number of slots - 1
+    Hash m_hash;
+
+public:
+    MappedHashTable(const Hash& hash = Hash());
+    MappedHashTable(const MappedHashTable&) = delete;
+    MappedHashTable& operator=(const MappedHashTable&) = delete;
+    ~MappedHashTable();
+
+    bool open(const char* path); // maps the file read-only, returns false if it is missing, truncated or written for key/value types of another size or kind
+    void close();
+    bool isOpen() const;
+    unsigned int size() const;
+    bool find(const KeyView& key, ValView& val) const; // sets val and returns true if key is present - string views point into the mapping
+    bool contains(const KeyView& key) const;
+    template <class F>
+    void forEach(F f) const; // calls f(key, val) with views of every pair, in slot order
+
+private:
+    const MappedHashHeader* header() const;
+    const MappedHashSlot* findSlot(const KeyView& key) const; // returns nullptr if key is not present
+};
+
+/* ctor */
+template <class T, class U, class Hash>
+MappedHashTableWriter<T, U, Hash>::MappedHashTableWriter(const Hash& hash) : m_hash(hash)
+{
+}
+
+/* copies key and value bytes into the blob and records their slot */
+template <class T, class U, class Hash>
+void MappedHashTableWriter<T, U, Hash>::add(const T& key, const U& val)
+{
+    MappedHashSlot entry;
+    entry.m_hash = static_cast<uint64_t>(this->m_hash(key));
+    entry.m_offset = this->m_blob.size();
+    entry.m_keyLength = MappedHashCodec<T>::length(key);
+    entry.m_valLength = MappedHashCodec<U>::length(val);
+    this->m_blob.resize(this->m_blob.size() + entry.m_keyLength + entry.m_valLength);
+    MappedHashCodec<T>::write(key, this->m_blob.data() + entry.m_offset);
+    MappedHashCodec<U>::write(val, this->m_blob.data() + entry.m_offset + entry.m_keyLength);
+    this->m_entries.append(entry);
+}
+
+/* adds every pair of table */
+template <class T, class U, class Hash>
+template <class Table>
+void MappedHashTableWriter<T, U, Hash>::addTable(const Table& table)
+{
+    table.forEach([this](const T& key, const U& val) { this->add(key, val); });
+}
+
+/* returns number of pairs added, counting repeated keys */
+template <class T, class U, class Hash>
+unsigned int MappedHashTableWriter<T, U, Hash>::size() const
+{
+    return this->m_entries.length();
+}
+
+/* lays out the file in a mapping of path.tmp and renames it to path once it is complete
+    - the slot array is the smallest power of two keeping the load factor at or below maxLoadFactor
+    - the blob is copied as one block, slots are placed by linear probing from hash & mask
+*/
+template <class T, class U, class Hash>
+bool MappedHashTableWriter<T, U, Hash>::write(const char* path, const double& maxLoadFactor) const
+{
+    assert((maxLoadFactor > 0.0) && (maxLoadFactor < 1.0)); // lookups stop at an empty slot, so one must always exist
+    uint64_t numSlots = 1;
+    while (static_cast<double>(this->m_entries.length()) > maxLoadFactor * static_cast<double>(numSlots))
+    {
+        numSlots <<= 1;
+    }
+    const uint64_t slotsOffset = sizeof(MappedHashHeader);
+    const uint64_t blobOffset = slotsOffset + numSlots * sizeof(MappedHashSlot);
+    const uint64_t fileLength = blobOffset + this->m_blob.size();
+
+    std::string tmpPath = std::string(path) + ".tmp";
+    int fd = ::open(tmpPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return false;
+    void* mapPtr = MAP_FAILED;
+    if (::ftruncate(fd, fileLength) == 0)
+        mapPtr = ::mmap(nullptr, fileLength, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapPtr == MAP_FAILED)
+    {
+        ::close(fd);
+        ::unlink(tmpPath.c_str());
+        return false;
+    }
+    unsigned char* filePtr = static_cast<unsigned char*>(mapPtr);
+    MappedHashSlot* slots = reinterpret_cast<MappedHashSlot*>(filePtr + slotsOffset);
+    for (uint64_t i = 0; i < numSlots; ++i)
+    {
+        slots[i].m_offset = MappedHashSlot::emptyOffset;
+    }
+    const uint64_t mask = numSlots - 1;
+    uint64_t numEntries = 0;
+    for (unsigned int i = 0; i < this->m_entries.length(); ++i)
+    {
+        const MappedHashSlot& entry = *this->m_entries.getPtr(i);
+        uint64_t ind = entry.m_hash & mask;
+        while (slots[ind].m_offset != MappedHashSlot::emptyOffset)
+        {
+            const MappedHashSlot& slot = slots[ind];
+            if ((slot.m_hash == entry.m_hash) && (slot.m_keyLength == entry.m_keyLength)
+                && (std::memcmp(this->m_blob.data() + slot.m_offset, this->m_blob.data() + entry.m_offset, entry.m_keyLength) == 0))
+            {
+                break; // repeated key - later value replaces the earlier one
+            }
+            ind = (ind + 1) & mask;
+        }
+        if (slots[ind].m_offset == MappedHashSlot::emptyOffset)
+            numEntries++;
+        slots[ind] = entry;
+    }
+    if (!this->m_blob.empty())
+        std::memcpy(filePtr + blobOffset, this->m_blob.data(), this->m_blob.size());
+
+    MappedHashHeader* hdr = reinterpret_cast<MappedHashHeader*>(filePtr);
+    hdr->m_version = MappedHashHeader::version;
+    hdr->m_slotSize = sizeof(MappedHashSlot);
+    hdr->m_numSlots = numSlots;
+    hdr->m_numEntries = numEntries;
+    hdr->m_slotsOffset = slotsOffset;
+    hdr->m_blobOffset = blobOffset;
+    hdr->m_blobLength = this->m_blob.size();
+    hdr->m_keyTag = MappedHashCodec<T>::tag;
+    hdr->m_valTag = MappedHashCodec<U>::tag;
+    hdr->m_magic = MappedHashHeader::magic; // written last - a file cut short never has a valid header
+
+    bool written = (::msync(mapPtr, fileLength, MS_SYNC) == 0);
+    ::munmap(mapPtr, fileLength);
+    ::close(fd);
+    if (!written || (::rename(tmpPath.c_str(), path) != 0))
+    {
+        ::unlink(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+/* ctor - not attached to any file */
+template <class T, class U, class Hash>
+MappedHashTable<T, U, Hash>::MappedHashTable(const Hash& hash) : m_hash(hash)
+{
+    this->m_fd = -1;
+    this->m_mapPtr = nullptr;
+    this->m_mapLength = 0;
+    this->m_slots = nullptr;
+    this->m_blob = nullptr;
+    this->m_mask = 0;
+}
+
+/* dtor - unmaps and closes the file */
+template <class T, class U, class Hash>
+MappedHashTable<T, U, Hash>::~MappedHashTable()
+{
+    this->close();
+}
+
+/* maps the file at path read-only - nothing but the header is read */
+template <class T, class U, class Hash>
+bool MappedHashTable<T, U, Hash>::open(const char* path)
+{
+    this->close();
+    this->m_fd = ::open(path, O_RDONLY);
+    if (this->m_fd < 0)
+        return false;
+    struct stat st;
+    if ((::fstat(this->m_fd, &st) != 0) || (static_cast<size_t>(st.st_size) < sizeof(MappedHashHeader)))
+    {
+        this->close();
+        return false;
+    }
+    void* ptr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, this->m_fd, 0);
+    if (ptr == MAP_FAILED)
+    {
+        this->close();
+        return false;
+    }
+    this->m_mapPtr = ptr;
+    this->m_mapLength = st.st_size;
+    // check the file was written for these key and value types and its regions lie inside it
+    const MappedHashHeader* hdr = this->header();
+    if ((hdr->m_magic != MappedHashHeader::magic) || (hdr->m_version != MappedHashHeader::version) || (hdr->m_slotSize != sizeof(MappedHashSlot))
+        || (hdr->m_keyTag != MappedHashCodec<T>::tag) || (hdr->m_valTag != MappedHashCodec<U>::tag)
+        || (hdr->m_numSlots == 0) || ((hdr->m_numSlots & (hdr->m_numSlots - 1)) != 0) || (hdr->m_numEntries >= hdr->m_numSlots)
+        || (hdr->m_slotsOffset % alignof(MappedHashSlot) != 0) || (hdr->m_slotsOffset + hdr->m_numSlots * sizeof(MappedHashSlot) > hdr->m_blobOffset)
+        || (hdr->m_blobOffset + hdr->m_blobLength > this->m_mapLength))
+    {
+        this->close();
+        return false;
+    }
+    const unsigned char* filePtr = static_cast<const unsigned char*>(this->m_mapPtr);
+    this->m_slots = reinterpret_cast<const MappedHashSlot*>(filePtr + hdr->m_slotsOffset);
+    this->m_blob = filePtr + hdr->m_blobOffset;
+    this->m_mask = hdr->m_numSlots - 1;
+    return true;
+}
+
+/* unmaps and closes file - views returned by find are invalid afterwards */
+template <class T, class U, class Hash>
+void MappedHashTable<T, U, Hash>::close()
+{
+    if (this->m_mapPtr != nullptr)
+        ::munmap(this->m_mapPtr, this->m_mapLength);
+    if (this->m_fd >= 0)
+        ::close(this->m_fd);
+    this->m_fd = -1;
+    this->m_mapPtr = nullptr;
+    this->m_mapLength = 0;
+    this->m_slots = nullptr;
+    this->m_blob = nullptr;
+    this->m_mask = 0;
+}
+
+/* returns true if attached to a file */
+template <class T, class U, class Hash>
+bool MappedHashTable<T, U, Hash>::isOpen() const
+{
+    return this->m_mapPtr != nullptr;
+}
+
+/* returns number of pairs */
+template <class T, class U, class Hash>
+unsigned int MappedHashTable<T, U, Hash>::size() const
+{
+    return this->isOpen() ? static_cast<unsigned int>(this->header()->m_numEntries) : 0;
+}
+
+/* finds key and reads its value */
+template <class T, class U, class Hash>
+bool MappedHashTable<T, U, Hash>::find(const KeyView& key, ValView& val) const
+{
+    const MappedHashSlot* slot = this->findSlot(key);
+    if (slot == nullptr)
+        return false;
+    val = MappedHashCodec<U>::read(this->m_blob + slot->m_offset + slot->m_keyLength, slot->m_valLength);
+    return true;
+}
+
+/* returns true if key is present */
+template <class T, class U, class Hash>
+bool MappedHashTable<T, U, Hash>::contains(const KeyView& key) const
+{
+    return this->findSlot(key) != nullptr;
+}
+
+/* calls f(key, val) for every pair */
+template <class T, class U, class Hash>
+template <class F>
+void MappedHashTable<T, U, Hash>::forEach(F f) const
+{
+    if (!this->isOpen())
+        return;
+    for (uint64_t i = 0; i <= this->m_mask; ++i)
+    {
+        const MappedHashSlot& slot = this->m_slots[i];
+        if (slot.m_offset != MappedHashSlot::emptyOffset)
+            f(MappedHashCodec<T>::read(this->m_blob + slot.m_offset, slot.m_keyLength), MappedHashCodec<U>::read(this->m_blob + slot.m_offset + slot.m_keyLength, slot.m_valLength));
+    }
+}
+
+/* returns ptr to header at start of the mapping */
+template <class T, class U, class Hash>
+const MappedHashHeader* MappedHashTable<T, U, Hash>::header() const
+{
+    return static_cast<const MappedHashHeader*>(this->m_mapPtr);
+}
+
+/* linear probe from hash & mask - the full hash is compared before any key bytes are read */
+template <class T, class U, class Hash>
+const MappedHashSlot* MappedHashTable<T, U, Hash>::findSlot(const KeyView& key) const
+{
+    assert(this->isOpen());
+    const uint64_t hash = static_cast<uint64_t>(this->m_hash(key));
+    for (uint64_t ind = hash & this->m_mask; ; ind = (ind + 1) & this->m_mask)
+    {
+        const MappedHashSlot& slot = this->m_slots[ind];
+        if (slot.m_offset == MappedHashSlot::emptyOffset)
+            return nullptr;
+        if ((slot.m_hash == hash) && (MappedHashCodec<T>::read(this->m_blob + slot.m_offset, slot.m_keyLength) == key))
+            return &slot;
+    }
+}
+
+}; // namespace datastructlib
@@ -0,0 +1,278 @@
+/* Packed integer array - by W Denny
+    - dynamic array of unsigned integers stored with a fixed number of bits each (1 to 64), packed end to end into 64-bit words
+    - the bit width is set at runtime and widens automatically when a value that needs more bits is set or appended
+    - widening repacks every element once, so a width can grow at most 63 times over the life of the array
+    - element i occupies bits [i * width, (i + 1) * width) of the word stream, possibly straddling two words
+    - unpack decodes a range into a caller buffer; with AVX2 it decodes 4 or 8 elements per step using gathers
+    - one zero padding word is kept after the last used word so that unaligned 64-bit reads near the end stay in bounds
+*/
+#pragma once
+
+#include "DynamicArray.hpp"
+#include <cstdint>
+
+namespace datastructlib
+{
+
+class PackedIntArray
+{
+private:
+    DynamicArray<uint64_t> m_words;
+    unsigned int m_length;
+    unsigned int m_bitWidth;
+
+public:
+    PackedIntArray(const unsigned int& bitWidth = 1);
+
+    uint64_t get(const unsigned int& ind) const;
+    void set(const unsigned int& ind, const uint64_t& val); // widens if val needs more bits
+    void append(const uint64_t& val); // widens if val needs more bits
+    void removeLast();
+    void clear(); // keeps bit width
+    template <class U>
+    void unpack(const unsigned int& first, const unsigned int& count, U* out) const; // decodes [first, first + count) into out
+    unsigned int length() const;
+    unsigned int bitWidth() const;
+    void setBitWidth(const unsigned int& bitWidth); // repacks - new width must hold every stored value
+    unsigned long long memoryBytes() const; // bytes of word storage in use
+    void print();
+
+    static unsigned int bitsNeeded(const uint64_t& val); // minimum width that can hold val
+
+private:
+    uint64_t mask() const;
+    const unsigned char* bytes() const;
+    void write(const unsigned int& ind, const uint64_t& val); // val must fit in the current width
+    void resizeWords(const unsigned int& length); // keeps enough words for length elements plus one padding word
+};
+
+/* ctor with initial bit width */
+inline PackedIntArray::PackedIntArray(const unsigned int& bitWidth)
+{
+    assert((bitWidth >= 1) && (bitWidth <= 64));
+    this->m_length = 0;
+    this->m_bitWidth = bitWidth;
+    this->resizeWords(0);
+}
+
+/* returns value given index - reads one or two words */
+inline uint64_t PackedIntArray::get(const unsigned int& ind) const
+{
+    assert(ind < this->m_length);
+    unsigned long long bitPos = static_cast<unsigned long long>(ind) * this->m_bitWidth;
+    unsigned int word = static_cast<unsigned int>(bitPos >> 6);
+    unsigned int shift = static_cast<unsigned int>(bitPos & 63);
+    const uint64_t* words = this->m_words.getPtr(0);
+    uint64_t val = words[word] >> shift;
+    if (shift + this->m_bitWidth > 64)
+        val |= words[word + 1] << (64 - shift); // value straddles into next word
+    return val & this->mask();
+}
+
+/* sets value given index, widening first if required */
+inline void PackedIntArray::set(const unsigned int& ind, const uint64_t& val)
+{
+    assert(ind < this->m_length);
+    if (bitsNeeded(val) > this->m_bitWidth)
+        this->setBitWidth(bitsNeeded(val));
+    this->write(ind, val);
+}
+
+/* appends value, widening first if required */
+inline void PackedIntArray::append(const uint64_t& val)
+{
+    if (bitsNeeded(val) > this->m_bitWidth)
+        this->setBitWidth(bitsNeeded(val));
+    this->resizeWords(this->m_length + 1);
+    this->m_length++;
+    this->write(this->m_length - 1, val);
+}
+
+/* removes last element */
+inline void PackedIntArray::removeLast()
+{
+    assert(this->m_length > 0);
+    this->write(this->m_length - 1, 0); // keep unused bits zero
+    this->m_length--;
+    this->resizeWords(this->m_length);
+}
+
+/* clears array */
+inline void PackedIntArray::clear()
+{
+    this->m_words.clear();
+    this->m_length = 0;
+    this->resizeWords(0);
+}
+
+/* returns length of array */
+inline unsigned int PackedIntArray::length() const
+{
+    return this->m_length;
+}
+
+/* returns bits per element */
+inline unsigned int PackedIntArray::bitWidth() const
+{
+    return this->m_bitWidth;
+}
+
+/* repacks every element with the new width */
+inline void PackedIntArray::setBitWidth(const unsigned int& bitWidth)
+{
+    assert((bitWidth >= 1) && (bitWidth <= 64));
+    if (bitWidth == this->m_bitWidth)
+        return;
+    PackedIntArray tmp(bitWidth);
+    tmp.resizeWords(this->m_length);
+    tmp.m_length = this->m_length;
+    for (unsigned int i = 0; i < this->m_length; ++i)
+    {
+        uint64_t val = this->get(i);
+        assert(bitsNeeded(val) <= bitWidth); // narrowing must not lose bits
+        tmp.write(i, val);
+    }
+    this->m_words.swap(tmp.m_words);
+    this->m_bitWidth = bitWidth;
+}
+
+/* returns bytes used by the packed words */
+inline unsigned long long PackedIntArray::memoryBytes() const
+{
+    return static_cast<unsigned long long>(this->m_words.length()) * sizeof(uint64_t);
+}
+
+/* prints array */
+inline void PackedIntArray::print()
+{
+    for (unsigned int i = 0; i < this->m_length; ++i)
+    {
+        std::cout << "(" << i << "): " << this->get(i) << std::endl;
+    }
+}
+
+/* returns number of bits needed to represent val - at least one */
+inline unsigned int PackedIntArray::bitsNeeded(const uint64_t& val)
+{
+    return (val == 0) ? 1 : 64 - __builtin_clzll(val);
+}
+
+/* returns mask of the low bitWidth bits */
+inline uint64_t PackedIntArray::mask() const
+{
+    return (this->m_bitWidth == 64) ? ~0ull : ((1ull << this->m_bitWidth) - 1);
+}
+
+/* returns word storage as bytes for unaligned reads */
+inline const unsigned char* PackedIntArray::bytes() const
+{
+    return reinterpret_cast<const unsigned char*>(this->m_words.getPtr(0));
+}
+
+/* writes val into the bits of element ind */
+inline void PackedIntArray::write(const unsigned int& ind, const uint64_t& val)
+{
+    unsigned long long bitPos = static_cast<unsigned long long>(ind) * this->m_bitWidth;
+    unsigned int word = static_cast<unsigned int>(bitPos >> 6);
+    unsigned int shift = static_cast<unsigned int>(bitPos & 63);
+    uint64_t* words = this->m_words.getPtr(0);
+    words[word] = (words[word] & ~(this->mask() << shift)) | (val << shift);
+    if (shift + this->m_bitWidth > 64)
+    {
+        unsigned int spill = 64 - shift; // bits already written to the first word
+        uint64_t highMask = this->mask() >> spill;
+        words[word + 1] = (words[word + 1] & ~highMask) | (val >> spill);
+    }
+}
+
+/* grows/shrinks word storage to fit length elements plus a zero padding word */
+inline void PackedIntArray::resizeWords(const unsigned int& length)
+{
+    unsigned long long bits = static_cast<unsigned long long>(length) * this->m_bitWidth;
+    unsigned int numWords = static_cast<unsigned int>((bits + 63) >> 6) + 1;
+    while (this->m_words.length() < numWords)
+    {
+        this->m_words.append(0);
+    }
+    if (this->m_words.length() > numWords)
+    {
+        this->m_words.removeRange(numWords, this->m_words.length());
+        *this->m_words.getPtr(numWords - 1) = 0; // padding word must stay zero
+    }
+}
+
+namespace detail
+{
+
+#ifdef DATASTRUCTLIB_SIMD_X86
+
+/* decodes count elements of width <= 25 into 32-bit outputs, 8 per step
+    - each lane gathers 4 bytes from the byte holding its first bit, then shifts and masks - 7 + 25 bits always fit
+*/
+DATASTRUCTLIB_TARGET_AVX2 inline unsigned int unpackAvx2(const unsigned char* bytes, unsigned long long bitPos, const unsigned int& bitWidth, const unsigned int& count, uint32_t* out)
+{
+    const __m256i laneBits = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(static_cast<int>(bitWidth)));
+    const __m256i seven = _mm256_set1_epi32(7);
+    const __m256i mask = _mm256_set1_epi32(static_cast<int>((1u << bitWidth) - 1));
+    unsigned int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const unsigned char* base = bytes + (bitPos >> 3);
+        __m256i bits = _mm256_add_epi32(laneBits, _mm256_set1_epi32(static_cast<int>(bitPos & 7)));
+        __m256i vals = _mm256_i32gather_epi32(reinterpret_cast<const int*>(base), _mm256_srli_epi32(bits, 3), 1);
+        vals = _mm256_and_si256(_mm256_srlv_epi32(vals, _mm256_and_si256(bits, seven)), mask);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), vals);
+        bitPos += 8ull * bitWidth;
+    }
+    return i;
+}
+
+/* decodes count elements of width <= 57 into 64-bit outputs, 4 per step - 7 + 57 bits fit in one 8 byte gather */
+DATASTRUCTLIB_TARGET_AVX2 inline unsigned int unpackAvx2(const unsigned char* bytes, unsigned long long bitPos, const unsigned int& bitWidth, const unsigned int& count, uint64_t* out)
+{
+    const __m256i laneBits = _mm256_setr_epi64x(0, bitWidth, 2ll * bitWidth, 3ll * bitWidth);
+    const __m256i seven = _mm256_set1_epi64x(7);
+    const __m256i mask = _mm256_set1_epi64x(static_cast<long long>((1ull << bitWidth) - 1));
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const unsigned char* base = bytes + (bitPos >> 3);
+        __m256i bits = _mm256_add_epi64(laneBits, _mm256_set1_epi64x(static_cast<long long>(bitPos & 7)));
+        __m256i vals = _mm256_i64gather_epi64(reinterpret_cast<const long long*>(base), _mm256_srli_epi64(bits, 3), 1);
+        vals = _mm256_and_si256(_mm256_srlv_epi64(vals, _mm256_and_si256(bits, seven)), mask);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), vals);
+        bitPos += 4ull * bitWidth;
+    }
+    return i;
+}
+
+#endif // DATASTRUCTLIB_SIMD_X86
+
+} // namespace detail
+
+/* decodes elements [first, first + count) into out
+    - out may be 32-bit (width must be <= 32) or 64-bit; AVX2 handles widths up to 25 and 57 respectively, the rest is scalar
+    - vector reads stay within the padding word: the last gather starts at most 7 bytes before the last used bit
+*/
+template <class U>
+void PackedIntArray::unpack(const unsigned int& first, const unsigned int& count, U* out) const
+{
+    static_assert(std::is_unsigned<U>::value && ((sizeof(U) == 4) || (sizeof(U) == 8)), "unpack writes 32-bit or 64-bit unsigned integers");
+    assert(first + count <= this->m_length);
+    assert(sizeof(U) * 8 >= this->m_bitWidth);
+    unsigned int done = 0;
+#ifdef DATASTRUCTLIB_SIMD_X86
+    const unsigned int maxSimdWidth = (sizeof(U) == 4) ? 25 : 57;
+    if ((this->m_bitWidth <= maxSimdWidth) && simd::detail::hasAvx2())
+    {
+        typedef typename std::conditional<sizeof(U) == 4, uint32_t, uint64_t>::type LaneType;
+        done = detail::unpackAvx2(this->bytes(), static_cast<unsigned long long>(first) * this->m_bitWidth, this->m_bitWidth, count, reinterpret_cast<LaneType*>(out));
+    }
+#endif
+    for (unsigned int i = done; i < count; ++i)
+    {
+        out[i] = static_cast<U>(this->get(first + i));
+    }
+}
+
+} // namespace datastructlib
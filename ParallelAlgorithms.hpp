@@ -0,0 +1,219 @@
+/* Parallel algorithms over DynamicArray - by W Denny
+    - reduce, transform, for-each and inclusive/exclusive scan split the array's contiguous storage into one chunk per thread
+    - chunk boundaries are rounded to cache line addresses so that threads writing neighbouring chunks never share a line
+    - numThreads = 0 uses std::thread::hardware_concurrency(); arrays too short to be worth splitting run on the calling thread
+    - reduce and scan operators must be associative, as partial results of each chunk are combined in order
+    - requires linking with the platform thread library (e.g. -pthread)
+*/
+#pragma once
+
+#include "DynamicArray.hpp"
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace datastructlib
+{
+
+namespace detail
+{
+
+const unsigned int cacheLineLength = 64;
+const unsigned int parallelMinChunkLength = 1 << 14; // fewer elements than this per thread is not worth a thread
+
+/* returns number of threads to use for n elements */
+inline unsigned int parallelThreadCount(const unsigned int& n, const unsigned int& numThreads)
+{
+    unsigned int threads = (numThreads > 0) ? numThreads : std::thread::hardware_concurrency();
+    if (threads == 0)
+        threads = 1;
+    unsigned int maxUseful = n / parallelMinChunkLength;
+    if (threads > maxUseful)
+        threads = (maxUseful > 0) ? maxUseful : 1;
+    return threads;
+}
+
+/* returns chunk boundaries [bounds[c], bounds[c + 1]) splitting n elements into roughly equal non-empty chunks
+    - interior boundaries are moved up to the next cache line address when whole elements fit in a line
+*/
+template <class T>
+std::vector<unsigned int> chunkBounds(const T* data, const unsigned int& n, const unsigned int& numChunks)
+{
+    std::vector<unsigned int> bounds;
+    bounds.push_back(0);
+    for (unsigned int c = 1; c < numChunks; ++c)
+    {
+        unsigned int split = static_cast<unsigned int>((static_cast<unsigned long long>(n) * c) / numChunks);
+        if (cacheLineLength % sizeof(T) == 0)
+        {
+            unsigned int misalign = static_cast<unsigned int>(reinterpret_cast<uintptr_t>(data + split) % cacheLineLength) / sizeof(T);
+            if (misalign != 0)
+                split += cacheLineLength / sizeof(T) - misalign;
+        }
+        if ((split > bounds.back()) && (split < n))
+            bounds.push_back(split);
+    }
+    bounds.push_back(n);
+    return bounds;
+}
+
+/* runs fn(chunk, begin, end) for every chunk - chunk 0 runs on the calling thread */
+template <class Fn>
+void runChunks(const std::vector<unsigned int>& bounds, Fn fn)
+{
+    unsigned int numChunks = static_cast<unsigned int>(bounds.size()) - 1;
+    std::vector<std::thread> threads;
+    threads.reserve(numChunks - 1);
+    for (unsigned int c = 1; c < numChunks; ++c)
+    {
+        threads.emplace_back([&fn, &bounds, c]() { fn(c, bounds[c], bounds[c + 1]); });
+    }
+    fn(0, bounds[0], bounds[1]);
+    for (unsigned int i = 0; i < threads.size(); ++i)
+    {
+        threads[i].join();
+    }
+}
+
+/* reduces non-empty range [begin, end) starting from its first element */
+template <class T, class Op>
+T reduceRange(const T* data, const unsigned int& begin, const unsigned int& end, Op& op)
+{
+    T acc = data[begin];
+    for (unsigned int i = begin + 1; i < end; ++i)
+    {
+        acc = op(acc, data[i]);
+    }
+    return acc;
+}
+
+} // namespace detail
+
+/* returns init op arr[0] op arr[1] op ... - each thread reduces one chunk and the partial results are combined in order */
+template <class T, class G, class Op>
+T parallelReduce(const DynamicArray<T, G>& arr, const T& init, Op op, const unsigned int& numThreads = 0)
+{
+    unsigned int n = arr.length();
+    if (n == 0)
+        return init;
+    const T* data = arr.getPtr(0);
+    std::vector<unsigned int> bounds = detail::chunkBounds(data, n, detail::parallelThreadCount(n, numThreads));
+    std::vector<T> partials(bounds.size() - 1, init);
+    detail::runChunks(bounds, [&](const unsigned int& c, const unsigned int& begin, const unsigned int& end) {
+        partials[c] = detail::reduceRange(data, begin, end, op);
+    });
+    T result = init;
+    for (unsigned int c = 0; c < partials.size(); ++c)
+    {
+        result = op(result, partials[c]);
+    }
+    return result;
+}
+
+/* replaces every element with f(element) */
+template <class T, class G, class F>
+void parallelTransform(DynamicArray<T, G>& arr, F f, const unsigned int& numThreads = 0)
+{
+    unsigned int n = arr.length();
+    if (n == 0)
+        return;
+    T* data = arr.getPtr(0);
+    std::vector<unsigned int> bounds = detail::chunkBounds(data, n, detail::parallelThreadCount(n, numThreads));
+    detail::runChunks(bounds, [&](const unsigned int&, const unsigned int& begin, const unsigned int& end) {
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            data[i] = f(data[i]);
+        }
+    });
+}
+
+/* calls f(element, index) for every element - f may modify the element but must not touch other elements */
+template <class T, class G, class F>
+void parallelForEach(DynamicArray<T, G>& arr, F f, const unsigned int& numThreads = 0)
+{
+    unsigned int n = arr.length();
+    if (n == 0)
+        return;
+    T* data = arr.getPtr(0);
+    std::vector<unsigned int> bounds = detail::chunkBounds(data, n, detail::parallelThreadCount(n, numThreads));
+    detail::runChunks(bounds, [&](const unsigned int&, const unsigned int& begin, const unsigned int& end) {
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            f(data[i], i);
+        }
+    });
+}
+
+/* in-place inclusive scan: arr[i] becomes arr[0] op ... op arr[i]
+    - pass 1 reduces each chunk, the chunk totals are scanned on the calling thread, pass 2 scans each chunk starting from its carry
+*/
+template <class T, class G, class Op>
+void parallelInclusiveScan(DynamicArray<T, G>& arr, Op op, const unsigned int& numThreads = 0)
+{
+    unsigned int n = arr.length();
+    if (n == 0)
+        return;
+    T* data = arr.getPtr(0);
+    std::vector<unsigned int> bounds = detail::chunkBounds(data, n, detail::parallelThreadCount(n, numThreads));
+    unsigned int numChunks = static_cast<unsigned int>(bounds.size()) - 1;
+    std::vector<T> carries;
+    carries.reserve(numChunks);
+    if (numChunks > 1)
+    {
+        std::vector<T> partials(numChunks, data[0]);
+        detail::runChunks(bounds, [&](const unsigned int& c, const unsigned int& begin, const unsigned int& end) {
+            if (c + 1 < bounds.size() - 1) // last chunk total is never needed
+                partials[c] = detail::reduceRange(data, begin, end, op);
+        });
+        carries.push_back(partials[0]); // carry into chunk 1
+        for (unsigned int c = 1; c + 1 < numChunks; ++c)
+        {
+            carries.push_back(op(carries.back(), partials[c]));
+        }
+    }
+    detail::runChunks(bounds, [&](const unsigned int& c, const unsigned int& begin, const unsigned int& end) {
+        T acc = (c == 0) ? data[begin] : op(carries[c - 1], data[begin]);
+        data[begin] = acc;
+        for (unsigned int i = begin + 1; i < end; ++i)
+        {
+            acc = op(acc, data[i]);
+            data[i] = acc;
+        }
+    });
+}
+
+/* in-place exclusive scan: arr[i] becomes init op arr[0] op ... op arr[i - 1], so arr[0] becomes init */
+template <class T, class G, class Op>
+void parallelExclusiveScan(DynamicArray<T, G>& arr, const T& init, Op op, const unsigned int& numThreads = 0)
+{
+    unsigned int n = arr.length();
+    if (n == 0)
+        return;
+    T* data = arr.getPtr(0);
+    std::vector<unsigned int> bounds = detail::chunkBounds(data, n, detail::parallelThreadCount(n, numThreads));
+    unsigned int numChunks = static_cast<unsigned int>(bounds.size()) - 1;
+    std::vector<T> carries(numChunks, init);
+    if (numChunks > 1)
+    {
+        std::vector<T> partials(numChunks, init);
+        detail::runChunks(bounds, [&](const unsigned int& c, const unsigned int& begin, const unsigned int& end) {
+            if (c + 1 < bounds.size() - 1)
+                partials[c] = detail::reduceRange(data, begin, end, op);
+        });
+        for (unsigned int c = 1; c < numChunks; ++c)
+        {
+            carries[c] = op(carries[c - 1], partials[c - 1]);
+        }
+    }
+    detail::runChunks(bounds, [&](const unsigned int& c, const unsigned int& begin, const unsigned int& end) {
+        T acc = carries[c];
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            T val = data[i];
+            data[i] = acc;
+            acc = op(acc, val);
+        }
+    });
+}
+
+} // namespace datastructlib
@@ -0,0 +1,393 @@
+/* Perfect hash - by W Denny
+    - minimal perfect hash over a fixed set of n keys (PTHash style): every key of the set gets its own index in [0, n), with no collisions to probe past
+    - keys are hashed into buckets of about perfectHashBucketLength keys; each bucket stores one small pilot value, and a key's position is a hash of its own hash and its bucket's pilot
+    - build places the largest buckets first, trying pilots 0, 1, 2... until every key of the bucket lands on a free position
+    - positions range over m = n / perfectHashLoadFactor slots, so the last buckets still find free positions quickly; the few keys placed at or beyond n are sent to the unused positions below n by a remap array
+    - pilots are stored in a PackedIntArray at the width of the largest pilot, so the function takes a few bits per key
+    - evaluating it reads one pilot (and, for about one key in fifty, one remap entry) - there is no probing and no key comparison
+    - keys outside the set map to an arbitrary index, so maps built on it store the keys and compare them once
+    - PerfectHashFunctor is a HashFunctor, so it can be passed to the existing tables; StaticHashMap stores the pairs at their perfect index
+*/
+#pragma once
+
+#include "HashTable.hpp"
+#include "PackedIntArray.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace datastructlib
+{
+
+constexpr unsigned int perfectHashBucketLength = 4; // average keys per bucket - larger buckets take fewer pilots but longer pilot searches
+constexpr double perfectHashLoadFactor = 0.98; // n / m - the share of positions left free for the last buckets to land on
+constexpr unsigned int perfectHashMaxPilot = 1u << 20; // a bucket needing more tries restarts the build with a new seed
+constexpr unsigned int perfectHashMaxSeeds = 8; // every seed failing means the keys repeat
+
+namespace detail
+{
+
+/* maps a well mixed 64-bit hash onto [0, n) with a multiply instead of a modulo */
+inline uint64_t fastRange(uint64_t hash, uint64_t n)
+{
+    mumPair(hash, n);
+    return n; // high half of hash * n
+}
+
+} // namespace detail
+
+template <class T, class H = Hasher<T>>
+class PerfectHashFunctor : public HashFunctor<T>
+{
+private:
+    PackedIntArray m_pilots; // one per bucket
+    DynamicArray<unsigned int> m_remap; // index for each position in [n, m) - only entries of taken positions are used
+    unsigned int m_numKeys; // n
+    unsigned int m_numPositions; // m
+    unsigned int m_numBuckets;
+    uint64_t m_seed;
+    H m_hash;
+
+public:
+    PerfectHashFunctor(const H& hash = H());
+    bool build(const DynamicArray<T>& keys); // returns false if a key repeats
+    unsigned int operator()(const T& key, const unsigned int& arrLength) override; // keys of the set never collide for any arrLength >= size()
+    unsigned int index(const T& key) const; // index in [0, size()) - unique for each key of the set
+    unsigned int size() const;
+    unsigned long long memoryBytes() const; // pilots and remap array
+    double bitsPerKey() const;
+
+private:
+    uint64_t keyHash(const T& key) const;
+    unsigned int bucket(const uint64_t& hash) const;
+    unsigned int position(const uint64_t& hash, const uint64_t& pilot) const; // position in [0, m)
+    bool buildWithSeed(const std::vector<uint64_t>& hashes);
+};
+
+/* key-value pair of a static hash map - no slot state is needed as every slot is full */
+template <class T, class U>
+class StaticHashMap_Entry
+{
+public:
+    T m_key;
+    U m_val;
+    StaticHashMap_Entry(const T& key, const U& val) : m_key(key), m_val(val) {}
+};
+
+/* immutable map built once from arrays of keys and values
+    - a pair is stored at the perfect hash index of its key, so memory is n pairs plus the few bits per key of the perfect hash
+    - find reads the pilot and then the pair, and compares the key once to reject keys outside the set
+*/
+template <class T, class U, class H = Hasher<T>, class KeyEqual = std::equal_to<T>>
+class StaticHashMap
+{
+private:
+    PerfectHashFunctor<T, H> m_perfectHash;
+    StaticHashMap_Entry<T, U>* m_entries; // raw storage - constructed by build
+    unsigned int m_numEntries;
+    KeyEqual m_keyEqual;
+
+public:
+    StaticHashMap(const H& hash = H(), const KeyEqual& keyEqual = KeyEqual());
+    StaticHashMap(const StaticHashMap&) = delete;
+    StaticHashMap& operator=(const StaticHashMap&) = delete;
+    ~StaticHashMap();
+    bool build(const DynamicArray<T>& keys, const DynamicArray<U>& vals); // replaces any earlier contents, returns false if a key repeats
+    bool find(const T& key, U& val) const; // sets val and returns true if key is present
+    bool contains(const T& key) const;
+    unsigned int size() const;
+    unsigned long long memoryBytes() const; // pairs plus perfect hash
+    const PerfectHashFunctor<T, H>& perfectHash() const;
+
+private:
+    void destroyEntries();
+};
+
+/* ctor - empty function, build must be called before use */
+template <class T, class H>
+PerfectHashFunctor<T, H>::PerfectHashFunctor(const H& hash) : m_hash(hash)
+{
+    this->m_numKeys = 0;
+    this->m_numPositions = 0;
+    this->m_numBuckets = 0;
+    this->m_seed = 0;
+}
+
+/* builds the function over keys, retrying with new seeds if a bucket's pilot search runs too long */
+template <class T, class H>
+bool PerfectHashFunctor<T, H>::build(const DynamicArray<T>& keys)
+{
+    this->m_numKeys = keys.length();
+    this->m_numPositions = this->m_numKeys + static_cast<unsigned int>(this->m_numKeys * (1.0 - perfectHashLoadFactor) / perfectHashLoadFactor);
+    this->m_numBuckets = (this->m_numKeys + perfectHashBucketLength - 1) / perfectHashBucketLength;
+    std::vector<uint64_t> hashes(this->m_numKeys);
+    for (unsigned int seed = 0; seed < perfectHashMaxSeeds; ++seed)
+    {
+        this->m_seed = hashInteger(seed);
+        for (unsigned int i = 0; i < this->m_numKeys; ++i)
+        {
+            hashes[i] = this->keyHash(keys.get(i));
+        }
+        if (this->buildWithSeed(hashes))
+            return true;
+    }
+    this->m_numKeys = 0;
+    this->m_numPositions = 0;
+    this->m_numBuckets = 0;
+    return false;
+}
+
+/* HashFunctor interface - indices are stretched evenly over longer arrays, so empty slots sit between keys and a missing key stops probing early
+    - stretching keeps distinct indices distinct; arrays shorter than the key set wrap with a modulo
+*/
+template <class T, class H>
+unsigned int PerfectHashFunctor<T, H>::operator()(const T& key, const unsigned int& arrLength)
+{
+    unsigned int ind = this->index(key);
+    if (arrLength >= this->m_numKeys)
+        return static_cast<unsigned int>((static_cast<uint64_t>(ind) * arrLength) / this->m_numKeys);
+    return ind % arrLength;
+}
+
+/* returns the index of key */
+template <class T, class H>
+unsigned int PerfectHashFunctor<T, H>::index(const T& key) const
+{
+    assert(this->m_numKeys > 0);
+    uint64_t hash = this->keyHash(key);
+    unsigned int pos = this->position(hash, this->m_pilots.get(this->bucket(hash)));
+    return (pos < this->m_numKeys) ? pos : this->m_remap.get(pos - this->m_numKeys);
+}
+
+/* returns number of keys */
+template <class T, class H>
+unsigned int PerfectHashFunctor<T, H>::size() const
+{
+    return this->m_numKeys;
+}
+
+/* returns bytes used by pilots and remap array */
+template <class T, class H>
+unsigned long long PerfectHashFunctor<T, H>::memoryBytes() const
+{
+    return this->m_pilots.memoryBytes() + static_cast<unsigned long long>(this->m_remap.length()) * sizeof(unsigned int);
+}
+
+/* returns memoryBytes in bits per key */
+template <class T, class H>
+double PerfectHashFunctor<T, H>::bitsPerKey() const
+{
+    return (this->m_numKeys == 0) ? 0.0 : (8.0 * this->memoryBytes()) / this->m_numKeys;
+}
+
+/* hashes key with the current seed */
+template <class T, class H>
+uint64_t PerfectHashFunctor<T, H>::keyHash(const T& key) const
+{
+    return hashCombine(this->m_seed, static_cast<uint64_t>(this->m_hash(key)));
+}
+
+/* returns bucket of hash - taken from the high bits */
+template <class T, class H>
+unsigned int PerfectHashFunctor<T, H>::bucket(const uint64_t& hash) const
+{
+    return static_cast<unsigned int>(detail::fastRange(hash, this->m_numBuckets));
+}
+
+/* returns position of hash for pilot - remixed, as keys sharing a bucket share the high bits of their hash */
+template <class T, class H>
+unsigned int PerfectHashFunctor<T, H>::position(const uint64_t& hash, const uint64_t& pilot) const
+{
+    return static_cast<unsigned int>(detail::fastRange(hashInteger(hash ^ pilot), this->m_numPositions));
+}
+
+/* finds a pilot for every bucket, largest bucket first, then fills the remap array - returns false if any bucket needs too many tries */
+template <class T, class H>
+bool PerfectHashFunctor<T, H>::buildWithSeed(const std::vector<uint64_t>& hashes)
+{
+    // counting sort of hashes by bucket
+    std::vector<unsigned int> bucketStart(this->m_numBuckets + 1, 0);
+    for (unsigned int i = 0; i < this->m_numKeys; ++i)
+    {
+        bucketStart[this->bucket(hashes[i]) + 1]++;
+    }
+    unsigned int maxBucketLength = 0;
+    for (unsigned int b = 0; b < this->m_numBuckets; ++b)
+    {
+        maxBucketLength = (bucketStart[b + 1] > maxBucketLength) ? bucketStart[b + 1] : maxBucketLength;
+        bucketStart[b + 1] += bucketStart[b];
+    }
+    std::vector<uint64_t> bucketHashes(this->m_numKeys);
+    std::vector<unsigned int> fill(bucketStart.begin(), bucketStart.end() - 1);
+    for (unsigned int i = 0; i < this->m_numKeys; ++i)
+    {
+        bucketHashes[fill[this->bucket(hashes[i])]++] = hashes[i];
+    }
+
+    // counting sort of buckets by length, longest first
+    std::vector<unsigned int> lengthStart(maxBucketLength + 2, 0);
+    for (unsigned int b = 0; b < this->m_numBuckets; ++b)
+    {
+        lengthStart[maxBucketLength - (bucketStart[b + 1] - bucketStart[b]) + 1]++;
+    }
+    for (unsigned int l = 0; l <= maxBucketLength; ++l)
+    {
+        lengthStart[l + 1] += lengthStart[l];
+    }
+    std::vector<unsigned int> order(this->m_numBuckets);
+    for (unsigned int b = 0; b < this->m_numBuckets; ++b)
+    {
+        order[lengthStart[maxBucketLength - (bucketStart[b + 1] - bucketStart[b])]++] = b;
+    }
+
+    // pilot search
+    std::vector<uint64_t> taken((this->m_numPositions + 63) / 64, 0);
+    std::vector<unsigned int> pilots(this->m_numBuckets, 0);
+    std::vector<unsigned int> positions(maxBucketLength);
+    uint64_t maxPilot = 0;
+    for (unsigned int o = 0; o < this->m_numBuckets; ++o)
+    {
+        const unsigned int b = order[o];
+        const unsigned int first = bucketStart[b], length = bucketStart[b + 1] - first;
+        if (length == 0)
+            break; // every later bucket is empty too
+        uint64_t pilot = 0;
+        for (; pilot < perfectHashMaxPilot; ++pilot)
+        {
+            unsigned int placed = 0;
+            for (; placed < length; ++placed)
+            {
+                unsigned int pos = this->position(bucketHashes[first + placed], pilot);
+                if ((taken[pos >> 6] >> (pos & 63)) & 1)
+                    break;
+                unsigned int j = 0;
+                while ((j < placed) && (positions[j] != pos))
+                    ++j;
+                if (j < placed)
+                    break; // two keys of the bucket on one position
+                positions[placed] = pos;
+            }
+            if (placed == length)
+                break;
+        }
+        if (pilot == perfectHashMaxPilot)
+            return false; // keys with equal hashes can never be separated
+        for (unsigned int j = 0; j < length; ++j)
+        {
+            taken[positions[j] >> 6] |= 1ull << (positions[j] & 63);
+        }
+        pilots[b] = static_cast<unsigned int>(pilot);
+        maxPilot = (pilot > maxPilot) ? pilot : maxPilot;
+    }
+
+    this->m_pilots = PackedIntArray(PackedIntArray::bitsNeeded(maxPilot));
+    for (unsigned int b = 0; b < this->m_numBuckets; ++b)
+    {
+        this->m_pilots.append(pilots[b]);
+    }
+
+    // positions taken at or beyond n are sent to the positions left free below n, one each
+    this->m_remap.clear();
+    this->m_remap.reserve(this->m_numPositions - this->m_numKeys);
+    unsigned int freePos = 0;
+    for (unsigned int pos = this->m_numKeys; pos < this->m_numPositions; ++pos)
+    {
+        if ((taken[pos >> 6] >> (pos & 63)) & 1)
+        {
+            while ((taken[freePos >> 6] >> (freePos & 63)) & 1)
+                ++freePos;
+            this->m_remap.append(freePos++);
+        }
+        else
+        {
+            this->m_remap.append(0);
+        }
+    }
+    return true;
+}
+
+/* ctor - empty map, build must be called before use */
+template <class T, class U, class H, class KeyEqual>
+StaticHashMap<T, U, H, KeyEqual>::StaticHashMap(const H& hash, const KeyEqual& keyEqual) : m_perfectHash(hash), m_keyEqual(keyEqual)
+{
+    this->m_entries = nullptr;
+    this->m_numEntries = 0;
+}
+
+/* dtor */
+template <class T, class U, class H, class KeyEqual>
+StaticHashMap<T, U, H, KeyEqual>::~StaticHashMap()
+{
+    this->destroyEntries();
+}
+
+/* builds the perfect hash over keys and stores each pair at its key's index */
+template <class T, class U, class H, class KeyEqual>
+bool StaticHashMap<T, U, H, KeyEqual>::build(const DynamicArray<T>& keys, const DynamicArray<U>& vals)
+{
+    assert(keys.length() == vals.length());
+    this->destroyEntries();
+    if ((keys.length() == 0) || !this->m_perfectHash.build(keys))
+        return keys.length() == 0;
+    this->m_numEntries = keys.length();
+    this->m_entries = detail::allocateStorage<StaticHashMap_Entry<T, U>>(this->m_numEntries);
+    for (unsigned int i = 0; i < this->m_numEntries; ++i)
+    {
+        ::new (static_cast<void*>(this->m_entries + this->m_perfectHash.index(keys.get(i)))) StaticHashMap_Entry<T, U>(keys.get(i), vals.get(i));
+    }
+    return true;
+}
+
+/* finds key and copies its value */
+template <class T, class U, class H, class KeyEqual>
+bool StaticHashMap<T, U, H, KeyEqual>::find(const T& key, U& val) const
+{
+    if (this->m_numEntries == 0)
+        return false;
+    const StaticHashMap_Entry<T, U>& entry = this->m_entries[this->m_perfectHash.index(key)];
+    if (!this->m_keyEqual(entry.m_key, key))
+        return false;
+    val = entry.m_val;
+    return true;
+}
+
+/* returns true if key is present */
+template <class T, class U, class H, class KeyEqual>
+bool StaticHashMap<T, U, H, KeyEqual>::contains(const T& key) const
+{
+    return (this->m_numEntries > 0) && this->m_keyEqual(this->m_entries[this->m_perfectHash.index(key)].m_key, key);
+}
+
+/* returns number of pairs */
+template <class T, class U, class H, class KeyEqual>
+unsigned int StaticHashMap<T, U, H, KeyEqual>::size() const
+{
+    return this->m_numEntries;
+}
+
+/* returns bytes used by pairs and perfect hash */
+template <class T, class U, class H, class KeyEqual>
+unsigned long long StaticHashMap<T, U, H, KeyEqual>::memoryBytes() const
+{
+    return static_cast<unsigned long long>(this->m_numEntries) * sizeof(StaticHashMap_Entry<T, U>) + this->m_perfectHash.memoryBytes();
+}
+
+/* returns the perfect hash function */
+template <class T, class U, class H, class KeyEqual>
+const PerfectHashFunctor<T, H>& StaticHashMap<T, U, H, KeyEqual>::perfectHash() const
+{
+    return this->m_perfectHash;
+}
+
+/* destroys pairs and frees their storage */
+template <class T, class U, class H, class KeyEqual>
+void StaticHashMap<T, U, H, KeyEqual>::destroyEntries()
+{
+    if (this->m_entries == nullptr)
+        return;
+    detail::destroyRange(this->m_entries, this->m_numEntries);
+    detail::deallocateStorage(this->m_entries);
+    this->m_entries = nullptr;
+    this->m_numEntries = 0;
+}
+
+}; // namespace datastructlib
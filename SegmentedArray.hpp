@@ -0,0 +1,228 @@
+/* Segmented array - by W Denny
+    - elements are stored in fixed-size chunks of 2^ChunkLengthLog2 elements, with a DynamicArray of chunk ptrs as the directory
+    - index access is O(1): the high bits of the index pick the chunk and the low bits the slot inside it
+    - appending never moves existing elements, only the directory of chunk ptrs is ever reallocated
+    - therefore ptrs returned by getPtr stay valid until that element is removed, and growth has no full-buffer copy
+    - only supports adding/removing at the end, as inserting or removing in the middle would have to move elements
+*/
+#pragma once
+
+#include "DynamicArray.hpp"
+
+namespace datastructlib
+{
+
+template <class T, unsigned int ChunkLengthLog2 = 10>
+class SegmentedArray
+{
+    static_assert(ChunkLengthLog2 < 31, "chunk length must fit in an unsigned int");
+
+private:
+    DynamicArray<T*> m_chunks; // directory of chunks - each holds raw storage for chunkLength elements
+    unsigned int m_length;
+
+public:
+    static constexpr unsigned int chunkLength = 1u << ChunkLengthLog2;
+
+    SegmentedArray();
+    SegmentedArray(const SegmentedArray&);
+    SegmentedArray(SegmentedArray&&) noexcept;
+    ~SegmentedArray();
+    SegmentedArray& operator=(SegmentedArray); // copy-and-swap
+    void swap(SegmentedArray&) noexcept;
+
+    T get(const unsigned int& ind) const;
+    T* getPtr(const unsigned int& ind) const; // stays valid until the element is removed
+    void set(const unsigned int& ind, const T& val);
+    void append(const T& val);
+    void append(T&& val);
+    template <class... Args>
+    T& emplaceBack(Args&&... args);
+    void removeLast();
+    void clear();
+    unsigned int length() const;
+    unsigned int capacity() const; // elements that fit in the allocated chunks
+    void reserve(const unsigned int& n); // allocates chunks up front for n elements
+    void print();
+
+private:
+    void freeSpareChunks(); // frees trailing chunks, keeping at most one empty chunk
+};
+
+/* default ctor - no chunk is allocated until the first append */
+template <class T, unsigned int ChunkLengthLog2>
+SegmentedArray<T, ChunkLengthLog2>::SegmentedArray()
+{
+    this->m_length = 0;
+}
+
+/* copy ctor */
+template <class T, unsigned int ChunkLengthLog2>
+SegmentedArray<T, ChunkLengthLog2>::SegmentedArray(const SegmentedArray<T, ChunkLengthLog2>& arr)
+{
+    this->m_length = 0;
+    this->reserve(arr.m_length);
+    for (unsigned int i = 0; i < arr.m_length; ++i)
+    {
+        this->emplaceBack(*arr.getPtr(i));
+    }
+}
+
+/* move ctor - takes the chunks, element addresses are unchanged */
+template <class T, unsigned int ChunkLengthLog2>
+SegmentedArray<T, ChunkLengthLog2>::SegmentedArray(SegmentedArray<T, ChunkLengthLog2>&& arr) noexcept
+    : m_chunks(std::move(arr.m_chunks))
+{
+    this->m_length = arr.m_length;
+    arr.m_length = 0;
+}
+
+/* dtor */
+template <class T, unsigned int ChunkLengthLog2>
+SegmentedArray<T, ChunkLengthLog2>::~SegmentedArray()
+{
+    this->clear();
+}
+
+/* assignment - parameter is already a copy (or moved-into object), so just swap with it */
+template <class T, unsigned int ChunkLengthLog2>
+SegmentedArray<T, ChunkLengthLog2>& SegmentedArray<T, ChunkLengthLog2>::operator=(SegmentedArray<T, ChunkLengthLog2> arr)
+{
+    this->swap(arr);
+    return *this;
+}
+
+/* swaps contents with another array */
+template <class T, unsigned int ChunkLengthLog2>
+void SegmentedArray<T, ChunkLengthLog2>::swap(SegmentedArray<T, ChunkLengthLog2>& arr) noexcept
+{
+    this->m_chunks.swap(arr.m_chunks);
+    std::swap(this->m_length, arr.m_length);
+}
+
+/* returns value given index */
+template <class T, unsigned int ChunkLengthLog2>
+T SegmentedArray<T, ChunkLengthLog2>::get(const unsigned int& ind) const
+{
+    return *this->getPtr(ind);
+}
+
+/* returns ptr of value given index - chunk from high bits, slot from low bits */
+template <class T, unsigned int ChunkLengthLog2>
+T* SegmentedArray<T, ChunkLengthLog2>::getPtr(const unsigned int& ind) const
+{
+    assert(ind < this->m_length);
+    return *this->m_chunks.getPtr(ind >> ChunkLengthLog2) + (ind & (chunkLength - 1));
+}
+
+/* sets value given index */
+template <class T, unsigned int ChunkLengthLog2>
+void SegmentedArray<T, ChunkLengthLog2>::set(const unsigned int& ind, const T& val)
+{
+    *this->getPtr(ind) = val;
+}
+
+/* appends element to the end */
+template <class T, unsigned int ChunkLengthLog2>
+void SegmentedArray<T, ChunkLengthLog2>::append(const T& val)
+{
+    this->emplaceBack(val);
+}
+
+/* appends element to the end by moving it */
+template <class T, unsigned int ChunkLengthLog2>
+void SegmentedArray<T, ChunkLengthLog2>::append(T&& val)
+{
+    this->emplaceBack(std::move(val));
+}
+
+/* constructs new element at the end - allocates a new chunk when the last one is full, existing elements never move */
+template <class T, unsigned int ChunkLengthLog2>
+template <class... Args>
+T& SegmentedArray<T, ChunkLengthLog2>::emplaceBack(Args&&... args)
+{
+    if (this->m_length == this->capacity())
+    {
+        this->m_chunks.append(detail::allocateStorage<T>(chunkLength));
+    }
+    T* slot = *this->m_chunks.getPtr(this->m_length >> ChunkLengthLog2) + (this->m_length & (chunkLength - 1));
+    ::new (static_cast<void*>(slot)) T(std::forward<Args>(args)...);
+    this->m_length++;
+    return *slot;
+}
+
+/* removes last element */
+template <class T, unsigned int ChunkLengthLog2>
+void SegmentedArray<T, ChunkLengthLog2>::removeLast()
+{
+    assert(this->m_length > 0);
+    this->getPtr(this->m_length - 1)->~T();
+    this->m_length--;
+    this->freeSpareChunks();
+}
+
+/* destroys all elements and frees every chunk */
+template <class T, unsigned int ChunkLengthLog2>
+void SegmentedArray<T, ChunkLengthLog2>::clear()
+{
+    for (unsigned int c = 0; c < this->m_chunks.length(); ++c)
+    {
+        T* chunk = this->m_chunks.get(c);
+        unsigned int chunkStart = c << ChunkLengthLog2;
+        if (chunkStart < this->m_length)
+            detail::destroyRange(chunk, (this->m_length - chunkStart < chunkLength) ? this->m_length - chunkStart : chunkLength);
+        detail::deallocateStorage(chunk);
+    }
+    this->m_chunks.clear();
+    this->m_length = 0;
+}
+
+/* returns length of array */
+template <class T, unsigned int ChunkLengthLog2>
+unsigned int SegmentedArray<T, ChunkLengthLog2>::length() const
+{
+    return this->m_length;
+}
+
+/* returns number of elements that fit in the allocated chunks */
+template <class T, unsigned int ChunkLengthLog2>
+unsigned int SegmentedArray<T, ChunkLengthLog2>::capacity() const
+{
+    return this->m_chunks.length() << ChunkLengthLog2;
+}
+
+/* allocates enough chunks to hold n elements */
+template <class T, unsigned int ChunkLengthLog2>
+void SegmentedArray<T, ChunkLengthLog2>::reserve(const unsigned int& n)
+{
+    unsigned int numChunks = (n >> ChunkLengthLog2) + ((n & (chunkLength - 1)) ? 1 : 0);
+    this->m_chunks.reserve(numChunks);
+    while (this->m_chunks.length() < numChunks)
+    {
+        this->m_chunks.append(detail::allocateStorage<T>(chunkLength));
+    }
+}
+
+/* prints array */
+template <class T, unsigned int ChunkLengthLog2>
+void SegmentedArray<T, ChunkLengthLog2>::print()
+{
+    for (unsigned int i = 0; i < this->m_length; ++i)
+    {
+        std::cout << "(" << i << "): " << *this->getPtr(i) << std::endl;
+    }
+}
+
+/* frees trailing empty chunks but keeps one spare, so removes/appends around a chunk boundary don't allocate every call */
+template <class T, unsigned int ChunkLengthLog2>
+void SegmentedArray<T, ChunkLengthLog2>::freeSpareChunks()
+{
+    unsigned int usedChunks = (this->m_length >> ChunkLengthLog2) + ((this->m_length & (chunkLength - 1)) ? 1 : 0);
+    while (this->m_chunks.length() > usedChunks + 1)
+    {
+        detail::deallocateStorage(this->m_chunks.get(this->m_chunks.length() - 1));
+        this->m_chunks.remove(this->m_chunks.length() - 1);
+    }
+}
+
+} // namespace datastructlib
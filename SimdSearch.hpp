@@ -0,0 +1,371 @@
+/* SIMD search kernels - by W Denny
+    - equality scans over contiguous arrays of arithmetic type, used by DynamicArray::contains, valIndArr and removeVal
+    - SSE2 (16 bytes per compare) and AVX2 (32 bytes per compare) versions, AVX2 is picked at runtime if the cpu supports it
+    - scalar versions are used for other targets, or everywhere if DATASTRUCTLIB_NO_SIMD is defined
+    - compare masks are byte masks from movemask, so an element of size s owns s consecutive bits of the mask
+*/
+#pragma once
+
+#include <type_traits>
+#include <cstdint>
+#include <cstring>
+
+#if !defined(DATASTRUCTLIB_NO_SIMD) && (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define DATASTRUCTLIB_SIMD_X86 1
+#include <immintrin.h>
+#define DATASTRUCTLIB_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace datastructlib
+{
+namespace simd
+{
+
+/* element types the kernels support - equality of these types is decided by comparing lanes */
+template <class T>
+struct isSearchable : std::integral_constant<bool, std::is_arithmetic<T>::value && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)>
+{
+};
+
+namespace detail
+{
+
+/* scalar versions - used as fallback and for the tail of every vector loop */
+template <class T>
+unsigned int findFirstScalar(const T* data, unsigned int i, const unsigned int& n, const T& val)
+{
+    for (; i < n; ++i)
+    {
+        if (data[i] == val)
+            return i;
+    }
+    return n;
+}
+
+template <class T>
+unsigned int findAllScalar(const T* data, unsigned int i, const unsigned int& n, const T& val, unsigned int* out, unsigned int found, const unsigned int& indexOffset)
+{
+    for (; i < n; ++i)
+    {
+        if (data[i] == val)
+            out[found++] = indexOffset + i;
+    }
+    return found;
+}
+
+template <class T>
+unsigned int removeAllScalar(T* data, unsigned int i, const unsigned int& n, const T& val, unsigned int kept)
+{
+    for (; i < n; ++i)
+    {
+        if (!(data[i] == val))
+            data[kept++] = data[i];
+    }
+    return kept;
+}
+
+/* bits of the byte mask that belong to the lowest element */
+template <class T>
+constexpr unsigned int elemMaskBits()
+{
+    return (1u << sizeof(T)) - 1;
+}
+
+#ifdef DATASTRUCTLIB_SIMD_X86
+
+/* permutation table for compressing 8 x 32-bit lanes - entry m lists the lanes whose bit is set in m, lowest first */
+struct CompressTable
+{
+    uint8_t m_lanes[256][8];
+    constexpr CompressTable() : m_lanes()
+    {
+        for (unsigned int m = 0; m < 256; ++m)
+        {
+            unsigned int k = 0;
+            for (unsigned int j = 0; j < 8; ++j)
+            {
+                if (m & (1u << j))
+                    this->m_lanes[m][k++] = j;
+            }
+        }
+    }
+};
+inline constexpr CompressTable compressTable;
+
+/* returns true once if the running cpu supports AVX2 */
+inline bool hasAvx2()
+{
+    static const bool has = __builtin_cpu_supports("avx2");
+    return has;
+}
+
+/**** SSE2 ****/
+
+template <class T>
+inline __m128i broadcast128(const T& val)
+{
+    if constexpr (sizeof(T) == 1) { int8_t bits; std::memcpy(&bits, &val, 1); return _mm_set1_epi8(bits); }
+    else if constexpr (sizeof(T) == 2) { int16_t bits; std::memcpy(&bits, &val, 2); return _mm_set1_epi16(bits); }
+    else if constexpr (sizeof(T) == 4) { int32_t bits; std::memcpy(&bits, &val, 4); return _mm_set1_epi32(bits); }
+    else { int64_t bits; std::memcpy(&bits, &val, 8); return _mm_set1_epi64x(bits); }
+}
+
+/* lanes equal to v are set to all ones - floating point uses float compares so that NaN != NaN and -0 == +0 */
+template <class T>
+inline __m128i equal128(const __m128i& x, const __m128i& v)
+{
+    if constexpr (std::is_floating_point<T>::value && sizeof(T) == 4) return _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(x), _mm_castsi128_ps(v)));
+    else if constexpr (std::is_floating_point<T>::value) return _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(x), _mm_castsi128_pd(v)));
+    else if constexpr (sizeof(T) == 1) return _mm_cmpeq_epi8(x, v);
+    else if constexpr (sizeof(T) == 2) return _mm_cmpeq_epi16(x, v);
+    else if constexpr (sizeof(T) == 4) return _mm_cmpeq_epi32(x, v);
+    else
+    {
+        __m128i c = _mm_cmpeq_epi32(x, v); // no 64-bit compare in SSE2 - both 32-bit halves must match
+        return _mm_and_si128(c, _mm_shuffle_epi32(c, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+}
+
+template <class T>
+unsigned int findFirstSse2(const T* data, const unsigned int& n, const T& val)
+{
+    const unsigned int width = 16 / sizeof(T);
+    const __m128i v = broadcast128(val);
+    unsigned int i = 0;
+    for (; i + width <= n; i += width)
+    {
+        unsigned int mask = _mm_movemask_epi8(equal128<T>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), v));
+        if (mask != 0)
+            return i + __builtin_ctz(mask) / sizeof(T);
+    }
+    return findFirstScalar(data, i, n, val);
+}
+
+template <class T>
+unsigned int findAllSse2(const T* data, const unsigned int& n, const T& val, unsigned int* out, const unsigned int& indexOffset)
+{
+    const unsigned int width = 16 / sizeof(T);
+    const __m128i v = broadcast128(val);
+    unsigned int found = 0;
+    unsigned int i = 0;
+    for (; i + width <= n; i += width)
+    {
+        unsigned int mask = _mm_movemask_epi8(equal128<T>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), v));
+        while (mask != 0)
+        {
+            unsigned int bit = __builtin_ctz(mask);
+            out[found++] = indexOffset + i + bit / sizeof(T);
+            mask &= ~(elemMaskBits<T>() << bit);
+        }
+    }
+    return findAllScalar(data, i, n, val, out, found, indexOffset);
+}
+
+template <class T>
+unsigned int removeAllSse2(T* data, const unsigned int& n, const T& val)
+{
+    const unsigned int width = 16 / sizeof(T);
+    const __m128i v = broadcast128(val);
+    unsigned int kept = 0;
+    unsigned int i = 0;
+    for (; i + width <= n; i += width)
+    {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        unsigned int mask = _mm_movemask_epi8(equal128<T>(x, v));
+        if (mask == 0)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(data + kept), x); // whole block kept - kept <= i so the block was loaded before being overwritten
+            kept += width;
+        }
+        else
+        {
+            for (unsigned int j = 0; j < width; ++j)
+            {
+                if (((mask >> (j * sizeof(T))) & 1) == 0)
+                    data[kept++] = data[i + j];
+            }
+        }
+    }
+    return removeAllScalar(data, i, n, val, kept);
+}
+
+/**** AVX2 ****/
+
+template <class T>
+DATASTRUCTLIB_TARGET_AVX2 inline __m256i broadcast256(const T& val)
+{
+    if constexpr (sizeof(T) == 1) { int8_t bits; std::memcpy(&bits, &val, 1); return _mm256_set1_epi8(bits); }
+    else if constexpr (sizeof(T) == 2) { int16_t bits; std::memcpy(&bits, &val, 2); return _mm256_set1_epi16(bits); }
+    else if constexpr (sizeof(T) == 4) { int32_t bits; std::memcpy(&bits, &val, 4); return _mm256_set1_epi32(bits); }
+    else { int64_t bits; std::memcpy(&bits, &val, 8); return _mm256_set1_epi64x(bits); }
+}
+
+template <class T>
+DATASTRUCTLIB_TARGET_AVX2 inline __m256i equal256(const __m256i& x, const __m256i& v)
+{
+    if constexpr (std::is_floating_point<T>::value && sizeof(T) == 4) return _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(x), _mm256_castsi256_ps(v), _CMP_EQ_OQ));
+    else if constexpr (std::is_floating_point<T>::value) return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(x), _mm256_castsi256_pd(v), _CMP_EQ_OQ));
+    else if constexpr (sizeof(T) == 1) return _mm256_cmpeq_epi8(x, v);
+    else if constexpr (sizeof(T) == 2) return _mm256_cmpeq_epi16(x, v);
+    else if constexpr (sizeof(T) == 4) return _mm256_cmpeq_epi32(x, v);
+    else return _mm256_cmpeq_epi64(x, v);
+}
+
+/* lane permutation that moves the 32-bit lanes set in laneMask to the front */
+DATASTRUCTLIB_TARGET_AVX2 inline __m256i compressPermutation(const unsigned int& laneMask)
+{
+    return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(compressTable.m_lanes[laneMask])));
+}
+
+template <class T>
+DATASTRUCTLIB_TARGET_AVX2 unsigned int findFirstAvx2(const T* data, const unsigned int& n, const T& val)
+{
+    const unsigned int width = 32 / sizeof(T);
+    const __m256i v = broadcast256(val);
+    unsigned int i = 0;
+    for (; i + 2 * width <= n; i += 2 * width) // two compares per iteration, tested together
+    {
+        __m256i c0 = equal256<T>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), v);
+        __m256i c1 = equal256<T>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + width)), v);
+        if (!_mm256_testz_si256(_mm256_or_si256(c0, c1), _mm256_or_si256(c0, c1)))
+        {
+            unsigned int mask0 = _mm256_movemask_epi8(c0);
+            if (mask0 != 0)
+                return i + __builtin_ctz(mask0) / sizeof(T);
+            return i + width + __builtin_ctz(static_cast<unsigned int>(_mm256_movemask_epi8(c1))) / sizeof(T);
+        }
+    }
+    for (; i + width <= n; i += width)
+    {
+        unsigned int mask = _mm256_movemask_epi8(equal256<T>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), v));
+        if (mask != 0)
+            return i + __builtin_ctz(mask) / sizeof(T);
+    }
+    return findFirstScalar(data, i, n, val);
+}
+
+template <class T>
+DATASTRUCTLIB_TARGET_AVX2 unsigned int findAllAvx2(const T* data, const unsigned int& n, const T& val, unsigned int* out, const unsigned int& indexOffset)
+{
+    const unsigned int width = 32 / sizeof(T);
+    const __m256i v = broadcast256(val);
+    unsigned int found = 0;
+    unsigned int i = 0;
+    if constexpr (sizeof(T) == 4)
+    {
+        // compress the matching lane indexes straight into out - found + 8 <= i + 8 <= n so the full store stays in bounds
+        __m256i inds = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(indexOffset)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        const __m256i step = _mm256_set1_epi32(8);
+        for (; i + width <= n; i += width)
+        {
+            __m256i c = equal256<T>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), v);
+            unsigned int laneMask = _mm256_movemask_ps(_mm256_castsi256_ps(c));
+            if (laneMask != 0)
+            {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + found), _mm256_permutevar8x32_epi32(inds, compressPermutation(laneMask)));
+                found += __builtin_popcount(laneMask);
+            }
+            inds = _mm256_add_epi32(inds, step);
+        }
+    }
+    else
+    {
+        for (; i + width <= n; i += width)
+        {
+            unsigned int mask = _mm256_movemask_epi8(equal256<T>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), v));
+            while (mask != 0)
+            {
+                unsigned int bit = __builtin_ctz(mask);
+                out[found++] = indexOffset + i + bit / sizeof(T);
+                mask &= ~(elemMaskBits<T>() << bit);
+            }
+        }
+    }
+    return findAllScalar(data, i, n, val, out, found, indexOffset);
+}
+
+template <class T>
+DATASTRUCTLIB_TARGET_AVX2 unsigned int removeAllAvx2(T* data, const unsigned int& n, const T& val)
+{
+    const unsigned int width = 32 / sizeof(T);
+    const __m256i v = broadcast256(val);
+    unsigned int kept = 0;
+    unsigned int i = 0;
+    for (; i + width <= n; i += width)
+    {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i c = equal256<T>(x, v);
+        if (_mm256_testz_si256(c, c))
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + kept), x); // whole block kept - kept <= i so the block was loaded before being overwritten
+            kept += width;
+        }
+        else if constexpr (sizeof(T) == 4)
+        {
+            unsigned int keepMask = ~_mm256_movemask_ps(_mm256_castsi256_ps(c)) & 0xFF;
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + kept), _mm256_permutevar8x32_epi32(x, compressPermutation(keepMask))); // lanes past the kept ones land on already-consumed slots
+            kept += __builtin_popcount(keepMask);
+        }
+        else
+        {
+            unsigned int mask = _mm256_movemask_epi8(c);
+            for (unsigned int j = 0; j < width; ++j)
+            {
+                if (((mask >> (j * sizeof(T))) & 1) == 0)
+                    data[kept++] = data[i + j];
+            }
+        }
+    }
+    return removeAllScalar(data, i, n, val, kept);
+}
+
+#endif // DATASTRUCTLIB_SIMD_X86
+
+} // namespace detail
+
+/* returns index of first element equal to val, or n if there is none */
+template <class T>
+unsigned int findFirst(const T* data, const unsigned int& n, const T& val)
+{
+    static_assert(isSearchable<T>::value, "simd search requires an arithmetic element type");
+#ifdef DATASTRUCTLIB_SIMD_X86
+    if (detail::hasAvx2())
+        return detail::findFirstAvx2(data, n, val);
+    return detail::findFirstSse2(data, n, val);
+#else
+    return detail::findFirstScalar(data, 0, n, val);
+#endif
+}
+
+/* writes indexOffset + index of every element equal to val into out, returning the number written
+    - out must have room for n indexes
+*/
+template <class T>
+unsigned int findAll(const T* data, const unsigned int& n, const T& val, unsigned int* out, const unsigned int& indexOffset = 0)
+{
+    static_assert(isSearchable<T>::value, "simd search requires an arithmetic element type");
+#ifdef DATASTRUCTLIB_SIMD_X86
+    if (detail::hasAvx2())
+        return detail::findAllAvx2(data, n, val, out, indexOffset);
+    return detail::findAllSse2(data, n, val, out, indexOffset);
+#else
+    return detail::findAllScalar(data, 0, n, val, out, 0, indexOffset);
+#endif
+}
+
+/* removes every element equal to val by compacting the rest to the front in order, returning the new length */
+template <class T>
+unsigned int removeAll(T* data, const unsigned int& n, const T& val)
+{
+    static_assert(isSearchable<T>::value, "simd search requires an arithmetic element type");
+#ifdef DATASTRUCTLIB_SIMD_X86
+    if (detail::hasAvx2())
+        return detail::removeAllAvx2(data, n, val);
+    return detail::removeAllSse2(data, n, val);
+#else
+    return detail::removeAllScalar(data, 0, n, val, 0);
+#endif
+}
+
+} // namespace simd
+} // namespace datastructlib
@@ -0,0 +1,159 @@
+/* Slab allocator - by W Denny
+    - hands out objects of one type T from slabs of SlabLength cells instead of one heap allocation per object
+    - freed cells go onto an intrusive free list and are reused first, so insert/remove churn does not touch malloc at all
+    - new cells are bumped off the newest slab; a new slab is only allocated once the free list and the newest slab are both empty
+    - the destructor releases every slab - objects still live at that point are not destroyed, the owner must deallocate them first
+    - usage() reports slabs, bytes reserved and live/free cells as a SlabUsage, which adds up across allocators
+    - not thread safe, meant to be owned by one data structure (e.g. the nodes and key-value pairs of one hash table)
+*/
+#pragma once
+
+#include "DynamicArray.hpp"
+#include <iostream>
+#include <new>
+#include <utility>
+
+namespace datastructlib
+{
+
+/* memory used by one or more slab allocators */
+class SlabUsage
+{
+public:
+    unsigned int m_numSlabs = 0;
+    std::size_t m_bytesReserved = 0; // total size of all slabs
+    unsigned int m_numLive = 0; // cells holding an object
+    unsigned int m_numFree = 0; // cells on the free list or never handed out
+
+    SlabUsage& operator+=(const SlabUsage& other)
+    {
+        this->m_numSlabs += other.m_numSlabs;
+        this->m_bytesReserved += other.m_bytesReserved;
+        this->m_numLive += other.m_numLive;
+        this->m_numFree += other.m_numFree;
+        return *this;
+    }
+
+    void print() const
+    {
+        std::cout << "slabs: " << this->m_numSlabs << ", bytes reserved: " << this->m_bytesReserved << ", live: " << this->m_numLive << ", free: " << this->m_numFree << std::endl;
+    }
+};
+
+template <class T, unsigned int SlabLength = 256>
+class SlabAllocator
+{
+    static_assert(SlabLength > 0, "a slab must hold at least one cell");
+private:
+    union Cell // a free cell stores the free list link in the object's bytes
+    {
+        Cell* m_nextFreePtr;
+        alignas(T) unsigned char m_storage[sizeof(T)];
+    };
+    struct Slab
+    {
+        Slab* m_nextSlabPtr;
+        Cell m_cells[SlabLength];
+    };
+    Slab* m_slabPtr; // newest slab, older slabs are linked behind it
+    Cell* m_freePtr; // head of free list
+    unsigned int m_numBumped; // cells of the newest slab handed out so far
+    unsigned int m_numSlabs;
+    unsigned int m_numLive;
+
+    void addSlab();
+public:
+    SlabAllocator();
+    SlabAllocator(const SlabAllocator&) = delete;
+    SlabAllocator& operator=(const SlabAllocator&) = delete;
+    ~SlabAllocator();
+
+    template <class... Args>
+    T* allocate(Args&&... args);
+    void deallocate(T* ptr);
+    SlabUsage usage() const;
+};
+
+/* ctor - no slab is allocated until the first object */
+template <class T, unsigned int SlabLength>
+SlabAllocator<T, SlabLength>::SlabAllocator()
+{
+    this->m_slabPtr = nullptr;
+    this->m_freePtr = nullptr;
+    this->m_numBumped = SlabLength; // no slab to bump from
+    this->m_numSlabs = 0;
+    this->m_numLive = 0;
+}
+
+/* dtor - frees every slab */
+template <class T, unsigned int SlabLength>
+SlabAllocator<T, SlabLength>::~SlabAllocator()
+{
+    while (this->m_slabPtr != nullptr)
+    {
+        Slab* nextSlabPtr = this->m_slabPtr->m_nextSlabPtr;
+        detail::deallocateStorage(this->m_slabPtr);
+        this->m_slabPtr = nextSlabPtr;
+    }
+}
+
+/* allocates a new slab in front of the slab list and starts bumping from it */
+template <class T, unsigned int SlabLength>
+void SlabAllocator<T, SlabLength>::addSlab()
+{
+    Slab* slabPtr = detail::allocateStorage<Slab>(1);
+    slabPtr->m_nextSlabPtr = this->m_slabPtr;
+    this->m_slabPtr = slabPtr;
+    this->m_numBumped = 0;
+    this->m_numSlabs++;
+}
+
+/* constructs a T from args in a free cell and returns its ptr */
+template <class T, unsigned int SlabLength>
+template <class... Args>
+T* SlabAllocator<T, SlabLength>::allocate(Args&&... args)
+{
+    Cell* cellPtr;
+    if (this->m_freePtr != nullptr) // reuse most recently freed cell - likely still in cache
+    {
+        cellPtr = this->m_freePtr;
+        this->m_freePtr = cellPtr->m_nextFreePtr;
+    }
+    else
+    {
+        if (this->m_numBumped == SlabLength)
+        {
+            this->addSlab();
+        }
+        cellPtr = &this->m_slabPtr->m_cells[this->m_numBumped++];
+    }
+    T* ptr = ::new (static_cast<void*>(cellPtr->m_storage)) T(std::forward<Args>(args)...);
+    this->m_numLive++;
+    return ptr;
+}
+
+/* destroys the object at ptr and puts its cell on the free list - ptr must come from this allocator */
+template <class T, unsigned int SlabLength>
+void SlabAllocator<T, SlabLength>::deallocate(T* ptr)
+{
+    assert(this->m_numLive > 0);
+    ptr->~T();
+    Cell* cellPtr = reinterpret_cast<Cell*>(ptr);
+    cellPtr->m_nextFreePtr = this->m_freePtr;
+    this->m_freePtr = cellPtr;
+    this->m_numLive--;
+}
+
+/* returns current memory usage */
+template <class T, unsigned int SlabLength>
+SlabUsage SlabAllocator<T, SlabLength>::usage() const
+{
+    SlabUsage usage;
+    usage.m_numSlabs = this->m_numSlabs;
+    usage.m_bytesReserved = static_cast<std::size_t>(this->m_numSlabs) * sizeof(Slab);
+    usage.m_numLive = this->m_numLive;
+    usage.m_numFree = this->m_numSlabs * SlabLength - this->m_numLive;
+    return usage;
+}
+
+}; // namespace datastructlib
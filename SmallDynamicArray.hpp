@@ -0,0 +1,440 @@
+/* Small dynamic array - by W Denny
+    - same interface as DynamicArray, but the first N elements are stored inline inside the object
+    - only spills to a heap allocated stat array once more than N elements are held, and moves back inline when it shrinks to N or fewer
+    - intended for the many arrays that stay small, e.g. hash table chains, where a heap allocation per array dominates
+    - growth/shrinking beyond N follows the same growth policy as DynamicArray
+*/
+#pragma once
+
+#include "DynamicArray.hpp"
+
+namespace datastructlib
+{
+
+template <class T, unsigned int N, class G = DefaultGrowthPolicy>
+class SmallDynamicArray
+{
+    static_assert(N > 0, "inline capacity must be at least one element");
+
+private:
+    T* m_data; // points at m_inlineArr while inline, otherwise at heap storage
+    unsigned int m_length;
+    unsigned int m_capacity;
+    alignas(T) unsigned char m_inlineArr[N * sizeof(T)]; // raw inline storage for N elements
+
+public:
+    SmallDynamicArray();
+    SmallDynamicArray(const SmallDynamicArray&);
+    SmallDynamicArray(SmallDynamicArray&&);
+    ~SmallDynamicArray();
+    SmallDynamicArray& operator=(const SmallDynamicArray&);
+    SmallDynamicArray& operator=(SmallDynamicArray&&);
+
+    T get(const unsigned int& ind) const;
+    T* getPtr(const unsigned int& ind) const;
+    void set(const unsigned int& ind, const T& val);
+    void set(const unsigned int& ind, T&& val);
+    void insert(const unsigned int& ind, const T& val);
+    void insert(const unsigned int& ind, T&& val);
+    void append(const T& val);
+    void append(T&& val);
+    template <class... Args>
+    T& emplaceBack(Args&&... args);
+    void insertRange(const unsigned int& ind, const T* vals, const unsigned int& n);
+    void appendRange(const T* vals, const unsigned int& n);
+    void remove(const unsigned int& ind);
+    void removeRange(const unsigned int& first, const unsigned int& last);
+    template <class Pred>
+    unsigned int removeIf(Pred pred);
+    void removeVal(const T& val);
+    void clear();
+    DynamicArray<unsigned int> valIndArr(const T& val) const;
+    bool contains(const T& val) const;
+    unsigned int length() const;
+    unsigned int capacity() const;
+    bool isInline() const; // true while elements are held in the inline storage
+    void reserve(const unsigned int& n);
+    void shrinkToFit();
+    void print();
+
+private:
+    T* inlineArr() const;
+    void reallocData(const unsigned int& newCapacity); // moves elements to storage of new capacity - inline if it fits
+    void shrinkIfSparse();
+};
+
+/* default ctor - starts inline with no heap allocation */
+template <class T, unsigned int N, class G>
+SmallDynamicArray<T, N, G>::SmallDynamicArray()
+{
+    this->m_data = this->inlineArr();
+    this->m_length = 0;
+    this->m_capacity = N;
+}
+
+/* copy ctor */
+template <class T, unsigned int N, class G>
+SmallDynamicArray<T, N, G>::SmallDynamicArray(const SmallDynamicArray<T, N, G>& arr)
+{
+    this->m_data = this->inlineArr();
+    this->m_length = 0;
+    this->m_capacity = N;
+    this->appendRange(arr.m_data, arr.m_length);
+}
+
+/* move ctor - steals heap storage, or relocates inline elements since those cannot be stolen */
+template <class T, unsigned int N, class G>
+SmallDynamicArray<T, N, G>::SmallDynamicArray(SmallDynamicArray<T, N, G>&& arr)
+{
+    this->m_length = arr.m_length;
+    if (arr.isInline())
+    {
+        this->m_data = this->inlineArr();
+        this->m_capacity = N;
+        detail::relocate(this->m_data, arr.m_data, arr.m_length);
+    }
+    else
+    {
+        this->m_data = arr.m_data;
+        this->m_capacity = arr.m_capacity;
+        arr.m_data = arr.inlineArr();
+        arr.m_capacity = N;
+    }
+    arr.m_length = 0;
+}
+
+/* dtor */
+template <class T, unsigned int N, class G>
+SmallDynamicArray<T, N, G>::~SmallDynamicArray()
+{
+    detail::destroyRange(this->m_data, this->m_length);
+    if (!this->isInline())
+        detail::deallocateStorage(this->m_data);
+}
+
+/* copy assignment */
+template <class T, unsigned int N, class G>
+SmallDynamicArray<T, N, G>& SmallDynamicArray<T, N, G>::operator=(const SmallDynamicArray<T, N, G>& arr)
+{
+    if (this != &arr)
+    {
+        this->clear();
+        this->appendRange(arr.m_data, arr.m_length);
+    }
+    return *this;
+}
+
+/* move assignment */
+template <class T, unsigned int N, class G>
+SmallDynamicArray<T, N, G>& SmallDynamicArray<T, N, G>::operator=(SmallDynamicArray<T, N, G>&& arr)
+{
+    if (this != &arr)
+    {
+        this->~SmallDynamicArray();
+        ::new (static_cast<void*>(this)) SmallDynamicArray<T, N, G>(std::move(arr));
+    }
+    return *this;
+}
+
+/* returns value given index */
+template <class T, unsigned int N, class G>
+T SmallDynamicArray<T, N, G>::get(const unsigned int& ind) const
+{
+    assert(ind < this->m_length);
+    return this->m_data[ind];
+}
+
+/* returns ptr of value given index - only valid until the array next grows or shrinks */
+template <class T, unsigned int N, class G>
+T* SmallDynamicArray<T, N, G>::getPtr(const unsigned int& ind) const
+{
+    assert(ind < this->m_length);
+    return &(this->m_data[ind]);
+}
+
+/* sets value given index */
+template <class T, unsigned int N, class G>
+void SmallDynamicArray<T, N, G>::set(const unsigned int& ind, const T& val)
+{
+    assert(ind < this->m_length);
+    this->m_data[ind] = val;
+}
+
+/* sets value given index by moving it into place */
+template <class T, unsigned int N, class G>
+void SmallDynamicArray<T, N, G>::set(const unsigned int& ind, T&& val)
+{
+    assert(ind < this->m_length);
+    this->m_data[ind] = std::move(val);
+}
+
+/* inserts an element given index */
+template <class T, unsigned int N, class G>
+void SmallDynamicArray<T, N, G>::insert(const unsigned int& ind, const T& val)
+{
+    this->insert(ind, T(val)); // take copy first as val may be an element that is about to be shifted
+}
+
+/* inserts an element given index by moving it into place */
+template <class T, unsigned int N, class G>
+void SmallDynamicArray<T, N, G>::insert(const unsigned int& ind, T&& val)
+{
+    assert(ind <= this->m_length);
+    if (this->m_length + 1 > this->m_capacity)
+        this->reallocData(G::grow(this->m_capacity, this->m_length + 1));
+    detail::relocate(this->m_data + ind + 1, this->m_data + ind, this->m_length - ind);
+    ::new (static_cast<void*>(this->m_data + ind)) T(std::move(val));
+    this->m_length++;
+}
+
+/* appends element to the end */
+template <class T, unsigned int N, class G>
+void SmallDynamicArray<T, N, G>::append(const T& val)
+{
+    this->emplaceBack(val);
+}
+
+/* appends element to the end by moving it */
+template <class T, unsigned int N, class G>
+void SmallDynamicArray<T, N, G>::append(T&& val)
+{
+    this->emplaceBack(std::move(val));
+}
+
+/* constructs new element at the end of the array
+    - when spilling/growing, the new element is constructed before the old ones are relocated as args may refer to one of them
+*/
+template <class T, unsigned int N, class G>
+template <class... Args>
+T& SmallDynamicArray<T, N, G>::emplaceBack(Args&&... args)
+{
+    if (this->m_length + 1 > this->m_capacity)
+    {
+        unsigned int newCapacity = G::grow(this->m_capacity, this->m_length + 1);
+        T* tmp = detail::allocateStorage<T>(newCapacity);
+        ::new (static_cast<void*>(tmp + this->m_length)) T(std::forward<Args>(args)...);
+        detail::relocate(tmp, this->m_data, this->m_length);
+        if (!this->isInline())
+            detail::deallocateStorage(this->m_data);
+        this->m_data = tmp;
+        this->m_capacity = newCapacity;
+    }
+    else
+    {
+        ::new (static_cast<void*>(this->m_data + this->m_length)) T(std::forward<Args>(args)...);
+    }
+    this->m_length++;
+    return this->m_data[this->m_length - 1];
+}
+
+/* inserts n values at given index with a single shift */
+template <class T, unsigned int N, class G>
+void SmallDynamicArray<T, N, G>::insertRange(const unsigned int& ind, const T* vals, const unsigned int& n)
+{
+    assert(ind <= this->m_length);
+    if (n == 0)
+        return;
+    if ((vals + n > this->m_data) && (vals < this->m_data + this->m_length))
+    {
+        DynamicArray<T> tmp(n); // vals alias this array - take a copy before anything moves
+        tmp.appendRange(vals, n);
+        this->insertRange(ind, tmp.getPtr(0), n);
+        return;
+    }
+    if (this->m_length + n > this->m_capacity)
+        this->reallocData(G::grow(this->m_capacity, this->m_length + n));
+    detail::relocate(this->m_data + ind + n, this->m_data + ind, this->m_length - ind);
+    detail::copyConstruct(this->m_data + ind, vals, n);
+    this->m_length += n;
+}
+
+/* appends n values to the end */
+template <class T, unsigned int N, class G>
+void SmallDynamicArray<T, N, G>::appendRange(const T* vals, const unsigned int& n)
+{
+    this->insertRange(this->m_length, vals, n);
+}
+
+/* removes an element given index */
+template <class T, unsigned int N, class G>
+void SmallDynamicArray<T, N, G>::remove(const unsigned int& ind)
+{
+    assert(ind < this->m_length);
+    this->m_data[ind].~T();
+    detail::relocate(this->m_data + ind, this->m_data + ind + 1, this->m_length - ind - 1);
+    this->m_length--;
+    this->shrinkIfSparse();
+}
+
+/* removes elements in [first, last) with a single shift */
+template <class T, unsigned int N, class G>
+void SmallDynamicArray<T, N, G>::removeRange(const unsigned int& first, const unsigned int& last)
+{
+    assert((first <= last) && (last <= this->m_length));
+    detail::destroyRange(this->m_data + first, last - first);
+    detail::relocate(this->m_data + first, this->m_data + last, this->m_length - last);
+    this->m_length -= last - first;
+    this->shrinkIfSparse();
+}
+
+/* removes all elements for which pred returns true, preserving order of the rest */
+template <class T, unsigned int N, class G>
+template <class Pred>
+unsigned int SmallDynamicArray<T, N, G>::removeIf(Pred pred)
+{
+    unsigned int found = 0;
+    for (unsigned int i = 0; i < this->m_length; ++i)
+    {
+        if (pred(this->m_data[i]))
+        {
+            this->m_data[i].~T();
+            found++;
+        }
+        else if (found > 0)
+        {
+            detail::relocate(this->m_data + i - found, this->m_data + i, 1);
+        }
+    }
+    this->m_length -= found;
+    this->shrinkIfSparse();
+    return found;
+}
+
+/* removes any elements with the given value */
+template <class T, unsigned int N, class G>
+void SmallDynamicArray<T, N, G>::removeVal(const T& val)
+{
+    if constexpr (simd::isSearchable<T>::value)
+    {
+        this->m_length = simd::removeAll(this->m_data, this->m_length, val);
+        this->shrinkIfSparse();
+    }
+    else
+    {
+        this->removeIf([&val](const T& elem) { return elem == val; });
+    }
+}
+
+/* clears the whole array and returns to inline storage */
+template <class T, unsigned int N, class G>
+void SmallDynamicArray<T, N, G>::clear()
+{
+    detail::destroyRange(this->m_data, this->m_length);
+    if (!this->isInline())
+        detail::deallocateStorage(this->m_data);
+    this->m_data = this->inlineArr();
+    this->m_capacity = N;
+    this->m_length = 0;
+}
+
+/* returns dynamic array containing indexes of all elements with given value */
+template <class T, unsigned int N, class G>
+DynamicArray<unsigned int> SmallDynamicArray<T, N, G>::valIndArr(const T& val) const
+{
+    DynamicArray<unsigned int> indArr;
+    for (unsigned int i = 0; i < this->m_length; ++i)
+    {
+        if (this->m_data[i] == val)
+            indArr.append(i);
+    }
+    return indArr;
+}
+
+/* returns true if value present */
+template <class T, unsigned int N, class G>
+bool SmallDynamicArray<T, N, G>::contains(const T& val) const
+{
+    if constexpr (simd::isSearchable<T>::value)
+    {
+        return simd::findFirst(this->m_data, this->m_length, val) < this->m_length;
+    }
+    for (unsigned int i = 0; i < this->m_length; ++i)
+    {
+        if (this->m_data[i] == val)
+            return true;
+    }
+    return false;
+}
+
+/* returns length of array */
+template <class T, unsigned int N, class G>
+unsigned int SmallDynamicArray<T, N, G>::length() const
+{
+    return this->m_length;
+}
+
+/* returns number of elements that fit before the array must grow */
+template <class T, unsigned int N, class G>
+unsigned int SmallDynamicArray<T, N, G>::capacity() const
+{
+    return this->m_capacity;
+}
+
+/* returns true while elements are stored inline */
+template <class T, unsigned int N, class G>
+bool SmallDynamicArray<T, N, G>::isInline() const
+{
+    return this->m_data == this->inlineArr();
+}
+
+/* grows storage so that n elements fit without further reallocation */
+template <class T, unsigned int N, class G>
+void SmallDynamicArray<T, N, G>::reserve(const unsigned int& n)
+{
+    if (n > this->m_capacity)
+        this->reallocData(n);
+}
+
+/* releases unused heap space, moving back inline if the elements fit */
+template <class T, unsigned int N, class G>
+void SmallDynamicArray<T, N, G>::shrinkToFit()
+{
+    if (!this->isInline() && (this->m_length != this->m_capacity))
+        this->reallocData(this->m_length);
+}
+
+/* prints array */
+template <class T, unsigned int N, class G>
+void SmallDynamicArray<T, N, G>::print()
+{
+    for (unsigned int i = 0; i < this->m_length; ++i)
+    {
+        std::cout << "(" << i << "): " << this->m_data[i] << std::endl;
+    }
+}
+
+/* returns ptr to inline storage */
+template <class T, unsigned int N, class G>
+T* SmallDynamicArray<T, N, G>::inlineArr() const
+{
+    return reinterpret_cast<T*>(const_cast<unsigned char*>(this->m_inlineArr));
+}
+
+/* moves elements into storage of the new capacity - requests of N or fewer go back to the inline storage */
+template <class T, unsigned int N, class G>
+void SmallDynamicArray<T, N, G>::reallocData(const unsigned int& newCapacity)
+{
+    assert(newCapacity >= this->m_length);
+    bool toInline = (newCapacity <= N);
+    if (toInline && this->isInline())
+        return; // already inline with room for N
+    T* tmp = toInline ? this->inlineArr() : detail::allocateStorage<T>(newCapacity);
+    detail::relocate(tmp, this->m_data, this->m_length);
+    if (!this->isInline())
+        detail::deallocateStorage(this->m_data);
+    this->m_data = tmp;
+    this->m_capacity = toInline ? N : newCapacity;
+}
+
+/* shrinks heap storage as set by the growth policy - never below N */
+template <class T, unsigned int N, class G>
+void SmallDynamicArray<T, N, G>::shrinkIfSparse()
+{
+    if (this->isInline())
+        return;
+    unsigned int newCapacity = G::shrink(this->m_capacity, this->m_length, N);
+    if (newCapacity != this->m_capacity)
+        this->reallocData(newCapacity);
+}
+
+} // namespace datastructlib
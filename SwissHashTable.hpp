@@ -0,0 +1,532 @@
+/* Swiss hash table - by W Denny
+    - open addressing hash table where each slot has one control byte: empty, deleted, or the low 7 bits of the key's hash (h2)
+    - slots are grouped 16 at a time; a probe loads a group's 16 control bytes and compares them all against h2 with one SSE2 compare + movemask
+    - only slots whose control byte matches h2 have their key compared, so a lookup rarely touches more than one key
+    - a probe ends at the first group holding an empty slot, and moves between groups quadratically (group, +1, +3, +6, ...)
+    - the group sequence visits every group because the number of groups is a power of two
+    - the remaining hash bits (h1) pick the first group
+    - unlike the other tables, the Hash policy returns a full size_t hash (std::hash style) rather than an index, as the fragment needs the extra bits
+    - the default Hasher<T> is already well mixed; other policies (e.g. std::hash, the identity for integers) are mixed with hashInteger first
+    - key-value pairs are stored inline next to the control array, same find/insert/remove interface as the other hash tables
+    - scalar group matching is used on other targets, or everywhere if DATASTRUCTLIB_NO_SIMD is defined
+    - takes the same Stats policy as the other tables; probe lengths count groups rather than slots
+*/
+#pragma once
+
+#include "HashTable.hpp"
+#include "SimdSearch.hpp"
+#include <cstdint>
+#include <functional>
+
+namespace datastructlib
+{
+
+namespace detail
+{
+
+const unsigned int swissGroupLength = 16;
+const int8_t swissCtrlEmpty = -128; // 0b10000000
+const int8_t swissCtrlDeleted = -2; // 0b11111110 - full slots hold h2 in 0..127, so the top bit marks empty/deleted
+
+/* control bytes of one group, with bit i of each returned mask standing for slot i of the group */
+class SwissGroup
+{
+private:
+#ifdef DATASTRUCTLIB_SIMD_X86
+    __m128i m_ctrl;
+#else
+    const int8_t* m_ctrl;
+#endif
+public:
+    explicit SwissGroup(const int8_t* ctrl)
+    {
+#ifdef DATASTRUCTLIB_SIMD_X86
+        this->m_ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+#else
+        this->m_ctrl = ctrl;
+#endif
+    }
+
+    /* slots whose control byte equals h2 */
+    uint32_t match(const int8_t& h2) const
+    {
+#ifdef DATASTRUCTLIB_SIMD_X86
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(this->m_ctrl, _mm_set1_epi8(h2))));
+#else
+        uint32_t mask = 0;
+        for (unsigned int i = 0; i < swissGroupLength; ++i)
+        {
+            if (this->m_ctrl[i] == h2)
+                mask |= 1u << i;
+        }
+        return mask;
+#endif
+    }
+
+    /* empty slots */
+    uint32_t matchEmpty() const
+    {
+        return this->match(swissCtrlEmpty);
+    }
+
+    /* empty or deleted slots - the only control bytes with the top bit set */
+    uint32_t matchFree() const
+    {
+#ifdef DATASTRUCTLIB_SIMD_X86
+        return static_cast<uint32_t>(_mm_movemask_epi8(this->m_ctrl));
+#else
+        uint32_t mask = 0;
+        for (unsigned int i = 0; i < swissGroupLength; ++i)
+        {
+            if (this->m_ctrl[i] < 0)
+                mask |= 1u << i;
+        }
+        return mask;
+#endif
+    }
+};
+
+} // namespace detail
+
+template <class T, class U, class Hash = Hasher<T>, class KeyEqual = std::equal_to<T>, class Stats = NullStats>
+class HashTable_Swiss : protected Stats // stats policy is a base so that NullStats takes no space
+{
+private:
+    int8_t* m_ctrl; // one control byte per slot
+    KeyValPair<T, U>* m_data; // raw storage - slot i is only constructed while its control byte holds a hash fragment
+    unsigned int m_arrLength; // power of two, at least one group
+    unsigned int m_numEntries;
+    unsigned int m_numDeleted;
+    Hash m_hash;
+    KeyEqual m_keyEqual;
+    double m_maxLoadFactor;
+
+public:
+    HashTable_Swiss(const unsigned int& length = 16, const double& maxLoadFactor = 0.875, const Hash& hash = Hash(), const KeyEqual& keyEqual = KeyEqual());
+    HashTable_Swiss(const HashTable_Swiss&) = delete;
+    HashTable_Swiss& operator=(const HashTable_Swiss&) = delete;
+    ~HashTable_Swiss();
+    HashTable_SearchResult<T, U> find(const T& key) const;
+    template <class K, class = typename std::enable_if<isTransparentLookup<Hash, KeyEqual, T, K>>::type>
+    HashTable_SearchResult<T, U> find(const K& key) const; // heterogeneous lookup, e.g. by std::string_view for std::string keys - needs transparent Hash and KeyEqual
+    void findBatch(const T* keys, const unsigned int& n, HashTable_SearchResult<T, U>* out) const; // finds n keys, overlapping their cache misses
+    void insert(const T& key, const U& val); // overwrites the value if key is already present
+    void insertBatch(const T* keys, const U* vals, const unsigned int& n); // inserts n pairs, resizing at most once up front
+    bool remove(const T& key);
+    void display();
+    template <class F>
+    void forEach(F f) const; // calls f(key, val) for every entry, in slot order
+    void resizeArray(const unsigned int& newLength); // rounded up to a power of two of at least one group
+    double loadFactor() const;
+    unsigned int size() const;
+    const Stats& stats() const; // refreshes the run length histogram and deleted ratio when Stats is enabled
+
+private:
+    template <class K>
+    size_t hashKey(const K& key) const;
+    template <class K>
+    unsigned int findSlot(const K& key, const size_t& hash, unsigned int& probeLength) const; // returns slot holding key, or m_arrLength if not present - probeLength is set to the number of groups read
+    unsigned int findFreeSlot(const size_t& hash) const; // returns first empty or deleted slot on the probe sequence
+    template <class K>
+    HashTable_SearchResult<T, U> findHashed(const K& key, const size_t& hash) const;
+    void insertHashed(const T& key, const U& val, const size_t& hash);
+    void reserve(const unsigned int& numNewEntries); // resizes now if inserting numNewEntries would need it later
+    unsigned int homeGroupStart(const size_t& hash) const; // first slot of the group a probe for hash starts at
+    void allocate(const unsigned int& length);
+    static int8_t h2(const size_t& hash);
+    static unsigned int roundLength(const unsigned int& length);
+};
+
+/* ctor */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+HashTable_Swiss<T, U, Hash, KeyEqual, Stats>::HashTable_Swiss(const unsigned int& length, const double& maxLoadFactor, const Hash& hash, const KeyEqual& keyEqual)
+    : m_hash(hash), m_keyEqual(keyEqual)
+{
+    assert((maxLoadFactor > 0) && (maxLoadFactor < 1)); // every probe sequence must reach a group with an empty slot
+    this->m_maxLoadFactor = maxLoadFactor;
+    this->allocate(roundLength(length));
+}
+
+/* dtor - destroys pairs in full slots */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+HashTable_Swiss<T, U, Hash, KeyEqual, Stats>::~HashTable_Swiss()
+{
+    for (unsigned int i = 0; i < this->m_arrLength; ++i)
+    {
+        if (this->m_ctrl[i] >= 0)
+            this->m_data[i].~KeyValPair<T, U>();
+    }
+    detail::deallocateStorage(this->m_data);
+    delete[] this->m_ctrl;
+}
+
+/* returns the pointer to a key value pair given key */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+HashTable_SearchResult<T, U> HashTable_Swiss<T, U, Hash, KeyEqual, Stats>::find(const T& key) const
+{
+    return this->findHashed(key, this->hashKey(key));
+}
+
+/* returns the pointer to a key value pair given a key of another type that hashes and compares equal to the stored key - no temporary key is built */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+template <class K, class>
+HashTable_SearchResult<T, U> HashTable_Swiss<T, U, Hash, KeyEqual, Stats>::find(const K& key) const
+{
+    return this->findHashed(key, this->hashKey(key));
+}
+
+/* finds n keys into out[0..n), a block at a time in two prefetch stages
+    - every key of the block is hashed and its home control group prefetched
+    - each home group is then matched against the key's fragment and the first matching slot prefetched - usually the key's own slot
+    - only then is each key resolved, by which time both lines are usually in cache
+*/
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+void HashTable_Swiss<T, U, Hash, KeyEqual, Stats>::findBatch(const T* keys, const unsigned int& n, HashTable_SearchResult<T, U>* out) const
+{
+    size_t hashes[hashTableBatchLength];
+    for (unsigned int start = 0; start < n; start += hashTableBatchLength)
+    {
+        unsigned int blockLength = (n - start < hashTableBatchLength) ? n - start : hashTableBatchLength;
+        for (unsigned int i = 0; i < blockLength; ++i)
+        {
+            hashes[i] = this->hashKey(keys[start + i]);
+            detail::prefetch(this->m_ctrl + this->homeGroupStart(hashes[i]));
+        }
+        for (unsigned int i = 0; i < blockLength; ++i)
+        {
+            unsigned int groupStart = this->homeGroupStart(hashes[i]);
+            uint32_t mask = detail::SwissGroup(this->m_ctrl + groupStart).match(h2(hashes[i]));
+            if (mask != 0)
+                detail::prefetch(this->m_data + groupStart + __builtin_ctz(mask));
+        }
+        for (unsigned int i = 0; i < blockLength; ++i)
+        {
+            out[start + i] = this->findHashed(keys[start + i], hashes[i]);
+        }
+    }
+}
+
+/* returns the pointer to a key value pair given key and its hash */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+template <class K>
+HashTable_SearchResult<T, U> HashTable_Swiss<T, U, Hash, KeyEqual, Stats>::findHashed(const K& key, const size_t& hash) const
+{
+    HashTable_SearchResult<T, U> result;
+    unsigned int probeLength;
+    unsigned int ind = this->findSlot(key, hash, probeLength);
+    this->recordLookup(probeLength, ind != this->m_arrLength);
+    if (ind == this->m_arrLength)
+    {
+        result.m_kvpPtr = nullptr; // not found
+        return result;
+    }
+    result.m_hashedKey = ind;
+    result.m_kvpPtr = this->m_data + ind;
+    return result;
+}
+
+/* inserts new entry, or overwrites the value if key already present */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+void HashTable_Swiss<T, U, Hash, KeyEqual, Stats>::insert(const T& key, const U& val)
+{
+    this->insertHashed(key, val, this->hashKey(key));
+}
+
+/* inserts n pairs - the table is grown once to fit them all, then each block of keys is hashed and has its home control group prefetched
+    - keys already present count towards the up front growth even though they only overwrite
+*/
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+void HashTable_Swiss<T, U, Hash, KeyEqual, Stats>::insertBatch(const T* keys, const U* vals, const unsigned int& n)
+{
+    this->reserve(n);
+    size_t hashes[hashTableBatchLength];
+    for (unsigned int start = 0; start < n; start += hashTableBatchLength)
+    {
+        unsigned int blockLength = (n - start < hashTableBatchLength) ? n - start : hashTableBatchLength;
+        for (unsigned int i = 0; i < blockLength; ++i)
+        {
+            hashes[i] = this->hashKey(keys[start + i]);
+            unsigned int groupStart = this->homeGroupStart(hashes[i]);
+            detail::prefetch(this->m_ctrl + groupStart);
+            detail::prefetch(this->m_data + groupStart);
+        }
+        for (unsigned int i = 0; i < blockLength; ++i)
+        {
+            this->insertHashed(keys[start + i], vals[start + i], hashes[i]);
+        }
+    }
+}
+
+/* grows the table (or rebuilds it to clear deleted slots) so that numNewEntries more inserts fit under the max load factor */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+void HashTable_Swiss<T, U, Hash, KeyEqual, Stats>::reserve(const unsigned int& numNewEntries)
+{
+    if ((double) (this->m_numEntries + this->m_numDeleted + numNewEntries) <= this->m_maxLoadFactor * this->m_arrLength)
+        return;
+    unsigned int length = this->m_arrLength;
+    while ((double) (this->m_numEntries + numNewEntries) > this->m_maxLoadFactor * length)
+    {
+        length *= 2;
+    }
+    this->resizeArray(length);
+}
+
+/* inserts new entry given its hash */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+void HashTable_Swiss<T, U, Hash, KeyEqual, Stats>::insertHashed(const T& key, const U& val, const size_t& hash)
+{
+    unsigned int probeLength;
+    unsigned int existing = this->findSlot(key, hash, probeLength);
+    this->recordInsert(probeLength);
+    if (existing != this->m_arrLength)
+    {
+        this->m_data[existing].m_val = val;
+        return;
+    }
+
+    // deleted slots do not end probes, so they count towards the load factor until a rebuild clears them
+    if ((double) (this->m_numEntries + this->m_numDeleted + 1) > this->m_maxLoadFactor * this->m_arrLength)
+    {
+        bool grow = (double) (this->m_numEntries + 1) > this->m_maxLoadFactor * this->m_arrLength / 2;
+        this->resizeArray(grow ? this->m_arrLength * 2 : this->m_arrLength);
+    }
+
+    unsigned int ind = this->findFreeSlot(hash);
+    if (this->m_ctrl[ind] == detail::swissCtrlDeleted)
+        this->m_numDeleted--;
+    ::new (static_cast<void*>(this->m_data + ind)) KeyValPair<T, U>(key, val);
+    this->m_ctrl[ind] = h2(hash);
+    this->m_numEntries++;
+}
+
+/* remove entry by key
+    - if the slot's group still has an empty slot, every probe through this group already stops here, so the slot can go back to empty
+    - otherwise it is marked deleted so that probes continue past it
+*/
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+bool HashTable_Swiss<T, U, Hash, KeyEqual, Stats>::remove(const T& key)
+{
+    unsigned int probeLength;
+    unsigned int ind = this->findSlot(key, this->hashKey(key), probeLength);
+    if (ind == this->m_arrLength)
+    {
+        return false; // object not found inside hash table
+    }
+    this->m_data[ind].~KeyValPair<T, U>();
+    unsigned int groupStart = ind & ~(detail::swissGroupLength - 1);
+    if (detail::SwissGroup(this->m_ctrl + groupStart).matchEmpty() != 0)
+    {
+        this->m_ctrl[ind] = detail::swissCtrlEmpty;
+    }
+    else
+    {
+        this->m_ctrl[ind] = detail::swissCtrlDeleted;
+        this->m_numDeleted++;
+    }
+    this->m_numEntries--;
+    this->recordRemove();
+    return true;
+}
+
+/* display
+    - note the value datatype must be defined for ostream operator
+*/
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+void HashTable_Swiss<T, U, Hash, KeyEqual, Stats>::display()
+{
+    std::cout << "======================" << std::endl;
+    for (unsigned int i = 0; i < this->m_arrLength; ++i)
+    {
+        std::cout << "Index (" << i << ") \t |";
+        if (this->m_ctrl[i] >= 0)
+        {
+            std::cout << "\t Key: " << this->m_data[i].m_key << " -> Value: " << this->m_data[i].m_val << std::endl;
+        }
+        else if (this->m_ctrl[i] == detail::swissCtrlDeleted)
+        {
+            std::cout << "\t Deleted" << std::endl;
+        }
+        else
+        {
+            std::cout << std::endl;
+        }
+    }
+    std::cout << "======================" << std::endl;
+}
+
+/* calls f(key, val) for every entry */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+template <class F>
+void HashTable_Swiss<T, U, Hash, KeyEqual, Stats>::forEach(F f) const
+{
+    for (unsigned int i = 0; i < this->m_arrLength; ++i)
+    {
+        if (this->m_ctrl[i] >= 0)
+            f(this->m_data[i].m_key, this->m_data[i].m_val);
+    }
+}
+
+/* resize array - pairs are moved into the new array and deleted slots are dropped */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+void HashTable_Swiss<T, U, Hash, KeyEqual, Stats>::resizeArray(const unsigned int& newLength)
+{
+    unsigned int length = roundLength(newLength);
+    assert(length * this->m_maxLoadFactor >= this->m_numEntries);
+    int8_t* oldCtrl = this->m_ctrl;
+    KeyValPair<T, U>* oldData = this->m_data;
+    unsigned int oldLength = this->m_arrLength;
+    unsigned int numEntries = this->m_numEntries;
+    this->beginResize();
+
+    this->allocate(length);
+    for (unsigned int i = 0; i < oldLength; ++i)
+    {
+        if (oldCtrl[i] < 0)
+            continue;
+        size_t hash = this->hashKey(oldData[i].m_key);
+        unsigned int ind = this->findFreeSlot(hash);
+        detail::relocate(this->m_data + ind, oldData + i, 1); // move pair across, no reallocation
+        this->m_ctrl[ind] = h2(hash);
+    }
+    this->m_numEntries = numEntries;
+    detail::deallocateStorage(oldData);
+    delete[] oldCtrl;
+    this->endResize();
+}
+
+/* returns number of entries divided by number of slots */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+double HashTable_Swiss<T, U, Hash, KeyEqual, Stats>::loadFactor() const
+{
+    return ((double) this->m_numEntries) / ((double) this->m_arrLength);
+}
+
+/* returns number of entries */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+unsigned int HashTable_Swiss<T, U, Hash, KeyEqual, Stats>::size() const
+{
+    return this->m_numEntries;
+}
+
+/* returns the stats policy object - a snapshot of runs of non-empty slots and the deleted ratio is taken first if stats are enabled */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+const Stats& HashTable_Swiss<T, U, Hash, KeyEqual, Stats>::stats() const
+{
+    if constexpr (Stats::enabled)
+    {
+        this->beginSnapshot();
+        unsigned int runLength = 0;
+        for (unsigned int i = 0; i < this->m_arrLength; ++i)
+        {
+            if (this->m_ctrl[i] != detail::swissCtrlEmpty)
+            {
+                runLength++;
+            }
+            else if (runLength > 0)
+            {
+                this->recordChainLength(runLength);
+                runLength = 0;
+            }
+        }
+        if (runLength > 0)
+            this->recordChainLength(runLength);
+        this->recordTombstones(this->m_numDeleted, this->m_arrLength);
+    }
+    return *this;
+}
+
+/* hashes key, mixing the bits unless the policy already does, so that both the low 7 bits and the group bits depend on the whole key */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+template <class K>
+size_t HashTable_Swiss<T, U, Hash, KeyEqual, Stats>::hashKey(const K& key) const
+{
+    if constexpr (hashIsAvalanching<Hash>)
+        return this->m_hash(key);
+    else
+        return static_cast<size_t>(hashInteger(static_cast<uint64_t>(this->m_hash(key))));
+}
+
+/* probes group by group, comparing keys only where the control byte matches h2, until a group with an empty slot */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+template <class K>
+unsigned int HashTable_Swiss<T, U, Hash, KeyEqual, Stats>::findSlot(const K& key, const size_t& hash, unsigned int& probeLength) const
+{
+    const unsigned int groupMask = this->m_arrLength / detail::swissGroupLength - 1;
+    const int8_t fragment = h2(hash);
+    unsigned int group = static_cast<unsigned int>(hash >> 7) & groupMask;
+    for (probeLength = 1; probeLength <= groupMask + 1; ++probeLength)
+    {
+        unsigned int groupStart = group * detail::swissGroupLength;
+        detail::SwissGroup ctrl(this->m_ctrl + groupStart);
+        for (uint32_t mask = ctrl.match(fragment); mask != 0; mask &= mask - 1)
+        {
+            unsigned int ind = groupStart + __builtin_ctz(mask);
+            if (this->m_keyEqual(this->m_data[ind].m_key, key))
+                return ind;
+        }
+        if (ctrl.matchEmpty() != 0)
+            break;
+        group = (group + probeLength) & groupMask; // triangular steps visit every group of a power-of-two table
+    }
+    return this->m_arrLength;
+}
+
+/* returns first slot of the group a probe for hash starts at */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+unsigned int HashTable_Swiss<T, U, Hash, KeyEqual, Stats>::homeGroupStart(const size_t& hash) const
+{
+    return (static_cast<unsigned int>(hash >> 7) & (this->m_arrLength / detail::swissGroupLength - 1)) * detail::swissGroupLength;
+}
+
+/* returns first empty or deleted slot along the probe sequence of hash */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+unsigned int HashTable_Swiss<T, U, Hash, KeyEqual, Stats>::findFreeSlot(const size_t& hash) const
+{
+    const unsigned int groupMask = this->m_arrLength / detail::swissGroupLength - 1;
+    unsigned int group = static_cast<unsigned int>(hash >> 7) & groupMask;
+    for (unsigned int step = 1;; ++step)
+    {
+        unsigned int groupStart = group * detail::swissGroupLength;
+        uint32_t mask = detail::SwissGroup(this->m_ctrl + groupStart).matchFree();
+        if (mask != 0)
+            return groupStart + __builtin_ctz(mask);
+        assert(step <= groupMask); // load factor below one keeps a free slot somewhere
+        group = (group + step) & groupMask;
+    }
+}
+
+/* allocates empty control and slot arrays of given length */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+void HashTable_Swiss<T, U, Hash, KeyEqual, Stats>::allocate(const unsigned int& length)
+{
+    this->m_arrLength = length;
+    this->m_ctrl = new int8_t[length];
+    for (unsigned int i = 0; i < length; ++i)
+    {
+        this->m_ctrl[i] = detail::swissCtrlEmpty;
+    }
+    this->m_data = detail::allocateStorage<KeyValPair<T, U>>(length);
+    this->m_numEntries = 0;
+    this->m_numDeleted = 0;
+}
+
+/* returns the 7-bit hash fragment stored in the control byte */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+int8_t HashTable_Swiss<T, U, Hash, KeyEqual, Stats>::h2(const size_t& hash)
+{
+    return static_cast<int8_t>(hash & 0x7F);
+}
+
+/* rounds length up to a power of two of at least one group */
+template <class T, class U, class Hash, class KeyEqual, class Stats>
+unsigned int HashTable_Swiss<T, U, Hash, KeyEqual, Stats>::roundLength(const unsigned int& length)
+{
+    unsigned int rounded = detail::swissGroupLength;
+    while (rounded < length)
+    {
+        rounded *= 2;
+    }
+    return rounded;
+}
+
+} // namespace datastructlib
@@ -0,0 +1,98 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <HashTable.hpp>
+#include <BloomFilter.hpp>
+
+using namespace datastructlib;
+
+/* benchmark: miss-heavy lookups in HashTable_OpenAddressing and HashTable_SeperateChaining, with and without a BlockedBloomFilter in front
+    - 90% of the lookups are for keys that were never inserted
+    - with the filter most of them return after reading one 64-byte block, instead of walking a probe sequence or chain
+    - also reports the false positive rate of the standalone filter at a few bits per key
+*/
+
+using Filter = BlockedBloomFilter<unsigned int>;
+using OpenTable = HashTable_OpenAddressing<unsigned int, unsigned int, MaskedHash<unsigned int>, LinearProbe<1, 0>>;
+using FilteredOpenTable = HashTable_OpenAddressing<unsigned int, unsigned int, MaskedHash<unsigned int>, LinearProbe<1, 0>, std::equal_to<unsigned int>, NullStats, Filter>;
+using Chains = DynamicArray<KeyValPair<unsigned int, unsigned int>*>;
+using ChainTable = HashTable_SeperateChaining<unsigned int, unsigned int, Chains, MaskedHash<unsigned int>>;
+using FilteredChainTable = HashTable_SeperateChaining<unsigned int, unsigned int, Chains, MaskedHash<unsigned int>, std::equal_to<unsigned int>, NullStats, Filter>;
+
+template <class Table>
+void report(const char* name, Table& table, const std::vector<unsigned int>& keys, const std::vector<unsigned int>& probes, unsigned long long& expected)
+{
+    for (unsigned int i = 0; i < keys.size(); ++i)
+    {
+        table.insert(keys[i], i);
+    }
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    unsigned long long sum = 0;
+    for (unsigned int i = 0; i < probes.size(); ++i)
+    {
+        HashTable_SearchResult<unsigned int, unsigned int> result = table.find(probes[i]);
+        sum += (result.m_kvpPtr != nullptr) ? result.m_kvpPtr->m_val : 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    expected = (expected == 0) ? sum : expected;
+    std::cout << name << probes.size() / seconds / 1e6 << (sum == expected ? "" : "\tDIFFER") << std::endl;
+}
+
+int main() {
+    const unsigned int numKeys = 1 << 18;
+    const unsigned int numProbes = 1 << 21;
+
+    std::mt19937 rng(7);
+    std::vector<unsigned int> all(numKeys + numProbes);
+    for (unsigned int i = 0; i < all.size(); ++i)
+    {
+        all[i] = i * 2654435761u; // distinct, as multiplying by an odd number is a bijection
+    }
+    std::shuffle(all.begin(), all.end(), rng);
+    std::vector<unsigned int> keys(all.begin(), all.begin() + numKeys);
+    std::vector<unsigned int> probes;
+    for (unsigned int i = 0; i < numProbes; ++i)
+    {
+        probes.push_back((i % 10 == 0) ? keys[rng() % numKeys] : all[numKeys + i]); // 1 in 10 hits
+    }
+
+    std::cout << numKeys << " keys, " << numProbes << " lookups, 90% misses" << std::endl;
+    std::cout << "table\t\t\t\tfind (M/s)" << std::endl;
+    unsigned long long expected = 0;
+    {
+        OpenTable table(16, MaskedHash<unsigned int>(), LinearProbe<1, 0>(), 0.75);
+        report("open addressing\t\t\t", table, keys, probes, expected);
+    }
+    {
+        FilteredOpenTable table(16, MaskedHash<unsigned int>(), LinearProbe<1, 0>(), 0.75, std::equal_to<unsigned int>(), Filter(0, 10));
+        report("open addressing + filter\t", table, keys, probes, expected);
+    }
+    HashTable_DynamicArrayInterface<unsigned int, unsigned int> interface;
+    {
+        ChainTable table(numKeys / 4, &interface, MaskedHash<unsigned int>()); // 4 keys per chain
+        report("seperate chaining\t\t", table, keys, probes, expected);
+    }
+    {
+        FilteredChainTable table(numKeys / 4, &interface, MaskedHash<unsigned int>(), std::equal_to<unsigned int>(), Filter(0, 10));
+        report("seperate chaining + filter\t", table, keys, probes, expected);
+    }
+
+    std::cout << "bits per key\tfalse positives" << std::endl;
+    for (unsigned int bitsPerKey : { 8, 10, 12, 16 })
+    {
+        Filter filter(numKeys, bitsPerKey);
+        for (unsigned int i = 0; i < numKeys; ++i)
+        {
+            filter.add(keys[i]);
+        }
+        unsigned int falsePositives = 0;
+        for (unsigned int i = numKeys; i < all.size(); ++i)
+        {
+            falsePositives += filter.mayContain(all[i]) ? 1 : 0;
+        }
+        std::cout << bitsPerKey << "\t\t" << 100.0 * falsePositives / numProbes << "%" << std::endl;
+    }
+    return 0;
+}
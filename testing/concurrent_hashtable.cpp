@@ -0,0 +1,93 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <ConcurrentHashTable.hpp>
+
+using namespace datastructlib;
+
+/* read-heavy workload: 95% finds, 5% inserts/updates/removes
+    - each thread only writes keys k with k % numThreads == t, so it can check its own keys exactly while reading everyone's
+    - after the threads join, the table must hold exactly the union of what each thread expects
+*/
+
+int main() {
+    const unsigned int opsPerThread = 400000;
+    const unsigned int keyRange = 1 << 16;
+    unsigned int maxThreads = std::thread::hardware_concurrency();
+    if (maxThreads < 4)
+        maxThreads = 4;
+
+    std::cout << "threads\tMops/s" << std::endl;
+    for (unsigned int numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+    {
+        HashTable_Concurrent<unsigned int, unsigned int> table(64); // starts small, so resizes run alongside the readers
+        std::vector<std::unordered_map<unsigned int, unsigned int>> expected(numThreads);
+        std::vector<unsigned int> errors(numThreads, 0);
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (unsigned int t = 0; t < numThreads; ++t)
+        {
+            threads.emplace_back([&, t]() {
+                std::mt19937 rng(t + 1);
+                std::unordered_map<unsigned int, unsigned int>& mine = expected[t];
+                for (unsigned int i = 0; i < opsPerThread; ++i)
+                {
+                    unsigned int key = rng() % keyRange;
+                    unsigned int op = rng() % 100;
+                    if (op >= 5)
+                    {
+                        unsigned int val;
+                        bool found = table.find(key, val);
+                        if (key % numThreads == t) // own key - result is exact
+                        {
+                            auto it = mine.find(key);
+                            if ((found != (it != mine.end())) || (found && (val != it->second)))
+                                errors[t]++;
+                        }
+                        continue;
+                    }
+                    key = key - key % numThreads + t; // write only own keys
+                    if (key >= keyRange)
+                        key = t;
+                    if (op < 4)
+                    {
+                        table.insert(key, i);
+                        mine[key] = i;
+                    }
+                    else
+                    {
+                        if (table.remove(key) != (mine.erase(key) == 1))
+                            errors[t]++;
+                    }
+                }
+            });
+        }
+        for (unsigned int t = 0; t < numThreads; ++t)
+        {
+            threads[t].join();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        unsigned int totalErrors = 0, totalExpected = 0;
+        for (unsigned int t = 0; t < numThreads; ++t)
+        {
+            totalErrors += errors[t];
+            totalExpected += static_cast<unsigned int>(expected[t].size());
+            for (auto& kv : expected[t])
+            {
+                unsigned int val;
+                if (!table.find(kv.first, val) || (val != kv.second))
+                    totalErrors++;
+            }
+        }
+        if (table.size() != totalExpected)
+            totalErrors++;
+
+        std::cout << numThreads << "\t" << numThreads * opsPerThread / seconds / 1e6 << "\t(" << table.size() << " entries, " << table.length() << " buckets"
+            << (totalErrors == 0 ? ")" : ", INVALID)") << std::endl;
+    }
+}
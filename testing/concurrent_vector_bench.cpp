@@ -0,0 +1,74 @@
+#include <iostream>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <ConcurrentVector.hpp>
+#include <DynamicArray.hpp>
+
+using namespace datastructlib;
+
+/* benchmark: producer threads appending records to a shared vector
+    - ConcurrentVector::pushBack vs DynamicArray::append guarded by one mutex
+*/
+
+struct Record
+{
+    unsigned int m_producer;
+    unsigned int m_seq;
+};
+
+template <class Fn>
+double timeThreads(const unsigned int& numThreads, Fn fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < numThreads; ++t)
+    {
+        threads.emplace_back(fn, t);
+    }
+    for (unsigned int t = 0; t < numThreads; ++t)
+    {
+        threads[t].join();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    const unsigned int perThread = 1000000;
+    unsigned int maxThreads = std::thread::hardware_concurrency();
+    if (maxThreads < 4)
+        maxThreads = 4;
+
+    std::cout << "threads\tconcurrent (Mops/s)\tmutex+DynamicArray (Mops/s)" << std::endl;
+    for (unsigned int numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+    {
+        ConcurrentVector<Record> concurrentVec;
+        double concurrentTime = timeThreads(numThreads, [&](unsigned int t) {
+            for (unsigned int i = 0; i < perThread; ++i)
+                concurrentVec.pushBack(Record{t, i});
+        });
+
+        DynamicArray<Record> lockedArr;
+        std::mutex lock;
+        double lockedTime = timeThreads(numThreads, [&](unsigned int t) {
+            for (unsigned int i = 0; i < perThread; ++i)
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                lockedArr.append(Record{t, i});
+            }
+        });
+
+        // every record from every producer must be present exactly once, in order per producer
+        bool valid = (concurrentVec.length() == numThreads * perThread);
+        std::vector<unsigned int> nextSeq(numThreads, 0);
+        for (unsigned int i = 0; valid && (i < concurrentVec.length()); ++i)
+        {
+            Record rec = concurrentVec.get(i);
+            valid = (rec.m_seq == nextSeq[rec.m_producer]++);
+        }
+
+        double ops = static_cast<double>(numThreads) * perThread / 1e6;
+        std::cout << numThreads << "\t" << ops / concurrentTime << "\t\t\t" << ops / lockedTime << (valid ? "" : "\t(INVALID)") << std::endl;
+    }
+}
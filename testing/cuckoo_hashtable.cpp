@@ -0,0 +1,78 @@
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <CuckooHashTable.hpp>
+
+using namespace datastructlib;
+
+/* full hash policy with only 64 distinct hashes - keys of one residue share both buckets and their tag, so buckets overflow
+   into the stash and full stashes force rebuilds, reseeding while the load is low
+*/
+struct ResidueHash
+{
+    size_t operator()(const unsigned int& key) const
+    {
+        return key % 64;
+    }
+};
+
+/* random inserts, removes and finds against std::unordered_map - keys are drawn from numKeys values
+    - reports mismatches, rebuilds that kept the length (reseeds) or grew it, and stash use
+*/
+template <class Hash>
+void churn(const char* name, const unsigned int& numKeys, const unsigned int& numOps)
+{
+    HashTable_Cuckoo<unsigned int, unsigned int, Hash, std::equal_to<unsigned int>, HashTableStats> table(16, 0.9);
+    std::unordered_map<unsigned int, unsigned int> reference;
+    std::mt19937 rng(6);
+    unsigned int numWrong = 0, numReseeds = 0, numGrows = 0, maxStash = 0, stashRemoves = 0;
+    for (unsigned int i = 0; i < numOps; ++i)
+    {
+        unsigned int key = rng() % numKeys;
+        unsigned int op = rng() % 3;
+        if (op == 0)
+        {
+            unsigned long long resizes = table.stats().m_resizes;
+            double length = (table.size() > 0) ? table.size() / table.loadFactor() : 0;
+            table.insert(key, i); // overwrites the value of a present key
+            reference[key] = i;
+            double newLength = table.size() / table.loadFactor();
+            if (table.stats().m_resizes != resizes)
+            {
+                numReseeds += (newLength == length) ? 1 : 0;
+                numGrows += (newLength != length) ? 1 : 0;
+            }
+        }
+        else if (op == 1)
+        {
+            unsigned int stash = table.stashSize();
+            numWrong += (table.remove(key) != (reference.erase(key) == 1)) ? 1 : 0;
+            stashRemoves += (table.stashSize() < stash) ? 1 : 0;
+        }
+        else
+        {
+            HashTable_SearchResult<unsigned int, unsigned int> result = table.find(key);
+            std::unordered_map<unsigned int, unsigned int>::iterator it = reference.find(key);
+            numWrong += ((result.m_kvpPtr == nullptr) != (it == reference.end()) || ((result.m_kvpPtr != nullptr) && (result.m_kvpPtr->m_val != it->second))) ? 1 : 0;
+        }
+        numWrong += (table.size() != reference.size()) ? 1 : 0;
+        numWrong += (table.stashSize() > cuckooStashLength) ? 1 : 0;
+        maxStash = (table.stashSize() > maxStash) ? table.stashSize() : maxStash;
+    }
+    unsigned int numVisited = 0;
+    table.forEach([&](const unsigned int& key, const unsigned int& val)
+    {
+        numVisited++;
+        std::unordered_map<unsigned int, unsigned int>::iterator it = reference.find(key);
+        numWrong += ((it == reference.end()) || (it->second != val)) ? 1 : 0;
+    });
+    numWrong += (numVisited != reference.size()) ? 1 : 0;
+    std::cout << name << ": " << numWrong << " mismatches, size " << table.size() << ", stash " << table.stashSize() << " (at most " << maxStash << ", "
+        << stashRemoves << " removes from it), " << numReseeds << " reseeds, " << numGrows << " grows" << std::endl;
+}
+
+int main() {
+    churn<Hasher<unsigned int>>("Churn, 2000 keys", 2000, 200000);
+    churn<ResidueHash>("Churn, 64 hashes for 384 keys", 384, 200000);
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <CuckooHashTable.hpp>
+
+using namespace datastructlib;
+
+/* benchmark: HashTable_Cuckoo vs HashTable_OpenAddressing with linear probing at the same load factors
+    - both tables are sized up front so no resize happens while filling them
+    - probe length: slots (open addressing) or buckets (cuckoo) read per lookup, taken from the HashTableStats histogram
+    - lookups: shuffled probes, half present and half missing
+*/
+
+using LinearTable = HashTable_OpenAddressing<unsigned int, unsigned int, MaskedHash<unsigned int>, LinearProbe<1, 0>, std::equal_to<unsigned int>, HashTableStats>;
+using CuckooTable = HashTable_Cuckoo<unsigned int, unsigned int, Hasher<unsigned int>, std::equal_to<unsigned int>, HashTableStats>;
+
+template <class Table>
+unsigned long long sumLookups(const Table& table, const std::vector<unsigned int>& probes)
+{
+    unsigned long long sum = 0;
+    for (unsigned int i = 0; i < probes.size(); ++i)
+    {
+        HashTable_SearchResult<unsigned int, unsigned int> result = table.find(probes[i]);
+        sum += (result.m_kvpPtr != nullptr) ? result.m_kvpPtr->m_val : 1;
+    }
+    return sum;
+}
+
+// runs the lookups and prints the probe lengths they recorded, apart from those recorded while filling the table
+template <class Table>
+unsigned long long report(const char* name, const Table& table, const std::vector<unsigned int>& probes)
+{
+    HashTableStats before = table.stats();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    unsigned long long sum = sumLookups(table, probes);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const HashTableStats& after = table.stats();
+
+    unsigned long long total = 0, count = 0;
+    unsigned int maxBin = 0;
+    for (unsigned int i = 0; i < HashTableStats::histogramLength; ++i)
+    {
+        unsigned long long num = after.m_probeLengths[i] - before.m_probeLengths[i];
+        total += num * i;
+        count += num;
+        maxBin = (num > 0) ? i : maxBin;
+    }
+    std::cout << name << "\t" << table.loadFactor() << "\t" << static_cast<double>(total) / count << "\t\t"
+        << maxBin << (maxBin == HashTableStats::histogramLength - 1 ? "+" : "") << "\t\t" << probes.size() / seconds / 1e6 << std::endl;
+    return sum;
+}
+
+int main() {
+    const unsigned int numSlots = 1 << 18;
+    const double loads[] = { 0.5, 0.7, 0.9 };
+
+    std::mt19937 rng(5);
+    std::vector<unsigned int> keys(2 * numSlots);
+    for (unsigned int i = 0; i < keys.size(); ++i)
+    {
+        keys[i] = i * 2654435761u; // distinct, as multiplying by an odd number is a bijection
+    }
+    std::shuffle(keys.begin(), keys.end(), rng);
+
+    std::cout << numSlots << " slots" << std::endl;
+    std::cout << "table\t\tload\tavg probe\tmax probe\tfind (M/s)" << std::endl;
+    for (double load : loads)
+    {
+        unsigned int numKeys = static_cast<unsigned int>(numSlots * load);
+        std::vector<unsigned int> probes(keys.begin(), keys.begin() + numKeys); // present
+        probes.insert(probes.end(), keys.end() - numKeys, keys.end()); // missing
+        std::shuffle(probes.begin(), probes.end(), rng);
+
+        LinearTable linear(numSlots, MaskedHash<unsigned int>(), LinearProbe<1, 0>(), 0.95);
+        CuckooTable cuckoo(numSlots, 0.95);
+        for (unsigned int i = 0; i < numKeys; ++i)
+        {
+            linear.insert(keys[i], i);
+            cuckoo.insert(keys[i], i);
+        }
+        unsigned long long expected = report("linear probing", linear, probes);
+        unsigned long long sum = report("cuckoo\t", cuckoo, probes);
+        if (sum != expected)
+        {
+            std::cout << "DIFFER" << std::endl;
+        }
+    }
+    return 0;
+}
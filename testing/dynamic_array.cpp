@@ -1,8 +1,149 @@
 #include <iostream>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
 #include <DynamicArray.hpp>
 
 using namespace datastructlib;
 
+/* element that counts how often it is copied and moved - relocation on growth, insert and remove should only move */
+struct Tracked
+{
+    inline static unsigned int s_copies = 0;
+    inline static unsigned int s_moves = 0;
+    std::string m_name;
+
+    Tracked(const std::string& name) : m_name(name) {}
+    Tracked(const Tracked& other) : m_name(other.m_name) { s_copies++; }
+    Tracked(Tracked&& other) noexcept : m_name(std::move(other.m_name)) { s_moves++; }
+    Tracked& operator=(const Tracked& other) { this->m_name = other.m_name; s_copies++; return *this; }
+    Tracked& operator=(Tracked&& other) noexcept { this->m_name = std::move(other.m_name); s_moves++; return *this; }
+};
+
+/* true if arr holds "s0", "s1", ... in order, with first inserted before "s0" and "s<removed>" missing (none if removed >= length) */
+bool holdsNames(const DynamicArray<std::string>& arr, const std::string& first, const unsigned int& removed, const unsigned int& numNames)
+{
+    unsigned int offset = first.empty() ? 0 : 1;
+    if ((arr.length() != numNames + offset - (removed < numNames ? 1 : 0)) || (!first.empty() && (arr.get(0) != first)))
+        return false;
+    for (unsigned int i = 0, name = 0; name < numNames; ++name)
+    {
+        if (name == removed)
+            continue;
+        if (arr.get(offset + i++) != "s" + std::to_string(name))
+            return false;
+    }
+    return true;
+}
+
+/* appends then removes one element numRounds times, returning number of times capacity changed after the first round */
+template <class G>
+unsigned int capacityChanges(DynamicArray<int, G>& arr, const unsigned int& numRounds)
+{
+    unsigned int changes = 0;
+    unsigned int capacity = 0;
+    for (unsigned int i = 0; i < numRounds; ++i)
+    {
+        arr.append(static_cast<int>(i));
+        arr.remove(arr.length() - 1);
+        changes += (i > 0 && arr.capacity() != capacity) ? 1 : 0;
+        capacity = arr.capacity();
+    }
+    return changes;
+}
+
+/* appends n elements, returning the distinct capacities passed through */
+template <class G>
+std::string capacitySteps(DynamicArray<int, G>& arr, const unsigned int& n)
+{
+    std::string steps = std::to_string(arr.capacity());
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        unsigned int capacity = arr.capacity();
+        arr.append(static_cast<int>(i));
+        if (arr.capacity() != capacity)
+            steps += " " + std::to_string(arr.capacity());
+    }
+    return steps;
+}
+
+/* true if a and b hold the same elements bit for bit - NaN equals NaN here, -0.0 doesn't equal 0.0 */
+template <class T>
+bool sameBits(const DynamicArray<T>& a, const DynamicArray<T>& b)
+{
+    if (a.length() != b.length())
+        return false;
+    for (unsigned int i = 0; i < a.length(); ++i)
+    {
+        if (std::memcmp(a.getPtr(i), b.getPtr(i), sizeof(T)) != 0)
+            return false;
+    }
+    return true;
+}
+
+/* compares contains, valIndArr and removeVal (and the SSE2 kernels, which DynamicArray skips on AVX2 cpus) against scalar loops
+    - arrays are filled from a small pool of values so that every searched value has matches, and the last array has more than 1024 of them
+    - returns number of mismatches
+*/
+template <class T>
+unsigned int checkSearch(const char* name, std::mt19937& rng, const std::vector<T>& pool)
+{
+    unsigned int numArrays = 0, numWrong = 0;
+    for (unsigned int trial = 0; trial < 41; ++trial)
+    {
+        bool large = (trial == 40);
+        unsigned int length = large ? 3000 : rng() % 400;
+        DynamicArray<T> arr;
+        for (unsigned int i = 0; i < length; ++i)
+        {
+            arr.append((large && rng() % 2 == 0) ? pool[1] : pool[rng() % pool.size()]);
+        }
+        numArrays++;
+        for (const T& val : pool)
+        {
+            std::vector<unsigned int> inds;
+            DynamicArray<T> kept;
+            for (unsigned int i = 0; i < length; ++i)
+            {
+                if (arr.get(i) == val)
+                    inds.push_back(i);
+                else
+                    kept.append(arr.get(i));
+            }
+            DynamicArray<unsigned int> found = arr.valIndArr(val);
+            bool same = (arr.contains(val) == !inds.empty()) && (found.length() == inds.size());
+            for (unsigned int i = 0; same && (i < inds.size()); ++i)
+            {
+                same = (found.get(i) == inds[i]);
+            }
+            DynamicArray<T> removed(arr);
+            removed.removeVal(val);
+            same = same && sameBits(removed, kept);
+#ifdef DATASTRUCTLIB_SIMD_X86
+            if (length > 0)
+            {
+                std::vector<unsigned int> sseInds(length);
+                std::unique_ptr<T[]> sseKept(new T[length]);
+                std::memcpy(sseKept.get(), arr.getPtr(0), sizeof(T) * length);
+                unsigned int first = simd::detail::findFirstSse2(arr.getPtr(0), length, val);
+                unsigned int numFound = simd::detail::findAllSse2(arr.getPtr(0), length, val, sseInds.data(), 0);
+                sseInds.resize(numFound);
+                DynamicArray<T> sseRemoved;
+                sseRemoved.appendRange(sseKept.get(), simd::detail::removeAllSse2(sseKept.get(), length, val));
+                same = same && (first == (inds.empty() ? length : inds[0])) && (sseInds == inds) && sameBits(sseRemoved, kept);
+            }
+#endif
+            numWrong += same ? 0 : 1;
+        }
+    }
+    std::cout << name << ": " << numArrays << " arrays, " << numWrong << " mismatches" << std::endl;
+    return numWrong;
+}
+
 int main() {
     DynamicArray<int> arr;
 
@@ -33,4 +174,134 @@ int main() {
     std::cout << "\nIndexes of value 7:" << std::endl;
     indices.print();
 
-}
\ No newline at end of file
+    // insert a batch of values in the middle, then remove a range and filter
+    int batch[] = {1, 2, 3};
+    arr.insertRange(1, batch, 3);
+    std::cout << "\nAfter inserting {1, 2, 3} at index 1:" << std::endl;
+    arr.print();
+
+    arr.removeRange(0, 2);
+    std::cout << "\nAfter removing range [0, 2):" << std::endl;
+    arr.print();
+
+    unsigned int numRemoved = arr.removeIf([](const int& val) { return val % 2 == 1; });
+    std::cout << "\nRemoved " << numRemoved << " odd values:" << std::endl;
+    arr.print();
+
+
+    // elements that own memory are moved, never copied, as the array grows and shifts
+    std::cout << "\nMoving strings:" << std::endl;
+    const unsigned int numNames = 200;
+    DynamicArray<std::string> names;
+    for (unsigned int i = 0; i < numNames; ++i)
+    {
+        if (i % 2 == 0)
+        {
+            names.emplaceBack("s" + std::to_string(i));
+        }
+        else
+        {
+            std::string name = "s" + std::to_string(i);
+            names.append(std::move(name));
+        }
+    }
+    std::cout << "After growing to " << names.length() << " (capacity " << names.capacity() << "), correct? " << (holdsNames(names, "", numNames, numNames) ? "Yes" : "No") << std::endl;
+    names.insert(0, std::string("first"));
+    names.remove(101); // "s100"
+    std::cout << "After insert at 0 and remove, correct? " << (holdsNames(names, "first", 100, numNames) ? "Yes" : "No") << std::endl;
+
+    DynamicArray<std::string> movedTo(std::move(names));
+    std::cout << "Move ctor: " << movedTo.length() << " moved, " << names.length() << " left behind, correct? " << (holdsNames(movedTo, "first", 100, numNames) ? "Yes" : "No") << std::endl;
+    DynamicArray<std::string> assigned;
+    assigned.append("old");
+    assigned = std::move(movedTo);
+    std::cout << "Move assignment: " << assigned.length() << " moved, " << movedTo.length() << " left behind, correct? " << (holdsNames(assigned, "first", 100, numNames) ? "Yes" : "No") << std::endl;
+    names.append("reused");
+    std::cout << "Moved-from array reused: " << names.length() << " element, " << names.get(0) << std::endl;
+
+    DynamicArray<Tracked> tracked;
+    for (unsigned int i = 0; i < numNames; ++i)
+    {
+        tracked.emplaceBack("t" + std::to_string(i));
+    }
+    tracked.append(Tracked("last"));
+    tracked.insert(0, Tracked("first"));
+    tracked.remove(50);
+    tracked.removeIf([](const Tracked& elem) { return elem.m_name.size() == 2; }); // "t0" .. "t9"
+    DynamicArray<Tracked> trackedMoved(std::move(tracked));
+    std::cout << "Tracked: " << trackedMoved.length() << " elements, " << Tracked::s_copies << " copies, " << Tracked::s_moves << " moves" << std::endl;
+
+    // capacity only changes when the growth policy says so
+    std::cout << "\nCapacity:" << std::endl;
+    DynamicArray<int> sized;
+    for (int i = 0; i < 64; ++i)
+    {
+        sized.append(i);
+    }
+    std::cout << "Length " << sized.length() << ", capacity " << sized.capacity();
+    unsigned int changes = capacityChanges(sized, 1000); // grows to 128 on the first append, and 64 is not sparse enough to halve it
+    std::cout << ", append/remove 1000 times at the boundary -> capacity " << sized.capacity() << ", changed " << changes << " times after the first" << std::endl;
+    sized.removeRange(16, 64); // an eighth of 128 - halves twice, to 32
+    changes = capacityChanges(sized, 1000);
+    std::cout << "Length " << sized.length() << ", append/remove 1000 times at the shrink threshold -> capacity " << sized.capacity() << ", changed " << changes << " times after the first" << std::endl;
+
+    DynamicArray<int> reserved;
+    reserved.reserve(1000);
+    reserved.append(0);
+    int* data = reserved.getPtr(0);
+    for (int i = 1; i < 1000; ++i)
+    {
+        reserved.append(i);
+    }
+    std::cout << "reserve(1000) then 1000 appends: capacity " << reserved.capacity() << ", reallocated? " << (reserved.getPtr(0) != data ? "Yes" : "No") << std::endl;
+    reserved.reserve(10); // never shrinks
+    reserved.removeRange(10, 1000);
+    std::cout << "reserve(10) then remove down to " << reserved.length() << ": capacity " << reserved.capacity();
+    reserved.shrinkToFit();
+    std::cout << ", after shrinkToFit " << reserved.capacity();
+    reserved.append(10);
+    std::cout << ", after one more append " << reserved.capacity();
+    reserved.removeRange(0, 11);
+    std::cout << ", after removing all " << reserved.capacity() << std::endl;
+
+    DynamicArray<int> pinned; // a reserve holds through removes until shrinkToFit
+    pinned.reserve(1000);
+    pinned.append(1);
+    pinned.append(2);
+    pinned.remove(0);
+    std::cout << "reserve(1000), two appends and a remove: capacity " << pinned.capacity();
+    pinned.clear();
+    std::cout << ", after clear " << pinned.capacity() << std::endl;
+
+    DynamicArray<int, GrowthPolicy<3, 2, 8, 4>> slowGrowth(4); // 1.5x growth, halves at an eighth full
+    std::cout << "GrowthPolicy<3, 2, 8, 4> capacities: " << capacitySteps(slowGrowth, 100);
+    slowGrowth.removeRange(20, 100);
+    std::cout << ", after removing down to 20: " << slowGrowth.capacity();
+    slowGrowth.removeRange(10, 20);
+    std::cout << ", down to 10: " << slowGrowth.capacity() << std::endl;
+    DynamicArray<int, GrowthPolicy<2, 1, 0>> noShrink(4); // never shrinks
+    capacitySteps(noShrink, 100);
+    noShrink.removeRange(0, 100);
+    std::cout << "GrowthPolicy<2, 1, 0> after removing all 100: capacity " << noShrink.capacity() << std::endl;
+
+    // the vectorised searches must agree with plain == loops for every element type they take
+    std::cout << "\nSIMD kernels against scalar loops:" << std::endl;
+    std::mt19937 rng(3);
+    const float nanF = std::numeric_limits<float>::quiet_NaN();
+    const double nanD = std::numeric_limits<double>::quiet_NaN();
+    unsigned int numWrong = 0;
+    numWrong += checkSearch<int8_t>("int8_t", rng, { -128, -1, 0, 1, 127 });
+    numWrong += checkSearch<uint8_t>("uint8_t", rng, { 0, 1, 128, 255 });
+    numWrong += checkSearch<int16_t>("int16_t", rng, { -32768, -1, 0, 1, 256, 32767 });
+    numWrong += checkSearch<int32_t>("int32_t", rng, { std::numeric_limits<int32_t>::min(), -1, 0, 1, 65536, std::numeric_limits<int32_t>::max() });
+    numWrong += checkSearch<uint32_t>("uint32_t", rng, { 0, 1, 65536, 0x80000000u, 0xFFFFFFFFu });
+    numWrong += checkSearch<int64_t>("int64_t", rng, { std::numeric_limits<int64_t>::min(), -1, 0, 1, (1ll << 32) | 1, 1ll << 32 }); // same low or high halves
+    numWrong += checkSearch<uint64_t>("uint64_t", rng, { 0, 1, (1ull << 32) | 1, 1ull << 32, 0xFFFFFFFF00000000ull, ~0ull });
+    numWrong += checkSearch<float>("float", rng, { nanF, 1.0f, -0.0f, 0.0f, -1.0f }); // NaN matches nothing, -0.0 matches 0.0
+    numWrong += checkSearch<double>("double", rng, { nanD, 1.0, -0.0, 0.0, -1.0 });
+    numWrong += checkSearch<char>("char", rng, { 'a', 'b', '\0', static_cast<char>(-1) });
+    numWrong += checkSearch<bool>("bool", rng, { false, true });
+    std::cout << "Total mismatches: " << numWrong << std::endl;
+
+    return 0;
+}
@@ -1,4 +1,8 @@
 #include <HashTable.hpp>
+#include <InlineString.hpp>
+#include <random>
+#include <unordered_map>
+#include <vector>
 using namespace datastructlib;
 
 class IntHash : public HashFunctor<int> {
@@ -8,6 +12,40 @@ public:
     }
 };
 
+// every key hashes to one of seven home slots, so keys pile up in long clusters
+class ModSevenHash : public HashFunctor<int> {
+public:
+    unsigned int operator()(const int& key, const unsigned int& arrLength) override {
+        return (key % 7) % arrLength;
+    }
+};
+
+// probe functor written against the stepping api only - the default offset replays it, so tables built from it still probe past collisions
+class StepProbeFunctor : public ProbeFunctor {
+private:
+    unsigned int m_x = 0;
+public:
+    void reset() override {
+        this->m_x = 0;
+    }
+    unsigned int increment(const unsigned int& arrLength) override {
+        this->m_x += 1;
+        return 3 * this->m_x;
+    }
+};
+
+// value that counts its live copies, so the number of key-value pairs a table holds can be read off
+struct CountedVal
+{
+    inline static int s_live = 0;
+    int m_val;
+
+    CountedVal(const int& val = 0) : m_val(val) { s_live++; }
+    CountedVal(const CountedVal& other) : m_val(other.m_val) { s_live++; }
+    CountedVal& operator=(const CountedVal& other) = default;
+    ~CountedVal() { s_live--; }
+};
+
 int main() {
     IntHash hashFunc;
     HashTable_DynamicArrayInterface<int, int> interface;
@@ -21,5 +59,256 @@ int main() {
     ht.remove(6);
     ht.display();
 
+    // chains of up to 4 entries held inline in each bucket
+    HashTable_SmallDynamicArrayInterface<int, int, 4> smallInterface;
+    HashTable_SeperateChaining<int, int, SmallDynamicArray<KeyValPair<int, int>*, 4>> smallHt(5, &smallInterface, &hashFunc);
+
+    smallHt.insert(2, 400);
+    smallHt.insert(7, 500);
+    smallHt.insert(3, 600);
+    smallHt.display();
+
+    smallHt.remove(2);
+    smallHt.display();
+
+    // linked list chains - pairs and list nodes come from slab allocators, removed cells are reused by later inserts
+    HashTable_SinglyLinkedListInterface<int, int> listInterface;
+    HashTable_SeperateChaining<int, int, SinglyLinkedList<KeyValPair<int, int>*>> listHt(5, &listInterface, &hashFunc);
+    for (int i = 0; i < 100; ++i)
+    {
+        listHt.insert(i, i * 10);
+    }
+    for (int i = 0; i < 100; i += 2) // removes heads, tails and interior nodes of the chains
+    {
+        listHt.remove(i);
+    }
+    for (int i = 100; i < 150; ++i)
+    {
+        listHt.insert(i, i * 10);
+    }
+    std::cout << "Linked list chains: find 51 -> " << listHt.find(51).m_kvpPtr->m_val << ", find 50 -> " << (listHt.find(50).m_kvpPtr == nullptr ? "not found" : "found") << ", ";
+    listHt.arenaUsage().print();
+
+    // open addressing with pairs stored inline in the slot array
+    LinearProbeFunctor probeFunc(1, 0);
+    HashTable_FlatOpenAddressing<int, int> flatHt(4, &hashFunc, &probeFunc, 0.75);
+    for (int i = 0; i < 10; ++i)
+    {
+        flatHt.insert(i * 3, i * 100);
+    }
+    flatHt.remove(9);
+    flatHt.insert(12, 1200); // overwrites existing value
+    flatHt.display();
+    std::cout << "Find 12 -> " << flatHt.find(12).m_kvpPtr->m_val << ", find 9 -> " << (flatHt.find(9).m_kvpPtr == nullptr ? "not found" : "found") << std::endl;
+
+
+    // a functor that only overrides reset/increment - every key below collides with another, so each insert and find probes
+    StepProbeFunctor stepProbeFunc;
+    HashTable_OpenAddressing<int, int> stepHt(8, &hashFunc, &stepProbeFunc, 0.75);
+    for (int i = 0; i < 40; ++i)
+    {
+        stepHt.insert(i * 8, i); // same home slot while the length is 8, 16, 32 or 64
+    }
+    bool allStepFound = true;
+    for (int i = 0; i < 40; ++i)
+    {
+        allStepFound = allStepFound && (stepHt.find(i * 8).m_kvpPtr != nullptr) && (stepHt.find(i * 8).m_kvpPtr->m_val == i);
+    }
+    std::cout << "Stepping probe functor: all keys found " << (allStepFound ? "yes" : "no") << ", missing key found " << (stepHt.find(4).m_kvpPtr == nullptr ? "no" : "yes") << std::endl;
+
+    // robin hood open addressing - removal shifts entries back, so churn leaves no tombstones behind
+    // keys share seven home slots, so inserts displace entries, misses end early inside clusters and removes shift cluster members back
+    ModSevenHash modSevenHash;
+    HashTable_RobinHood<int, int> robinHoodHt(8, &modSevenHash, 0.9);
+    for (int i = 0; i < 1000; ++i)
+    {
+        robinHoodHt.insert(i, i);
+    }
+    for (int round = 0; round < 5; ++round) // churn: remove every other key from the middle of the clusters and add them back
+    {
+        for (int i = round % 2; i < 1000; i += 2)
+        {
+            robinHoodHt.remove(i);
+        }
+        for (int i = round % 2; i < 1000; i += 2)
+        {
+            robinHoodHt.insert(i, i + round);
+        }
+    }
+    unsigned int numRemoved = 0;
+    for (int i = 1; i < 1000; i += 3) // a third of every cluster, none at its ends
+    {
+        numRemoved += robinHoodHt.remove(i) ? 1 : 0;
+    }
+    unsigned int robinHoodWrong = 0;
+    for (int i = 0; i < 1000; ++i)
+    {
+        bool found = (robinHoodHt.find(i).m_kvpPtr != nullptr);
+        robinHoodWrong += (found != (i % 3 != 1)) ? 1 : 0;
+        robinHoodWrong += (found && (robinHoodHt.find(i).m_kvpPtr->m_val != i + ((i % 2 == 0) ? 4 : 3))) ? 1 : 0;
+    }
+    for (int i = 1000; i < 1100; ++i) // never inserted, but share the home slots
+    {
+        robinHoodWrong += (robinHoodHt.find(i).m_kvpPtr != nullptr) ? 1 : 0;
+    }
+    std::cout << "Robin hood with colliding keys: " << numRemoved << " removed, " << robinHoodWrong << " wrong lookups"
+        << ", average probe length " << robinHoodHt.averageProbeLength() << ", max probe length " << robinHoodHt.maxProbeLength() << std::endl;
+
+    // compile-time policies instead of functor ptrs - hash and probe calls are resolved statically
+    HashTable_FlatOpenAddressing<int, int, StdHash<int>, LinearProbe<1, 0>> policyHt(8, StdHash<int>(), LinearProbe<1, 0>(), 0.75);
+    for (int i = 0; i < 20; ++i)
+    {
+        policyHt.insert(i, i * i);
+    }
+    std::cout << "Policy table: find 7 -> " << policyHt.find(7).m_kvpPtr->m_val << ", load factor " << policyHt.loadFactor() << std::endl;
+
+    // incremental resize - each operation migrates two old slots, so the resize is spread over later calls
+    HashTable_OpenAddressing<int, int> incrementalHt(4, &hashFunc, &probeFunc, 0.75);
+    incrementalHt.setIncrementalResize(2);
+    for (int i = 0; i < 4; ++i)
+    {
+        incrementalHt.insert(i * 5, i);
+    }
+    incrementalHt.display(); // resize started by the fourth insert, old slots still to migrate
+    std::cout << "Find 15 while resizing -> " << incrementalHt.find(15).m_kvpPtr->m_val << ", still resizing " << (incrementalHt.isResizing() ? "yes" : "no") << std::endl;
+
+    // random churn against std::unordered_map in both resize modes - removes and tombstone reuse happen while old slots are still migrating
+    for (unsigned int migrationStep : { 0, 1 })
+    {
+        HashTable_OpenAddressing<int, int> churnHt(8, &hashFunc, &probeFunc, 0.75);
+        churnHt.setIncrementalResize(migrationStep);
+        std::unordered_map<int, int> reference;
+        std::mt19937 rng(1);
+        unsigned int numWrong = 0, lookupsWhileResizing = 0, removesWhileResizing = 0, resizesWhileResizing = 0;
+        for (int i = 0; i < 200000; ++i)
+        {
+            int key = static_cast<int>(rng() % 5000);
+            unsigned int op = rng() % 4;
+            bool resizing = churnHt.isResizing();
+            if (op == 0)
+            {
+                if (reference.count(key) == 0) // the table keeps duplicates, so only absent keys are inserted
+                {
+                    double loadFactor = churnHt.loadFactor();
+                    churnHt.insert(key, i);
+                    reference[key] = i;
+                    resizesWhileResizing += (resizing && (churnHt.loadFactor() < 0.75 * loadFactor)) ? 1 : 0; // a new resize, which halves the load factor, began before the last had finished - migration freeing tombstones only lowers it a little
+                }
+            }
+            else if (op == 1)
+            {
+                numWrong += (churnHt.remove(key) != (reference.erase(key) == 1)) ? 1 : 0;
+                removesWhileResizing += resizing ? 1 : 0;
+            }
+            else
+            {
+                HashTable_SearchResult<int, int> result = churnHt.find(key); // swaps found pairs into earlier tombstones
+                std::unordered_map<int, int>::iterator it = reference.find(key);
+                numWrong += ((result.m_kvpPtr == nullptr) != (it == reference.end()) || ((result.m_kvpPtr != nullptr) && (result.m_kvpPtr->m_val != it->second))) ? 1 : 0;
+                lookupsWhileResizing += resizing ? 1 : 0;
+            }
+            if (i == 100000)
+            {
+                churnHt.resizeArray(16384); // finishes any migration in progress first
+            }
+        }
+        std::cout << "Churn with migration step " << migrationStep << ": " << numWrong << " mismatches, " << lookupsWhileResizing << " lookups and " << removesWhileResizing
+            << " removes during migration, " << resizesWhileResizing << " resizes started during migration" << std::endl;
+    }
+
+    // a fixed set of 100 live keys under insert/remove churn - tombstoned pairs are freed by every resize, so memory follows the live keys rather than every insert made
+    for (unsigned int migrationStep : { 0, 1 })
+    {
+        int livePairsBefore = CountedVal::s_live;
+        HashTable_OpenAddressing<int, CountedVal, StdHash<int>, LinearProbe<1, 0>> fixedHt(8, StdHash<int>(), LinearProbe<1, 0>(), 0.75);
+        fixedHt.setIncrementalResize(migrationStep);
+        std::mt19937 rng(2);
+        std::vector<int> live;
+        for (int i = 0; i < 100; ++i)
+        {
+            fixedHt.insert(i, CountedVal(i));
+            live.push_back(i);
+        }
+        unsigned int numWrong = 0;
+        int maxPairs = 0;
+        for (int i = 100; i < 200000; ++i)
+        {
+            unsigned int ind = rng() % live.size();
+            numWrong += fixedHt.remove(live[ind]) ? 0 : 1;
+            live[ind] = i;
+            fixedHt.insert(i, CountedVal(i));
+            maxPairs = (CountedVal::s_live - livePairsBefore > maxPairs) ? CountedVal::s_live - livePairsBefore : maxPairs;
+        }
+        fixedHt.setIncrementalResize(0); // finishes the migration in progress
+        for (int key : live)
+        {
+            numWrong += (fixedHt.find(key).m_kvpPtr == nullptr) ? 1 : 0;
+        }
+        std::cout << "Fixed live set with migration step " << migrationStep << ": " << numWrong << " mismatches, at most " << maxPairs << " pairs allocated, "
+            << CountedVal::s_live - livePairsBefore << " for 100 live keys at the end, load factor " << fixedHt.loadFactor() << std::endl;
+    }
+
+    // instrumented table - HashTableStats collects counters and histograms, the default NullStats compiles them out
+    HashTable_FlatOpenAddressing<int, int, StdHash<int>, LinearProbe<1, 0>, std::equal_to<int>, HashTableStats> statsHt(8, StdHash<int>(), LinearProbe<1, 0>(), 0.75);
+    for (int i = 0; i < 100; ++i)
+    {
+        statsHt.insert(i * 4, i);
+    }
+    for (int i = 0; i < 100; i += 3)
+    {
+        statsHt.remove(i * 4);
+    }
+    for (int i = 0; i < 200; ++i)
+    {
+        statsHt.find(i * 2);
+    }
+    statsHt.stats().print();
+
+    // resizes and removes don't add inserts or lookups of their own - 100 inserts with five resizes, 10 removes and no finds
+    HashTable_OpenAddressing<int, int, StdHash<int>, LinearProbe<1, 0>, std::equal_to<int>, HashTableStats> countedHt(8, StdHash<int>(), LinearProbe<1, 0>(), 0.75);
+    for (int i = 0; i < 100; ++i)
+    {
+        countedHt.insert(i, i);
+    }
+    for (int i = 0; i < 10; ++i)
+    {
+        countedHt.remove(i);
+    }
+    std::cout << "Counted: inserts " << countedHt.stats().m_inserts << ", lookups " << countedHt.stats().m_hits + countedHt.stats().m_misses
+        << ", removes " << countedHt.stats().m_removes << ", resizes " << countedHt.stats().m_resizes << std::endl;
+
+    // strided ids (multiples of 64) - modulo hashing sends them all to a few slots, MaskedHash spreads them over the whole array
+    HashTable_FlatOpenAddressing<int, int, StdHash<int>, LinearProbe<1, 0>, std::equal_to<int>, HashTableStats> moduloHt(1024, StdHash<int>(), LinearProbe<1, 0>(), 0.75);
+    HashTable_FlatOpenAddressing<int, int, MaskedHash<int>, LinearProbe<1, 0>, std::equal_to<int>, HashTableStats> maskedHt(1000, MaskedHash<int>(), LinearProbe<1, 0>(), 0.75); // length rounded up to 1024
+    for (int i = 0; i < 500; ++i)
+    {
+        moduloHt.insert(i * 64, i);
+        maskedHt.insert(i * 64, i);
+    }
+    std::cout << "Strided ids: average probe length with modulo " << moduloHt.stats().averageProbeLength() << ", with MaskedHash " << maskedHt.stats().averageProbeLength() << std::endl;
+
+    // short string keys stored inline in the slots, found by std::string_view without building a key (transparent Hasher and std::equal_to<>)
+    HashTable_FlatOpenAddressing<InlineString<15>, int, MaskedHash<InlineString<15>>, LinearProbe<1, 0>, std::equal_to<>> stringHt(8, MaskedHash<InlineString<15>>(), LinearProbe<1, 0>(), 0.75);
+    const char* names[] = {"alpha", "beta", "gamma", "delta", "epsilon", "zeta", "eta", "theta"};
+    for (int i = 0; i < 8; ++i)
+    {
+        stringHt.insert(names[i], i);
+    }
+    const char* line = "gamma,delta";
+    std::string_view field(line, 5); // points into the caller's buffer
+    std::cout << "Find " << field << " -> " << stringHt.find(field).m_kvpPtr->m_val << ", find \"omega\" -> " << (stringHt.find("omega").m_kvpPtr == nullptr ? "not found" : "found") << std::endl;
+
+    // the pointer-slot and chained tables take the same transparent lookups
+    HashTable_OpenAddressing<std::string, int, MaskedHash<std::string>, LinearProbe<1, 0>, std::equal_to<>> ptrStringHt(8, MaskedHash<std::string>(), LinearProbe<1, 0>(), 0.75);
+    HashTable_DynamicArrayInterface<std::string, int> stringInterface;
+    HashTable_SeperateChaining<std::string, int, DynamicArray<KeyValPair<std::string, int>*>, MaskedHash<std::string>, std::equal_to<>> chainStringHt(8, &stringInterface, MaskedHash<std::string>());
+    for (int i = 0; i < 8; ++i)
+    {
+        ptrStringHt.insert(names[i], i);
+        chainStringHt.insert(names[i], i);
+    }
+    std::cout << "Open addressing find " << field << " -> " << ptrStringHt.find(field).m_kvpPtr->m_val << ", seperate chaining find " << field << " -> " << chainStringHt.find(field).m_kvpPtr->m_val
+        << ", find \"omega\" -> " << (chainStringHt.find("omega").m_kvpPtr == nullptr ? "not found" : "found") << std::endl;
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <HashTable.hpp>
+#include <SwissHashTable.hpp>
+
+using namespace datastructlib;
+
+/* benchmark: find vs findBatch on tables much larger than the cache
+    - probe keys are shuffled (half present, half missing), so nearly every lookup misses cache - as in a hash join probing millions of keys
+    - findBatch hashes and prefetches a block of keys before resolving any of them, so their cache misses overlap
+*/
+
+template <class Fn>
+double timeIt(Fn fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <class Table>
+void run(const char* name, Table& table, const std::vector<unsigned long long>& keys, const std::vector<unsigned long long>& probes)
+{
+    std::vector<unsigned long long> vals(keys.size());
+    for (unsigned int i = 0; i < keys.size(); ++i)
+    {
+        vals[i] = i;
+    }
+    double insertSeconds = timeIt([&]() { table.insertBatch(keys.data(), vals.data(), static_cast<unsigned int>(keys.size())); });
+
+    unsigned long long sum = 0, batchSum = 0;
+    double findSeconds = timeIt([&]() {
+        for (unsigned int i = 0; i < probes.size(); ++i)
+        {
+            HashTable_SearchResult<unsigned long long, unsigned long long> result = table.find(probes[i]);
+            sum += (result.m_kvpPtr != nullptr) ? result.m_kvpPtr->m_val : 1;
+        }
+    });
+    std::vector<HashTable_SearchResult<unsigned long long, unsigned long long>> results(probes.size());
+    double batchSeconds = timeIt([&]() {
+        table.findBatch(probes.data(), static_cast<unsigned int>(probes.size()), results.data());
+        for (unsigned int i = 0; i < probes.size(); ++i)
+        {
+            batchSum += (results[i].m_kvpPtr != nullptr) ? results[i].m_kvpPtr->m_val : 1;
+        }
+    });
+
+    double lookups = probes.size() / 1e6;
+    std::cout << name << "\t" << keys.size() / 1e6 / insertSeconds << "\t\t" << lookups / findSeconds << "\t\t" << lookups / batchSeconds
+        << (sum == batchSum ? "" : "\tDIFFER") << std::endl;
+}
+
+int main() {
+    const unsigned int numKeys = 1 << 21;
+
+    std::mt19937_64 rng(7);
+    std::vector<unsigned long long> keys(numKeys), probes(2 * numKeys);
+    for (unsigned int i = 0; i < numKeys; ++i)
+    {
+        keys[i] = rng();
+        probes[2 * i] = keys[i];
+        probes[2 * i + 1] = rng(); // almost certainly missing
+    }
+    std::shuffle(probes.begin(), probes.end(), rng);
+
+    std::cout << numKeys << " keys, " << probes.size() << " lookups" << std::endl;
+    std::cout << "table\t\tinsertBatch\tfind\t\tfindBatch (M/s)" << std::endl;
+    {
+        HashTable_FlatOpenAddressing<unsigned long long, unsigned long long, MaskedHash<unsigned long long>, LinearProbe<1, 0>> flat(16, MaskedHash<unsigned long long>(), LinearProbe<1, 0>(), 0.75);
+        run("flat\t", flat, keys, probes);
+    }
+    {
+        HashTable_RobinHood<unsigned long long, unsigned long long, MaskedHash<unsigned long long>> robinHood(16, MaskedHash<unsigned long long>(), 0.9);
+        run("robin hood", robinHood, keys, probes);
+    }
+    {
+        HashTable_Swiss<unsigned long long, unsigned long long> swiss;
+        run("swiss\t", swiss, keys, probes);
+    }
+}
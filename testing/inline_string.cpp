@@ -0,0 +1,49 @@
+#define NDEBUG // the length check must also hold in release builds, where asserts are compiled out
+#include <HashTable.hpp>
+#include <InlineString.hpp>
+#include <iostream>
+#include <stdexcept>
+
+using namespace datastructlib;
+
+int main() {
+    InlineString<7> fits("seven!!");
+    std::cout << "Fits: " << fits << " (" << fits.length() << " chars)" << std::endl;
+
+    bool threw = false;
+    try
+    {
+        InlineString<7> tooLong("eight!!!");
+    }
+    catch (const std::length_error&)
+    {
+        threw = true;
+    }
+    std::cout << "Eight chars into InlineString<7> throws length_error? " << (threw ? "Yes" : "No") << std::endl;
+
+    // a long key passed to insert converts implicitly - it must be rejected before it reaches the slot array
+    HashTable_FlatOpenAddressing<InlineString<15>, int, MaskedHash<InlineString<15>>, LinearProbe<1, 0>, std::equal_to<>> table(8, MaskedHash<InlineString<15>>(), LinearProbe<1, 0>(), 0.75);
+    const char* names[] = {"alpha", "beta", "gamma", "delta"};
+    for (int i = 0; i < 4; ++i)
+    {
+        table.insert(names[i], i);
+    }
+    threw = false;
+    try
+    {
+        table.insert("a key well past fifteen chars", 99);
+    }
+    catch (const std::length_error&)
+    {
+        threw = true;
+    }
+    bool intact = true;
+    for (int i = 0; i < 4; ++i)
+    {
+        HashTable_SearchResult<InlineString<15>, int> result = table.find(names[i]);
+        intact = intact && (result.m_kvpPtr != nullptr) && (result.m_kvpPtr->m_val == i);
+    }
+    std::cout << "Long key insert throws? " << (threw ? "Yes" : "No") << ", other pairs intact? " << (intact ? "Yes" : "No")
+        << ", long key found by string_view? " << (table.find(std::string_view("a key well past fifteen chars")).m_kvpPtr == nullptr ? "No" : "Yes") << std::endl;
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include <iostream>
+#include <csignal>
+#include <sys/resource.h>
+#include <MappedDynamicArray.hpp>
+
+using namespace datastructlib;
+
+int main() {
+    const char* path = "mapped_array_test.bin";
+
+    // build the array in a file
+    MappedDynamicArray<unsigned long long> arr;
+    if (!arr.create(path, 4))
+    {
+        std::cout << "Failed to create " << path << std::endl;
+        return 1;
+    }
+    for (unsigned long long i = 0; i < 10; ++i)
+    {
+        arr.append(i * i); // grows the file past the initial capacity of 4
+    }
+    std::cout << "Written " << arr.length() << " elements, capacity " << arr.capacity() << std::endl;
+    arr.close();
+
+    // map the file again read-only - no elements are copied
+    MappedDynamicArray<unsigned long long> view;
+    std::cout << "\nOpen read-only? " << (view.open(path) ? "Yes" : "No") << std::endl;
+    view.print();
+
+    // element size in the header must match
+    MappedDynamicArray<int> wrongType;
+    std::cout << "\nOpen with wrong element type? " << (wrongType.open(path) ? "Yes" : "No") << std::endl;
+
+    // reopen read-write and keep appending
+    view.open(path, false);
+    view.append(100);
+    view.set(0, 7);
+    std::cout << "\nAfter reopening read-write, appending 100 and setting index 0 to 7:" << std::endl;
+    view.print();
+
+    // a file that can't grow - appends past the capacity fail without writing, and the array stays usable
+    std::signal(SIGXFSZ, SIG_IGN); // report EFBIG instead of killing the process
+    rlimit oldLimit;
+    ::getrlimit(RLIMIT_FSIZE, &oldLimit);
+    rlimit limit = oldLimit;
+    limit.rlim_cur = sizeof(MappedArrayHeader) + sizeof(unsigned long long) * view.capacity();
+    ::setrlimit(RLIMIT_FSIZE, &limit);
+    unsigned int length = view.length();
+    unsigned long long vals[64] = {};
+    bool appended = view.appendRange(vals, 64);
+    unsigned int lengthAfterFail = view.length();
+    bool appendedOne = true;
+    while (appendedOne && (view.length() < view.capacity()))
+    {
+        appendedOne = view.append(1); // fits without growing
+    }
+    bool appendedPast = view.append(2);
+    ::setrlimit(RLIMIT_FSIZE, &oldLimit);
+    std::cout << "\nWith the file size capped: appendRange of 64 " << (appended ? "succeeded" : "failed") << ", length " << length << " -> " << lengthAfterFail
+        << ", filled to capacity " << view.capacity() << "? " << (appendedOne ? "Yes" : "No") << ", append past it " << (appendedPast ? "succeeded" : "failed")
+        << ", still open? " << (view.isOpen() ? "Yes" : "No") << ", index 0 is " << view.get(0) << std::endl;
+    std::cout << "Uncapped append " << (view.append(3) ? "succeeded" : "failed") << ", length " << view.length() << std::endl;
+    view.close();
+
+    ::unlink(path);
+}
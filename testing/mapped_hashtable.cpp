@@ -0,0 +1,84 @@
+#include <MappedHashTable.hpp>
+#include <SwissHashTable.hpp>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+using namespace datastructlib;
+
+// builds a table of string keys with insert, freezes it into a file and compares rebuilding it with mapping the file
+int main() {
+    const char* path = "mapped_hashtable_test.bin";
+    const unsigned int numKeys = 500000;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    HashTable_Swiss<std::string, unsigned long long> table;
+    for (unsigned int i = 0; i < numKeys; ++i)
+    {
+        table.insert("user:" + std::to_string(i), i * 7ull);
+    }
+    double buildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    MappedHashTableWriter<std::string, unsigned long long> writer;
+    writer.addTable(table);
+    if (!writer.write(path))
+    {
+        std::cout << "Failed to write " << path << std::endl;
+        return 1;
+    }
+    double writeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // start-up: map the file and answer the first lookup
+    start = std::chrono::steady_clock::now();
+    MappedHashTable<std::string, unsigned long long> view;
+    bool opened = view.open(path);
+    unsigned long long val = 0;
+    bool found = opened && view.find("user:12345", val);
+    double openSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Open: " << (opened ? "Yes" : "No") << ", " << view.size() << " pairs, find user:12345 -> " << (found ? std::to_string(val) : "not found") << std::endl;
+
+    unsigned int numWrong = 0;
+    for (unsigned int i = 0; i < numKeys; ++i)
+    {
+        std::string key = "user:" + std::to_string(i);
+        numWrong += (!view.find(key, val) || (val != i * 7ull)) ? 1 : 0;
+    }
+    std::cout << "Wrong lookups: " << numWrong << ", missing key found? " << (view.contains("user:-1") ? "Yes" : "No") << std::endl;
+
+    // values that are strings come back as views into the mapping
+    MappedHashTableWriter<unsigned int, std::string> nameWriter;
+    nameWriter.add(1, "one");
+    nameWriter.add(2, "two");
+    nameWriter.add(1, "uno"); // repeated key keeps the last value
+    nameWriter.write(path);
+    MappedHashTable<unsigned int, std::string> names;
+    std::string_view name;
+    names.open(path);
+    std::cout << "Names: " << names.size() << " pairs, find 1 -> " << (names.find(1, name) ? name : "not found") << std::endl;
+
+    // key and value types in the header must match
+    MappedHashTable<std::string, unsigned long long> wrongType;
+    std::cout << "Open with wrong types? " << (wrongType.open(path) ? "Yes" : "No") << std::endl;
+
+    // types of the same size but another kind don't match either
+    const char* kindPath = "mapped_hashtable_kind_test.bin";
+    MappedHashTableWriter<uint32_t, float> kindWriter;
+    kindWriter.add(1, 0.5f);
+    kindWriter.write(kindPath);
+    MappedHashTable<int, int> signedView;
+    MappedHashTable<uint32_t, uint32_t> unsignedView;
+    MappedHashTable<uint32_t, float> floatView;
+    std::cout << "Open <uint32_t, float> as <int, int>? " << (signedView.open(kindPath) ? "Yes" : "No")
+        << ", as <uint32_t, uint32_t>? " << (unsignedView.open(kindPath) ? "Yes" : "No")
+        << ", as <uint32_t, float>? " << (floatView.open(kindPath) ? "Yes" : "No") << std::endl;
+    floatView.close();
+    std::remove(kindPath);
+
+    std::cout << "Build with insert: " << buildSeconds << " s, write snapshot: " << writeSeconds << " s, open and first find: " << openSeconds << " s" << std::endl;
+    names.close();
+    view.close();
+    std::remove(path);
+    return 0;
+}
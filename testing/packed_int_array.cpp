@@ -0,0 +1,52 @@
+#include <iostream>
+#include <PackedIntArray.hpp>
+
+using namespace datastructlib;
+
+int main() {
+    // counters below 2^12 fit in 12 bits each
+    PackedIntArray arr(12);
+    for (unsigned int i = 0; i < 1000; ++i)
+    {
+        arr.append((i * 37) % 4096);
+    }
+    std::cout << "Width " << arr.bitWidth() << " bits, " << arr.length() << " elements in " << arr.memoryBytes() << " bytes (" << arr.length() * sizeof(unsigned int) << " bytes as unsigned int)" << std::endl;
+    std::cout << "Element 999: " << arr.get(999) << " (expected " << (999 * 37) % 4096 << ")" << std::endl;
+
+    // a value needing 20 bits widens the whole array
+    arr.append(1 << 19);
+    arr.set(0, 123456);
+    std::cout << "\nAfter appending 2^19 and setting index 0 to 123456, width is " << arr.bitWidth() << " bits" << std::endl;
+    std::cout << "Element 0: " << arr.get(0) << ", element 1000: " << arr.get(1000) << ", element 5: " << arr.get(5) << std::endl;
+
+    // bulk decode into a caller buffer
+    unsigned int out[1001];
+    arr.unpack(0, arr.length(), out);
+    bool unpackCorrect = true;
+    for (unsigned int i = 0; i < arr.length(); ++i)
+    {
+        if (out[i] != arr.get(i))
+            unpackCorrect = false;
+    }
+    std::cout << "\nUnpack matches get? " << (unpackCorrect ? "Yes" : "No") << std::endl;
+
+    // every width from 1 to 64 round-trips through append/get/unpack
+    bool allWidthsCorrect = true;
+    for (unsigned int width = 1; width <= 64; ++width)
+    {
+        PackedIntArray widthArr(width);
+        unsigned long long maxVal = (width == 64) ? ~0ull : ((1ull << width) - 1);
+        for (unsigned int i = 0; i < 77; ++i)
+        {
+            widthArr.append((0x9E3779B97F4A7C15ull * (i + 1)) & maxVal);
+        }
+        unsigned long long wideOut[77];
+        widthArr.unpack(3, 74, wideOut);
+        for (unsigned int i = 0; i < 77; ++i)
+        {
+            if (widthArr.get(i) != ((0x9E3779B97F4A7C15ull * (i + 1)) & maxVal) || ((i >= 3) && (wideOut[i - 3] != widthArr.get(i))) || (widthArr.bitWidth() != width))
+                allWidthsCorrect = false;
+        }
+    }
+    std::cout << "All widths 1-64 correct? " << (allWidthsCorrect ? "Yes" : "No") << std::endl;
+}
@@ -0,0 +1,52 @@
+#include <iostream>
+#include <ParallelAlgorithms.hpp>
+
+using namespace datastructlib;
+
+int main() {
+    const unsigned int n = 1000000;
+    const unsigned int numThreads = 4;
+    DynamicArray<long long> arr;
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        arr.append(i % 7);
+    }
+
+    // reduce
+    long long sum = parallelReduce(arr, 0LL, [](const long long& a, const long long& b) { return a + b; }, numThreads);
+    long long expectedSum = 0;
+    for (unsigned int i = 0; i < n; ++i)
+        expectedSum += i % 7;
+    std::cout << "Sum: " << sum << " (expected " << expectedSum << ")" << std::endl;
+
+    // transform then for-each
+    parallelTransform(arr, [](const long long& val) { return 2 * val; }, numThreads);
+    parallelForEach(arr, [](long long& val, const unsigned int& ind) { val += (ind == 0) ? 1 : 0; }, numThreads);
+    std::cout << "After doubling and adding 1 to index 0, first elements: " << arr.get(0) << ", " << arr.get(1) << ", " << arr.get(2) << std::endl;
+
+    // inclusive scan gives prefix sums - the last one is the total
+    DynamicArray<long long> prefix = arr;
+    parallelInclusiveScan(prefix, [](const long long& a, const long long& b) { return a + b; }, numThreads);
+    bool scanCorrect = true;
+    long long running = 0;
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        running += arr.get(i);
+        if (prefix.get(i) != running)
+            scanCorrect = false;
+    }
+    std::cout << "Inclusive scan correct? " << (scanCorrect ? "Yes" : "No") << ", total " << prefix.get(n - 1) << std::endl;
+
+    // exclusive scan starting from 100
+    DynamicArray<long long> exclusive = arr;
+    parallelExclusiveScan(exclusive, 100LL, [](const long long& a, const long long& b) { return a + b; }, numThreads);
+    scanCorrect = true;
+    running = 100;
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        if (exclusive.get(i) != running)
+            scanCorrect = false;
+        running += arr.get(i);
+    }
+    std::cout << "Exclusive scan correct? " << (scanCorrect ? "Yes" : "No") << ", first " << exclusive.get(0) << std::endl;
+}
@@ -0,0 +1,110 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <PerfectHash.hpp>
+
+using namespace datastructlib;
+
+/* benchmark: StaticHashMap (minimal perfect hash) vs HashTable_OpenAddressing over the same static key set
+    - build time: one perfect hash build vs inserting every key
+    - lookups: shuffled probes, half present and half missing
+    - memory: pairs plus perfect hash vs slot array of pointers plus one heap allocated pair per key
+    - the perfect hash is also passed as a HashFunctor to HashTable_OpenAddressing, where no key of the set ever probes past its home slot
+*/
+
+template <class Fn>
+double timeIt(Fn fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <class Table>
+unsigned long long sumOpenAddressing(const Table& table, const std::vector<unsigned int>& probes)
+{
+    unsigned long long sum = 0;
+    for (unsigned int i = 0; i < probes.size(); ++i)
+    {
+        HashTable_SearchResult<unsigned int, unsigned int> result = table.find(probes[i]);
+        sum += (result.m_kvpPtr != nullptr) ? result.m_kvpPtr->m_val : 1;
+    }
+    return sum;
+}
+
+int main() {
+    const unsigned int numKeys = 1 << 20;
+
+    std::mt19937 rng(11);
+    std::vector<unsigned int> keys(2 * numKeys);
+    for (unsigned int i = 0; i < keys.size(); ++i)
+    {
+        keys[i] = i * 2654435761u; // distinct, as multiplying by an odd number is a bijection
+    }
+    std::shuffle(keys.begin(), keys.end(), rng);
+    std::vector<unsigned int> probes(keys); // first half of keys is the set, second half is missing
+    std::shuffle(probes.begin(), probes.end(), rng);
+    keys.resize(numKeys);
+
+    DynamicArray<unsigned int> keyArr, valArr;
+    for (unsigned int i = 0; i < numKeys; ++i)
+    {
+        keyArr.append(keys[i]);
+        valArr.append(i);
+    }
+
+    std::cout << numKeys << " keys, " << probes.size() << " lookups" << std::endl;
+    std::cout << "table\t\t\tbuild (s)\tfind (M/s)\tbytes per key" << std::endl;
+    double lookups = probes.size() / 1e6;
+    unsigned long long expected = 0;
+
+    {
+        HashTable_OpenAddressing<unsigned int, unsigned int, MaskedHash<unsigned int>, LinearProbe<1, 0>> table(16, MaskedHash<unsigned int>(), LinearProbe<1, 0>(), 0.75);
+        double buildSeconds = timeIt([&]() {
+            for (unsigned int i = 0; i < numKeys; ++i)
+            {
+                table.insert(keys[i], i);
+            }
+        });
+        double findSeconds = timeIt([&]() { expected = sumOpenAddressing(table, probes); });
+        double slots = numKeys / table.loadFactor();
+        double bytes = slots * sizeof(KeyValPair<unsigned int, unsigned int>*) + numKeys * sizeof(KeyValPair<unsigned int, unsigned int>);
+        std::cout << "open addressing\t\t" << buildSeconds << "\t" << lookups / findSeconds << "\t\t" << bytes / numKeys << " (+ malloc overhead)" << std::endl;
+    }
+    {
+        StaticHashMap<unsigned int, unsigned int> map;
+        bool built = false;
+        double buildSeconds = timeIt([&]() { built = map.build(keyArr, valArr); });
+        unsigned long long sum = 0;
+        double findSeconds = timeIt([&]() {
+            for (unsigned int i = 0; i < probes.size(); ++i)
+            {
+                unsigned int val = 1;
+                map.find(probes[i], val);
+                sum += val;
+            }
+        });
+        std::cout << "static hash map\t\t" << buildSeconds << "\t" << lookups / findSeconds << "\t\t" << static_cast<double>(map.memoryBytes()) / numKeys
+            << (built && (sum == expected) ? "" : "\tDIFFER") << std::endl;
+        std::cout << "perfect hash: " << map.perfectHash().bitsPerKey() << " bits per key" << std::endl;
+    }
+    {
+        // perfect hash as the hash functor of an open addressing table - every key of the set lands in its own slot
+        PerfectHashFunctor<unsigned int> perfectHash;
+        LinearProbeFunctor probeFunc(1, 0);
+        double buildSeconds = timeIt([&]() { perfectHash.build(keyArr); });
+        HashTable_OpenAddressing<unsigned int, unsigned int> table(numKeys * 4 / 3 + 1, &perfectHash, &probeFunc, 0.75);
+        buildSeconds += timeIt([&]() {
+            for (unsigned int i = 0; i < numKeys; ++i)
+            {
+                table.insert(keys[i], i);
+            }
+        });
+        unsigned long long sum = 0;
+        double findSeconds = timeIt([&]() { sum = sumOpenAddressing(table, probes); });
+        std::cout << "open addressing + MPH\t" << buildSeconds << "\t" << lookups / findSeconds << (sum == expected ? "" : "\tDIFFER") << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,30 @@
+#include <iostream>
+#include <string>
+#include <SegmentedArray.hpp>
+
+using namespace datastructlib;
+
+int main() {
+    // small chunks of 4 elements so the example spans several chunks
+    SegmentedArray<std::string, 2> arr;
+
+    arr.append("zero");
+    arr.append("one");
+    std::string* firstPtr = arr.getPtr(0); // handed out before the array grows
+
+    for (unsigned int i = 2; i < 10; ++i)
+    {
+        arr.emplaceBack("value " + std::to_string(i));
+    }
+    std::cout << "Length " << arr.length() << ", capacity " << arr.capacity() << std::endl;
+    arr.print();
+
+    std::cout << "\nPtr to index 0 still valid after growth? " << ((firstPtr == arr.getPtr(0)) && (*firstPtr == "zero") ? "Yes" : "No") << std::endl;
+
+    arr.set(1, "ONE");
+    arr.removeLast();
+    arr.removeLast();
+    std::cout << "\nAfter setting index 1 and removing two elements:" << std::endl;
+    arr.print();
+    std::cout << "Length " << arr.length() << ", capacity " << arr.capacity() << std::endl;
+}
@@ -0,0 +1,163 @@
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <SmallDynamicArray.hpp>
+
+using namespace datastructlib;
+
+using Strings = SmallDynamicArray<std::string, 4>;
+
+/* true if arr holds the same strings as expected, in order */
+bool sameStrings(const Strings& arr, const std::vector<std::string>& expected)
+{
+    if (arr.length() != expected.size())
+        return false;
+    for (unsigned int i = 0; i < arr.length(); ++i)
+    {
+        if (arr.get(i) != expected[i])
+            return false;
+    }
+    return true;
+}
+
+/* returns where the elements of arr live */
+const char* where(const Strings& arr)
+{
+    return arr.isInline() ? "inline" : "heap";
+}
+
+int main() {
+    // up to N elements stay inline, the next one spills to the heap
+    Strings arr;
+    for (int i = 0; i < 4; ++i)
+    {
+        arr.append("s" + std::to_string(i));
+    }
+    std::cout << "4 elements: " << where(arr) << ", capacity " << arr.capacity() << std::endl;
+    arr.append("s4");
+    std::cout << "5 elements: " << where(arr) << ", capacity " << arr.capacity() << std::endl;
+    arr.print();
+
+    // heap storage shrinks as set by the growth policy, and goes back inline once the new capacity is N or less
+    for (int i = 5; i < 20; ++i)
+    {
+        arr.append("s" + std::to_string(i));
+    }
+    std::cout << "\n20 elements: " << where(arr) << ", capacity " << arr.capacity() << std::endl;
+    arr.removeRange(4, 20);
+    std::cout << "Removed down to 4: " << where(arr) << ", capacity " << arr.capacity() << std::endl;
+    arr.remove(3);
+    arr.remove(2);
+    std::cout << "Removed down to 2: " << where(arr) << ", capacity " << arr.capacity() << std::endl;
+    arr.print();
+
+    Strings fitted;
+    for (int i = 0; i < 6; ++i)
+    {
+        fitted.append("f" + std::to_string(i));
+    }
+    fitted.removeIf([](const std::string& elem) { return (elem == "f1") || (elem == "f4"); });
+    std::cout << "\nremoveIf f1 and f4: " << fitted.length() << " left, " << where(fitted);
+    fitted.shrinkToFit();
+    std::cout << ", after shrinkToFit " << where(fitted) << ", capacity " << fitted.capacity() << std::endl;
+    fitted.print();
+
+    // copies and moves of inline and heap-backed arrays
+    Strings small;
+    small.append("a");
+    small.append("b");
+    Strings big;
+    for (int i = 0; i < 10; ++i)
+    {
+        big.append("b" + std::to_string(i));
+    }
+    std::vector<std::string> smallExpected = { "a", "b" };
+    std::vector<std::string> bigExpected;
+    for (int i = 0; i < 10; ++i)
+    {
+        bigExpected.push_back("b" + std::to_string(i));
+    }
+    Strings smallCopy(small);
+    Strings bigCopy(big);
+    std::cout << "\nCopy inline: " << where(smallCopy) << ", correct? " << (sameStrings(smallCopy, smallExpected) && sameStrings(small, smallExpected) ? "Yes" : "No") << std::endl;
+    std::cout << "Copy heap: " << where(bigCopy) << ", correct? " << (sameStrings(bigCopy, bigExpected) && sameStrings(big, bigExpected) ? "Yes" : "No") << std::endl;
+    Strings smallMoved(std::move(smallCopy));
+    Strings bigMoved(std::move(bigCopy));
+    std::cout << "Move inline: " << where(smallMoved) << ", correct? " << (sameStrings(smallMoved, smallExpected) ? "Yes" : "No") << ", " << smallCopy.length() << " left behind" << std::endl;
+    std::cout << "Move heap: " << where(bigMoved) << ", correct? " << (sameStrings(bigMoved, bigExpected) ? "Yes" : "No") << ", " << bigCopy.length() << " left behind, now " << where(bigCopy) << std::endl;
+    Strings assigned;
+    assigned = big; // heap into inline
+    bigMoved = small; // inline into heap
+    std::cout << "Copy assignment: correct? " << (sameStrings(assigned, bigExpected) && sameStrings(bigMoved, smallExpected) ? "Yes" : "No") << std::endl;
+    assigned = std::move(smallMoved); // inline into heap
+    smallMoved = std::move(big); // heap into inline
+    std::cout << "Move assignment: correct? " << (sameStrings(assigned, smallExpected) && sameStrings(smallMoved, bigExpected) ? "Yes" : "No") << std::endl;
+
+    // elements taken from the same array, including when the array has to spill or grow to fit them
+    Strings self;
+    self.append("x0");
+    self.append("x1");
+    self.append("x2");
+    self.append("x3");
+    self.insert(0, *self.getPtr(3)); // spills
+    self.append(*self.getPtr(0));
+    self.insertRange(1, self.getPtr(3), 3); // x2, x3, x3 - grows past the capacity of 8
+    std::vector<std::string> selfExpected = { "x3", "x2", "x3", "x3", "x0", "x1", "x2", "x3", "x3" };
+    std::cout << "\nInsert from itself: correct? " << (sameStrings(self, selfExpected) ? "Yes" : "No") << std::endl;
+
+    // random operations against std::vector
+    std::mt19937 rng(4);
+    Strings randomArr;
+    std::vector<std::string> reference;
+    unsigned int numWrong = 0, numSpills = 0;
+    for (int i = 0; i < 20000; ++i)
+    {
+        unsigned int op = rng() % 6;
+        bool wasInline = randomArr.isInline();
+        if ((op <= 1) || reference.empty())
+        {
+            unsigned int ind = rng() % (reference.size() + 1);
+            std::string val = "r" + std::to_string(rng() % 50);
+            randomArr.insert(ind, val);
+            reference.insert(reference.begin() + ind, val);
+        }
+        else if (op == 2)
+        {
+            unsigned int ind = rng() % reference.size();
+            randomArr.remove(ind);
+            reference.erase(reference.begin() + ind);
+        }
+        else if (op == 3)
+        {
+            unsigned int first = rng() % reference.size();
+            unsigned int last = first + rng() % (reference.size() - first + 1);
+            randomArr.removeRange(first, last);
+            reference.erase(reference.begin() + first, reference.begin() + last);
+        }
+        else if (op == 4)
+        {
+            std::string val = "r" + std::to_string(rng() % 50);
+            randomArr.removeIf([&val](const std::string& elem) { return elem == val; });
+            std::vector<std::string> kept;
+            for (const std::string& elem : reference)
+            {
+                if (elem != val)
+                    kept.push_back(elem);
+            }
+            reference = kept;
+        }
+        else
+        {
+            unsigned int ind = rng() % reference.size();
+            randomArr.append(*randomArr.getPtr(ind));
+            reference.push_back(reference[ind]);
+        }
+        numWrong += sameStrings(randomArr, reference) ? 0 : 1;
+        numWrong += (randomArr.isInline() != (randomArr.capacity() == 4)) ? 1 : 0;
+        numSpills += (wasInline && !randomArr.isInline()) ? 1 : 0;
+    }
+    std::cout << "Random operations: " << numWrong << " mismatches, " << numSpills << " spills" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include <HashTable.hpp>
+#include <SwissHashTable.hpp>
+
+using namespace datastructlib;
+
+/* benchmark: lookups at high load factor
+    - HashTable_Swiss vs HashTable_OpenAddressing (linear probing) vs std::unordered_map
+    - every table is sized up front so that all of them hold the same keys at the same load factor
+*/
+
+template <class Fn>
+double timeLookups(Fn fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    const unsigned int arrLength = 1 << 18;
+    const unsigned int numKeys = static_cast<unsigned int>(arrLength * 0.85);
+    const unsigned int rounds = 5;
+
+    // distinct scattered keys: multiplying by an odd constant is a bijection that keeps parity - present keys are odd, missing keys even
+    std::vector<unsigned int> keys(numKeys), missing(numKeys);
+    for (unsigned int i = 0; i < numKeys; ++i)
+    {
+        keys[i] = (2 * i + 1) * 0x9E3779B1u;
+        missing[i] = (2 * i) * 0x9E3779B1u;
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(42)); // look keys up in a different order to insertion
+
+    HashTable_Swiss<unsigned int, unsigned int> swiss(arrLength, 0.875);
+    std::unordered_map<unsigned int, unsigned int> stdMap;
+    stdMap.reserve(numKeys);
+    LinearProbeFunctor probeFunc(1, 0);
+    HashTable_OpenAddressing<unsigned int, unsigned int, MaskedHash<unsigned int>> openAddressing(arrLength, MaskedHash<unsigned int>(), &probeFunc, 0.9);
+
+    for (unsigned int i = 0; i < numKeys; ++i)
+    {
+        swiss.insert(keys[i], i);
+        stdMap[keys[i]] = i;
+        openAddressing.insert(keys[i], i);
+    }
+
+    unsigned long long swissSum = 0, stdSum = 0, oaSum = 0;
+    double swissHit = timeLookups([&]() {
+        for (unsigned int r = 0; r < rounds; ++r)
+            for (unsigned int i = 0; i < numKeys; ++i)
+                swissSum += swiss.find(keys[i]).m_kvpPtr->m_val;
+    });
+    double swissMiss = timeLookups([&]() {
+        for (unsigned int r = 0; r < rounds; ++r)
+            for (unsigned int i = 0; i < numKeys; ++i)
+                swissSum += (swiss.find(missing[i]).m_kvpPtr == nullptr);
+    });
+    double stdHit = timeLookups([&]() {
+        for (unsigned int r = 0; r < rounds; ++r)
+            for (unsigned int i = 0; i < numKeys; ++i)
+                stdSum += stdMap.find(keys[i])->second;
+    });
+    double stdMiss = timeLookups([&]() {
+        for (unsigned int r = 0; r < rounds; ++r)
+            for (unsigned int i = 0; i < numKeys; ++i)
+                stdSum += (stdMap.find(missing[i]) == stdMap.end());
+    });
+    double oaHit = timeLookups([&]() {
+        for (unsigned int r = 0; r < rounds; ++r)
+            for (unsigned int i = 0; i < numKeys; ++i)
+                oaSum += openAddressing.find(keys[i]).m_kvpPtr->m_val;
+    });
+    double oaMiss = timeLookups([&]() {
+        for (unsigned int r = 0; r < rounds; ++r)
+            for (unsigned int i = 0; i < numKeys; ++i)
+                oaSum += (openAddressing.find(missing[i]).m_kvpPtr == nullptr);
+    });
+
+    double lookups = static_cast<double>(rounds) * numKeys / 1e6;
+    std::cout << numKeys << " keys, load factor " << swiss.loadFactor() << std::endl;
+    std::cout << "table\t\t\thit (Mlookups/s)\tmiss (Mlookups/s)" << std::endl;
+    std::cout << "HashTable_Swiss\t\t" << lookups / swissHit << "\t\t\t" << lookups / swissMiss << std::endl;
+    std::cout << "HashTable_OpenAddressing\t" << lookups / oaHit << "\t\t\t" << lookups / oaMiss << std::endl;
+    std::cout << "std::unordered_map\t" << lookups / stdHit << "\t\t\t" << lookups / stdMiss << std::endl;
+    std::cout << "results " << ((swissSum == stdSum) && (stdSum == oaSum) ? "match" : "DIFFER") << std::endl;
+}